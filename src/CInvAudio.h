@@ -10,10 +10,64 @@
 #ifndef H_CInvAudio
 #define H_CInvAudio
 
-#include <xaudio2.h>
-
 #include <InvGlobals.h>
 
+#ifdef INV_NULL_AUDIO
+
+struct IXAudio2SourceVoice;
+  // Voice is never created by null audio backend, pointer type is kept for the same interface
+
+namespace Inv
+{
+  /**************************************************************************************************/
+
+  /*! \brief Sound data container of null audio backend, sound is never loaded into it. */
+  struct CInvSound
+  {
+
+    std::vector<uint8_t> data;
+    //!< Raw interleaved PCM data, always empty
+
+    IXAudio2SourceVoice * actPlaying = nullptr;
+    //!< Currently playing voice, always null
+  };
+
+  /**************************************************************************************************/
+
+  /*! \brief Null (silent) audio backend used by the headless build (INV_NULL_AUDIO defined). It has
+      the same interface as XAudio2 wrapper below, no sound is loaded and playback requests are
+      ignored. */
+  class CInvAudio
+  {
+
+  public:
+
+    CInvAudio() = default;
+    ~CInvAudio() = default;
+
+    CInvAudio( const CInvAudio & ) = delete;
+    CInvAudio & operator=( const CInvAudio & ) = delete;
+
+    bool Load( const std::string &, CInvSound & ) const { return false; }
+    //!< \brief Loads nothing, returns false
+
+    IXAudio2SourceVoice * PlayOneShot( const CInvSound &, float = 1.0f ) const { return nullptr; }
+    //!< \brief Plays nothing, returns nullptr
+
+    void PlayLoop( CInvSound &, float = 1.0f, bool = false ) const {}
+    //!< \brief Plays nothing
+
+    void Stop( CInvSound & ) const {}
+    //!< \brief Stops nothing
+
+  };
+
+} // namespace Inv
+
+#else
+
+#include <xaudio2.h>
+
 namespace Inv
 {
   /**************************************************************************************************/
@@ -160,3 +214,5 @@ namespace Inv
 } // namespace Inv
 
 #endif
+
+#endif
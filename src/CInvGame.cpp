@@ -147,7 +147,8 @@ namespace Inv
     mLoopElapsedMicrosecondsMax( 0 ),
     mLoopElapsedMicrosecondsAvg( 0.0f ),
     mLoopWaitedMicrosecondsAvg( 0.0f ),
-    mLoopElapsedMicrosecondsAvgCount( 0 )
+    mLoopElapsedMicrosecondsAvgCount( 0 ),
+    mReplay()
   {}
 
   //-------------------------------------------------------------------------------------------------
@@ -174,8 +175,32 @@ namespace Inv
     //------ Non-graphics initialization -------------------------------------------------------------
 
     auto randSeed = mSettings.GetSeed();
-    if( randSeed < 0 )
+    if( randSeed <= 0 )
       randSeed = (int32_t)time( NULL );
+                        // Zero would make the generator take the time by itself, so the seed
+                        // could not be recorded
+
+    if( !mSettings.GetPlayReplay().empty() )
+    {                   // Played back session must start from the same seed and must be played
+                        // with the same settings, otherwise it diverges from the recorded one
+      mReplay = std::make_unique<CInvReplay>();
+      if( !mReplay->Load( mSettings.GetPlayReplay() ) )
+        return false;
+
+      if( mReplay->GetSettingsHash() != mSettings.GetSettingsHash() )
+      {
+        LOG << "Replay was recorded with different settings, it cannot be played back.";
+        return false;
+      } // if
+
+      randSeed = (int32_t)mReplay->GetSeed();
+    } // if
+    else if( !mSettings.GetRecordReplay().empty() )
+    {
+      mReplay = std::make_unique<CInvReplay>();
+      mReplay->StartRecording( mSettings.GetRecordReplay(), (uint32_t)randSeed, mSettings.GetSettingsHash() );
+    } // else if
+
     CInvRandom::GetInstance().SetSeed( (uint32_t)randSeed );
 
     mHiscoreKeeper = std::make_unique<CInvHiscoreList>( mSettings.GetHiscorePath() );
@@ -359,10 +384,23 @@ namespace Inv
           stillInLoop = false;
       } // while
 
-      if( IsKeyDown( VK_ESCAPE ) )
-        stillInLoop = false;
+      if( nullptr != mReplay && mReplay->IsPlaying() )
+      {                 // Played back session ends with the last recorded tick
+        if( !mReplay->Play( controlState, controlValue ) )
+          break;
+        if( IsKeyDown( VK_ESCAPE ) )
+          stillInLoop = false;
+      } // if
+      else
+      {
+        if( IsKeyDown( VK_ESCAPE ) )
+          stillInLoop = false;
+
+        ProcessInput( controlState, controlValue );
+      } // else
 
-      ProcessInput( controlState, controlValue );
+      if( nullptr != mReplay && mReplay->IsRecording() )
+        mReplay->Record( controlState, controlValue );
 
       mPd3dDevice->Clear( 0, nullptr,
         D3DCLEAR_TARGET | D3DCLEAR_ZBUFFER | D3DCLEAR_STENCIL,
@@ -370,7 +408,7 @@ namespace Inv
                         // Clear the backbuffer to a background color
 
       if( SUCCEEDED( mPd3dDevice->BeginScene() ) )
-      {
+      {                 // EndScene() below pairs with successful BeginScene() only
 
         gameStartRequest = false;
         gameEndRequest = false;
@@ -474,8 +512,14 @@ namespace Inv
 
   bool CInvGame::Cleanup()
   {
-    mAudio->Stop( *mInsertCoinMusic );
-    mAudio->Stop( *mPlayItMusic );
+    if( nullptr != mAudio )
+    {
+      mAudio->Stop( *mInsertCoinMusic );
+      mAudio->Stop( *mPlayItMusic );
+    } // if
+
+    if( nullptr != mReplay && mReplay->IsRecording() )
+      mReplay->Save();
 
     LOG;
     LOG << "Maximal loop time: " << mLoopElapsedMicrosecondsMax << " us";
@@ -16,6 +16,7 @@
 #include <CInvSettings.h>
 #include <CInvSettingsRuntime.h>
 #include <CInvRandom.h>
+#include <CInvReplay.h>
 #include <CInvAudio.h>
 #include <CInvSoundsStorage.h>
 
@@ -57,6 +58,9 @@ namespace Inv
     bool Cleanup();
     //!< Releases resources of the game, returns true if successful
 
+    const CInvSpriteStorage & GetSpriteStorage() const { return *mSpriteStorage; }
+    //!< Returns storage of sprites loaded by Initialize()
+
   private:
 
     HRESULT InitD3D();
@@ -149,6 +153,9 @@ namespace Inv
     uint64_t mLoopElapsedMicrosecondsAvgCount;
     //<! Counter of samples taken for average time calculation
 
+    std::unique_ptr<CInvReplay> mReplay;
+    //<! Recorder or player of the session, null if neither recording nor playback is demanded
+
     static const std::wstring mWindiwClassId;
     //<! Identifier of window class
 
@@ -0,0 +1,381 @@
+//****************************************************************************************************
+//! \file CInvHeadlessGame.cpp
+//! Module defines class CInvHeadlessGame, which runs the game simulation without window, graphics
+//! and sound (headless build).
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <fstream>
+
+#include <CInvHeadlessGame.h>
+#include <CInvLogger.h>
+#include <InvStringTools.h>
+
+
+static const std::string lModLogId( "HEADLESS" );
+
+namespace Inv
+{
+  CInvHeadlessGame::CInvHeadlessGame( const CInvSettings & settings ):
+    mHiscoreKeeper( nullptr ),
+    mPrimitives( nullptr ),
+    mInsertCoinScreen( nullptr ),
+    mPlayItScreen( nullptr ),
+    mSpriteStorage( nullptr ),
+    mBackgroundInsertCoin( nullptr ),
+    mBackgroundPlay( nullptr ),
+    mAudio( nullptr ),
+    mSoundStorage( nullptr ),
+    mSettings( settings ),
+    mSettingsRuntime(),
+    mReferenceTick{},
+    mPd3dDevice( nullptr ),
+    mInputScript(),
+    mInputScriptPos( 0 ),
+    mInputScriptTicksDone( 0 ),
+    mTicksDone( 0 ),
+    mMicroseconds( 0 ),
+    mReplay()
+  {}
+
+  //-------------------------------------------------------------------------------------------------
+
+  CInvHeadlessGame::~CInvHeadlessGame()
+  {
+    mInsertCoinScreen.reset();
+    mPlayItScreen.reset();
+    mBackgroundInsertCoin.reset();
+    mBackgroundPlay.reset();
+    mSpriteStorage.reset();
+    mPrimitives.reset();
+                        // Everything holding the device goes away before the device itself
+    if( nullptr != mPd3dDevice )
+      mPd3dDevice->Release();
+  } // CInvHeadlessGame::~CInvHeadlessGame
+
+  //-------------------------------------------------------------------------------------------------
+
+  bool CInvHeadlessGame::Initialize()
+  {
+    //------ Non-graphics initialization -------------------------------------------------------------
+
+    auto randSeed = mSettings.GetSeed();
+    if( randSeed <= 0 )
+      randSeed = (int32_t)time( NULL );
+                        // Zero would make the generator take the time by itself, so the seed
+                        // could not be recorded
+
+    if( !mSettings.GetPlayReplay().empty() )
+    {                   // Played back session must start from the same seed and must be played
+                        // with the same settings, otherwise it diverges from the recorded one
+      mReplay = std::make_unique<CInvReplay>();
+      if( !mReplay->Load( mSettings.GetPlayReplay() ) )
+        return false;
+
+      if( mReplay->GetSettingsHash() != mSettings.GetSettingsHash() )
+      {
+        LOG << "Replay was recorded with different settings, it cannot be played back.";
+        return false;
+      } // if
+
+      randSeed = (int32_t)mReplay->GetSeed();
+    } // if
+    else if( !mSettings.GetRecordReplay().empty() )
+    {
+      mReplay = std::make_unique<CInvReplay>();
+      mReplay->StartRecording( mSettings.GetRecordReplay(), (uint32_t)randSeed, mSettings.GetSettingsHash() );
+    } // else if
+
+    CInvRandom::GetInstance().SetSeed( (uint32_t)randSeed );
+
+    mHiscoreKeeper = std::make_unique<CInvHiscoreList>( mSettings.GetHiscorePath() );
+
+    if( !mSettings.GetInputScript().empty() && mSettings.GetPlayReplay().empty() )
+    {                   // Played back session takes controls from the replay, recorded one from
+                        // the script
+      if( !LoadInputScript( mSettings.GetInputScript() ) )
+        return false;
+    } // if
+
+    mAudio = std::make_unique<CInvAudio>();
+    mSoundStorage = std::make_unique<CInvSoundsStorage>( mSettings, *mAudio );
+                        // No sound is loaded, playing of unknown sound is silently ignored
+
+    //------ Graphics initialization -----------------------------------------------------------------
+
+    mPd3dDevice = new IDirect3DDevice9();
+                        // Null device, textures created on it keep image pixels for collision masks
+
+    mPrimitives = std::make_unique<CInvPrimitive>( mSettings, mPd3dDevice );
+
+    mSpriteStorage = std::make_unique<CInvSpriteStorage>( mSettings, mPd3dDevice );
+
+    mBackgroundInsertCoin = std::make_unique<CInvBackground>( mSettings, mPd3dDevice );
+
+    mBackgroundPlay = std::make_unique<CInvBackground>( mSettings, mPd3dDevice );
+
+    mSpriteStorage->AddSprite( "PINK", "invaderPink" );
+    mSpriteStorage->AddSprite( "PINKEXPL", "explosionPink" );
+    mSpriteStorage->AddSprite( "SPIT", "spit" );
+    mSpriteStorage->AddSprite( "SAUCER", "saucer" );
+    mSpriteStorage->AddSprite( "SAUCEREXPL", "explosionSaucer" );
+    mSpriteStorage->AddSprite( "PACVADER", "pacvader" );
+    mSpriteStorage->AddSprite( "PACVADEREXPL", "explosionPacvader" );
+
+    mSpriteStorage->AddSprite( "FIGHT", "fighter" );
+    mSpriteStorage->AddSprite( "LIVE", "fighter" );
+    mSpriteStorage->AddSprite( "FIGHTEXPL", "explosionFighter" );
+    mSpriteStorage->AddSprite( "ROCKET", "rocket" );
+    mSpriteStorage->AddSprite( "AMMO", "rocketAmmo" );
+                        // Same sprites as in CInvGame, the scene needs them for sizes and masks
+
+    mBackgroundInsertCoin->AddBackgroundImage( "background/nebula.jpg" );
+    mBackgroundInsertCoin->SetRollCoefficient( 0.0f );
+
+    mBackgroundPlay->AddBackgroundImage( "background/staryline.jpg" );
+
+    //------ Main structures initialization ----------------------------------------------------------
+
+    mInsertCoinScreen = std::make_unique<CInvInsertCoinScreen>(
+      mSettings,
+      *mSpriteStorage,
+      *mBackgroundInsertCoin,
+      *mHiscoreKeeper,
+      *mPrimitives,
+      nullptr,
+      mPd3dDevice,
+      nullptr,
+      mReferenceTick );
+
+    mPlayItScreen = std::make_unique<CInvPlayItScreen>(
+      mSettings,
+      *mSpriteStorage,
+      *mSoundStorage,
+      *mBackgroundPlay,
+      *mPrimitives,
+      mSettingsRuntime,
+      nullptr,
+      mPd3dDevice,
+      nullptr,
+      mReferenceTick );
+                        // Direct3D interface and vertex buffer are not used by the screens
+
+    return true;
+
+  } // CInvHeadlessGame::Initialize
+
+  //-------------------------------------------------------------------------------------------------
+
+  bool CInvHeadlessGame::Run()
+  {
+    if( nullptr == mInsertCoinScreen || nullptr == mPlayItScreen )
+    {
+      LOG << "Game screens are not initialized properly.";
+      return false;
+    } // if
+
+    if( 0 == mSettings.GetHeadlessTicks() && mInputScript.empty() &&
+        ( nullptr == mReplay || !mReplay->IsPlaying() ) )
+    {
+      LOG << "Headless game needs HeadlessTicks, InputScript or PlayReplay value.";
+      return false;     // Nothing would end the simulation
+    } // if
+
+    bool stillInLoop = true;
+    uint32_t newScoreToEnter = 0;
+    bool gameStartRequest = false;
+    bool gameEndRequest = false;
+    bool gameInProgress = false;
+
+    ControlStateFlags_t controlState = 0;
+    ControlValue_t controlValue = 0;
+
+    LARGE_INTEGER StartingTime, EndingTime, ElapsedMicroseconds;
+    LARGE_INTEGER Frequency;
+    QueryPerformanceFrequency( &Frequency );
+
+    const uint64_t ticksDemanded = mSettings.GetHeadlessTicks();
+
+    mReferenceTick.QuadPart = 0;
+    mInsertCoinScreen->Reset( mReferenceTick );
+
+    while( stillInLoop )
+    {
+      if( 0 < ticksDemanded && ticksDemanded <= mTicksDone )
+        break;          // Given number of ticks is simulated
+
+      if( nullptr != mReplay && mReplay->IsPlaying() )
+      {                 // Played back session ends with the last recorded tick
+        if( !mReplay->Play( controlState, controlValue ) )
+          break;
+      } // if
+      else if( !mInputScript.empty() )
+      {                 // Scripted session ends when the script is exhausted
+        if( !ProcessScriptedInput( controlState, controlValue ) )
+          break;
+      } // else if
+
+      if( nullptr != mReplay && mReplay->IsRecording() )
+        mReplay->Record( controlState, controlValue );
+
+      QueryPerformanceCounter( &StartingTime );
+
+      gameStartRequest = false;
+      gameEndRequest = false;
+
+      if( ! gameInProgress )
+      {
+        if( !mInsertCoinScreen->MainLoop(
+          newScoreToEnter, gameStartRequest, controlState, controlValue, mReferenceTick ) )
+        {
+          LOG << "Insert coin screen loop failed, quitting";
+          stillInLoop = false;
+        } // if
+      } // if
+
+      if( gameStartRequest && ! gameInProgress )
+      {
+        LOG << "Game start requested";
+        mPlayItScreen->Reset( mReferenceTick );
+        gameInProgress = true;
+        gameStartRequest = false;
+      } // if
+
+      if( gameInProgress )
+      {
+        if( !mPlayItScreen->MainLoop(
+          newScoreToEnter, gameEndRequest, controlState, controlValue, mReferenceTick ) )
+        {
+          LOG << "Play the game screen loop failed, quitting";
+          stillInLoop = false;
+        } // if
+      } // if
+
+      if( gameEndRequest && gameInProgress )
+      {
+        LOG << "Game ended";
+        mInsertCoinScreen->Reset( mReferenceTick );
+        gameInProgress = false;
+        gameEndRequest = false;
+      } // if
+
+      QueryPerformanceCounter( &EndingTime );
+      ElapsedMicroseconds.QuadPart = EndingTime.QuadPart - StartingTime.QuadPart;
+      ElapsedMicroseconds.QuadPart *= 1000000;
+      ElapsedMicroseconds.QuadPart /= Frequency.QuadPart;
+
+      mMicroseconds += ElapsedMicroseconds.QuadPart;
+      ++mTicksDone;
+      mReferenceTick.QuadPart++;
+                        // No frame pacing, simulation runs as fast as possible
+
+    } // while
+
+    return true;
+  } // CInvHeadlessGame::Run
+
+  //-------------------------------------------------------------------------------------------------
+
+  bool CInvHeadlessGame::Cleanup()
+  {
+    if( nullptr != mReplay && mReplay->IsRecording() )
+      mReplay->Save();
+
+    LOG;
+    LOG << "Headless ticks simulated: " << mTicksDone;
+    LOG << "Headless simulation time: " << mMicroseconds << " us";
+    if( 0 < mMicroseconds )
+      LOG << "Headless throughput: "
+          << (double)mTicksDone * 1000000.0 / (double)mMicroseconds << " ticks/s";
+
+    return true;
+  } // CInvHeadlessGame::Cleanup
+
+  //-------------------------------------------------------------------------------------------------
+
+  bool CInvHeadlessGame::LoadInputScript( const std::string & path )
+  {
+    std::ifstream inFile( path, std::ifstream::in );
+    if( !inFile.is_open() )
+    {
+      LOG << "Cannot open input script '" << path << "'.";
+      return false;
+    } // if
+
+    mInputScript.clear();
+    mInputScriptPos = 0;
+    mInputScriptTicksDone = 0;
+
+    std::string inLine;
+    size_t lineNo = 0;
+    while( std::getline( inFile, inLine ) )
+    {
+      ++lineNo;
+      Trim( inLine );
+      if( inLine.empty() || StartsWith( inLine, "#" ) )
+        continue;
+
+      StrVect_t items;
+      SplitLine( items, inLine.c_str(), " \t" );
+      if( items.size() < 2 || !IsNumberChar( items[0][0] ) )
+      {
+        LOG << "Input script '" << path << "', line " << lineNo << " is malformed.";
+        return false;
+      } // if
+
+      InputStep_t step{ (uint32_t)std::stoul( items[0] ), 0, 0 };
+      for( char ch : items[1] )
+      {
+        switch( ch )
+        {
+          case 'L': step.controlState |= ControlState_t::kLeft; break;
+          case 'R': step.controlState |= ControlState_t::kRight; break;
+          case 'U': step.controlState |= ControlState_t::kUp; break;
+          case 'D': step.controlState |= ControlState_t::kDown; break;
+          case 'F': step.controlState |= ControlState_t::kFire; break;
+          case 'C': step.controlState |= ControlState_t::kSpecial; break;
+          case 'S': step.controlState |= ControlState_t::kStart; break;
+          case '-': break;
+          default:
+            LOG << "Input script '" << path << "', line " << lineNo << ": unknown control '" << ch << "'.";
+            return false;
+        } // switch
+      } // for
+
+      if( 2 < items.size() )
+        step.controlValue = (ControlValue_t)std::stoi( items[2] );
+
+      if( 0 < step.ticks )
+        mInputScript.push_back( step );
+    } // while
+
+    LOG << "Input script '" << path << "' loaded, " << mInputScript.size() << " steps.";
+    return !mInputScript.empty();
+
+  } // CInvHeadlessGame::LoadInputScript
+
+  //-------------------------------------------------------------------------------------------------
+
+  bool CInvHeadlessGame::ProcessScriptedInput( ControlStateFlags_t & controlState, ControlValue_t & controlValue )
+  {
+    if( mInputScript.size() <= mInputScriptPos )
+      return false;
+
+    const InputStep_t & step = mInputScript[mInputScriptPos];
+    controlState = step.controlState;
+    controlValue = step.controlValue;
+
+    if( step.ticks <= ++mInputScriptTicksDone )
+    {
+      ++mInputScriptPos;
+      mInputScriptTicksDone = 0;
+    } // if
+
+    return true;
+
+  } // CInvHeadlessGame::ProcessScriptedInput
+
+} // namespace Inv
@@ -0,0 +1,154 @@
+//****************************************************************************************************
+//! \file CInvHeadlessGame.h
+//! Module declares class CInvHeadlessGame, which runs the game simulation without window, graphics
+//! and sound (headless build).
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvHeadlessGame
+#define H_CInvHeadlessGame
+
+#include <graphics/InvD3D9.h>
+
+#include <InvGlobals.h>
+#include <CInvSettings.h>
+#include <CInvSettingsRuntime.h>
+#include <CInvRandom.h>
+#include <CInvReplay.h>
+#include <CInvAudio.h>
+#include <CInvSoundsStorage.h>
+
+#include <graphics/CInvSprite.h>
+#include <graphics/CInvSpriteStorage.h>
+#include <graphics/CInvText.h>
+#include <graphics/CInvPrimitive.h>
+#include <graphics/CInvBackground.h>
+
+#include <engine/CInvHiscoreList.h>
+#include <engine/CInvInsertCoinScreen.h>
+#include <engine/CInvPlayItScreen.h>
+
+namespace Inv
+{
+
+  /*! \brief Class runs the same screens, scene and processors as CInvGame, but without window and
+      without frame rate limit. It is built with null graphics and audio backends (INV_NULL_GRAPHICS,
+      INV_NULL_AUDIO), so it needs neither Direct3D nor XAudio2 and can run on machine without GPU.
+      Sprites are loaded from the same images as in the game, so collision masks are the same.
+      Controls are taken from input script or played back replay; the run ends after given number
+      of ticks or when the input is exhausted. Simulated ticks and throughput are logged. */
+  class CInvHeadlessGame
+  {
+  public:
+
+    CInvHeadlessGame( const CInvSettings & settings );
+
+    CInvHeadlessGame( const CInvHeadlessGame & ) = delete;
+    CInvHeadlessGame & operator=( const CInvHeadlessGame & ) = delete;
+    ~CInvHeadlessGame();
+
+    bool Initialize();
+    //!< Initializes game, returns true if successful
+
+    bool Run();
+    //!< Runs the simulation, returns true if successful
+
+    bool Cleanup();
+    //!< Releases resources of the game and logs statistics, returns true if successful
+
+    const CInvSpriteStorage & GetSpriteStorage() const { return *mSpriteStorage; }
+    //!< Returns storage of sprites loaded by Initialize()
+
+  private:
+
+    bool LoadInputScript( const std::string & path );
+    /*!< \brief Loads scripted input. Every non-empty line of the file (lines starting with '#' are
+         comments) contains number of ticks, controls held during these ticks (combination of
+         letters L, R, U, D, F, C, S for left, right, up, down, fire, special and start, or '-' for
+         none) and optionally the code of key pressed (used when callsign is entered), e.g.
+         "120 LF".
+
+         \param[in] path  Path to the script file
+         \return true if the script was loaded successfully */
+
+    bool ProcessScriptedInput( ControlStateFlags_t & controlState, ControlValue_t & controlValue );
+    /*!< \brief Sets control state and value for actual tick from loaded input script.
+
+         \param[out] controlState Control state demanded by the script
+         \param[out] controlValue Key code demanded by the script
+         \return false if the script is already exhausted */
+
+    using InputStep_t = struct
+    {
+      uint32_t ticks;
+      ControlStateFlags_t controlState;
+      ControlValue_t controlValue;
+    };
+    //!< \brief One step of input script - controls held for given number of ticks
+
+    std::unique_ptr<CInvHiscoreList> mHiscoreKeeper;
+    //!< \brief High score list object, used to access and modify high scores.
+
+    std::unique_ptr <CInvPrimitive> mPrimitives;
+    //!< \brief Primitive rendering object (draws nothing with null device)
+
+    std::unique_ptr<CInvInsertCoinScreen> mInsertCoinScreen;
+    //!< \brief "Insert Coin" screen object, used to manage the initial game screen.
+
+    std::unique_ptr<CInvPlayItScreen> mPlayItScreen;
+    //!< \brief "Play It" screen object, used to manage the game screen.
+
+    std::unique_ptr<CInvSpriteStorage> mSpriteStorage;
+    //!< \brief Sprite storage object, used to manage and access sprites.
+
+    std::unique_ptr<CInvBackground> mBackgroundInsertCoin;
+    //!< \brief Background of "insert coin" screen
+
+    std::unique_ptr<CInvBackground> mBackgroundPlay;
+    //!< \brief Background of the game screen
+
+    std::unique_ptr<CInvAudio> mAudio;
+    //!< \brief Null audio engine, nothing is played
+
+    std::unique_ptr<CInvSoundsStorage> mSoundStorage;
+    //!< \brief Sound storage object, stays empty
+
+    const CInvSettings & mSettings;
+    //!< \brief Reference to global settings object, used to access configuration parameters.
+
+    CInvSettingsRuntime mSettingsRuntime;
+    //!< \brief Runtime settings object, used to access and modify parameters created and updated
+    //     by game engine.
+
+    LARGE_INTEGER mReferenceTick;
+    //<! \brief Reference tick, used for timing and animations and actions.
+
+    LPDIRECT3DDEVICE9 mPd3dDevice;
+    //<! Null Direct3D device, resources are created on it, nothing is drawn
+
+    std::vector<InputStep_t> mInputScript;
+    //<! Scripted input
+
+    size_t mInputScriptPos;
+    //<! Index of actual step of input script
+
+    uint32_t mInputScriptTicksDone;
+    //<! Number of ticks already spent in actual step of input script
+
+    uint64_t mTicksDone;
+    //<! Number of ticks simulated
+
+    LONGLONG mMicroseconds;
+    //<! Total time spent by simulation, in microseconds
+
+    std::unique_ptr<CInvReplay> mReplay;
+    //<! Recorder or player of the session, null if neither recording nor playback is demanded
+
+  };
+
+} // namespace Inv
+
+#endif
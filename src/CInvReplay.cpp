@@ -0,0 +1,205 @@
+//****************************************************************************************************
+//! \file CInvReplay.cpp
+//! Module contains class CInvReplay, which records control states of played session to compact
+//! binary file and plays them back, so the same session can be simulated repeatedly.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <cstring>
+
+#include <CInvLogger.h>
+#include <CInvReplay.h>
+
+namespace Inv
+{
+
+  static const std::string lModLogId( "REPLAY" );
+
+  static const char lMagic[4] = { 'I', 'N', 'V', 'R' };
+
+  CInvReplay::CInvReplay():
+    mRuns(),
+    mFileName(),
+    mSeed( 0 ),
+    mSettingsHash( 0 ),
+    mTickCount( 0 ),
+    mPlayRun( 0 ),
+    mPlayRunTicksDone( 0 ),
+    mRecording( false ),
+    mPlaying( false )
+  {}
+
+  //-------------------------------------------------------------------------------------------------
+
+  CInvReplay::~CInvReplay() = default;
+
+  //-------------------------------------------------------------------------------------------------
+
+  void CInvReplay::StartRecording( const std::string & inFileName, uint32_t seed, uint64_t settingsHash )
+  {
+    mRuns.clear();
+    mFileName = inFileName;
+    mSeed = seed;
+    mSettingsHash = settingsHash;
+    mTickCount = 0;
+    mRecording = true;
+    mPlaying = false;
+
+    LOG << "Recording session to '" << mFileName << "', seed " << mSeed;
+
+  } // CInvReplay::StartRecording
+
+  //-------------------------------------------------------------------------------------------------
+
+  void CInvReplay::Record( ControlStateFlags_t controlState, ControlValue_t controlValue )
+  {
+    if( !mRecording )
+      return;
+
+    ++mTickCount;
+
+    if( !mRuns.empty() )
+    {
+      Run_t & last = mRuns.back();
+      if( last.controlState == controlState && last.controlValue == controlValue && last.ticks < UINT32_MAX )
+      {
+        ++last.ticks;
+        return;
+      } // if
+    } // if
+
+    mRuns.push_back( { 1, controlState, controlValue } );
+
+  } // CInvReplay::Record
+
+  //-------------------------------------------------------------------------------------------------
+
+  bool CInvReplay::Save()
+  {
+    if( !mRecording )
+      return false;
+
+    std::ofstream outFile( mFileName, std::ios::binary | std::ios::trunc );
+    if( !outFile.is_open() )
+    {
+      LOG << "Cannot open replay file '" << mFileName << "' for writing.";
+      return false;
+    } // if
+
+    outFile.write( lMagic, sizeof( lMagic ) );
+    outFile.write( reinterpret_cast<const char *>( &mFormatVersion ), sizeof( mFormatVersion ) );
+    outFile.write( reinterpret_cast<const char *>( &mSeed ), sizeof( mSeed ) );
+    outFile.write( reinterpret_cast<const char *>( &mSettingsHash ), sizeof( mSettingsHash ) );
+    outFile.write( reinterpret_cast<const char *>( &mTickCount ), sizeof( mTickCount ) );
+
+    for( const auto & run : mRuns )
+    {                   // Runs are written item by item, so no padding of Run_t gets into file
+      uint16_t state = run.controlState;
+      uint8_t value = (uint8_t)run.controlValue;
+      outFile.write( reinterpret_cast<const char *>( &run.ticks ), sizeof( run.ticks ) );
+      outFile.write( reinterpret_cast<const char *>( &state ), sizeof( state ) );
+      outFile.write( reinterpret_cast<const char *>( &value ), sizeof( value ) );
+    } // for
+
+    if( !outFile )
+    {
+      LOG << "Error writing replay file '" << mFileName << "'.";
+      return false;
+    } // if
+
+    LOG << "Session saved to '" << mFileName << "', " << mTickCount << " ticks in " << mRuns.size() << " runs.";
+    return true;
+
+  } // CInvReplay::Save
+
+  //-------------------------------------------------------------------------------------------------
+
+  bool CInvReplay::Load( const std::string & inFileName )
+  {
+    mRecording = false;
+    mPlaying = false;
+    mRuns.clear();
+    mFileName = inFileName;
+
+    std::ifstream inFile( mFileName, std::ios::binary );
+    if( !inFile.is_open() )
+    {
+      LOG << "Cannot open replay file '" << mFileName << "'.";
+      return false;
+    } // if
+
+    char magic[4] = {};
+    uint32_t version = 0;
+    inFile.read( magic, sizeof( magic ) );
+    inFile.read( reinterpret_cast<char *>( &version ), sizeof( version ) );
+    inFile.read( reinterpret_cast<char *>( &mSeed ), sizeof( mSeed ) );
+    inFile.read( reinterpret_cast<char *>( &mSettingsHash ), sizeof( mSettingsHash ) );
+    inFile.read( reinterpret_cast<char *>( &mTickCount ), sizeof( mTickCount ) );
+
+    if( !inFile || 0 != memcmp( magic, lMagic, sizeof( lMagic ) ) )
+    {
+      LOG << "File '" << mFileName << "' is not a replay file.";
+      return false;
+    } // if
+
+    if( mFormatVersion != version )
+    {
+      LOG << "Replay file '" << mFileName << "' has unsupported version " << version << ".";
+      return false;
+    } // if
+
+    uint64_t ticks = 0;
+    while( ticks < mTickCount )
+    {
+      Run_t run;
+      uint16_t state = 0;
+      uint8_t value = 0;
+      inFile.read( reinterpret_cast<char *>( &run.ticks ), sizeof( run.ticks ) );
+      inFile.read( reinterpret_cast<char *>( &state ), sizeof( state ) );
+      inFile.read( reinterpret_cast<char *>( &value ), sizeof( value ) );
+      if( !inFile || 0 == run.ticks )
+      {
+        LOG << "Replay file '" << mFileName << "' is truncated or corrupted.";
+        return false;
+      } // if
+
+      run.controlState = state;
+      run.controlValue = (ControlValue_t)value;
+      mRuns.push_back( run );
+      ticks += run.ticks;
+    } // while
+
+    mPlayRun = 0;
+    mPlayRunTicksDone = 0;
+    mPlaying = true;
+
+    LOG << "Session loaded from '" << mFileName << "', " << mTickCount << " ticks, seed " << mSeed;
+    return true;
+
+  } // CInvReplay::Load
+
+  //-------------------------------------------------------------------------------------------------
+
+  bool CInvReplay::Play( ControlStateFlags_t & controlState, ControlValue_t & controlValue )
+  {
+    if( !mPlaying || mRuns.size() <= mPlayRun )
+      return false;
+
+    const Run_t & run = mRuns[mPlayRun];
+    controlState = run.controlState;
+    controlValue = run.controlValue;
+
+    if( run.ticks <= ++mPlayRunTicksDone )
+    {
+      ++mPlayRun;
+      mPlayRunTicksDone = 0;
+    } // if
+
+    return true;
+
+  } // CInvReplay::Play
+
+} // namespace Inv
@@ -0,0 +1,125 @@
+//****************************************************************************************************
+//! \file CInvReplay.h
+//! Module contains class CInvReplay, which records control states of played session to compact
+//! binary file and plays them back, so the same session can be simulated repeatedly.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvReplay
+#define H_CInvReplay
+
+#include <InvGlobals.h>
+
+namespace Inv
+{
+  /*! \brief The class records control state and value of every game tick and plays them back.
+      As the simulation is driven by tick counter only and all random numbers come from CInvRandom,
+      session replayed with the same seed and the same settings (see CInvSettings::GetSettingsHash())
+      is the same bit by bit.
+
+      File format (little endian):
+
+          char[4]   magic "INVR"
+          uint32_t  format version
+          uint32_t  seed of random number generator
+          uint64_t  settings hash
+          uint64_t  number of recorded ticks
+          runs      { uint32_t ticks, uint16_t controlState, uint8_t controlValue } until the end
+
+      Controls are held for many ticks, so run-length encoding makes the file small (usually
+      few kB for several minutes of play). */
+  class CInvReplay
+  {
+    public:
+
+    CInvReplay();
+    CInvReplay( const CInvReplay & ) = delete;
+    CInvReplay & operator=( const CInvReplay & ) = delete;
+    ~CInvReplay();
+
+    void StartRecording( const std::string & inFileName, uint32_t seed, uint64_t settingsHash );
+    /*!< \brief Starts recording of new session. Nothing is written until Save() is called.
+
+         \param[in] inFileName    Name of the replay file
+         \param[in] seed          Seed the random number generator was initialized with
+         \param[in] settingsHash  Hash of settings the session is played with */
+
+    void Record( ControlStateFlags_t controlState, ControlValue_t controlValue );
+    /*!< \brief Records controls of one tick */
+
+    bool Save();
+    /*!< \brief Writes recorded session to file given in StartRecording(), returns true if successful */
+
+    bool Load( const std::string & inFileName );
+    /*!< \brief Loads recorded session from file and prepares it for playback, returns true if
+         successful */
+
+    bool Play( ControlStateFlags_t & controlState, ControlValue_t & controlValue );
+    /*!< \brief Returns controls of the next tick of loaded session.
+
+         \param[out] controlState Recorded control state
+         \param[out] controlValue Recorded key code
+         \return false if the whole session was already played */
+
+    bool IsRecording() const { return mRecording; }
+    /*!< \brief Returns true if session is being recorded */
+
+    bool IsPlaying() const { return mPlaying; }
+    /*!< \brief Returns true if session is being played back */
+
+    uint32_t GetSeed() const { return mSeed; }
+    /*!< \brief Returns seed of recorded or loaded session */
+
+    uint64_t GetSettingsHash() const { return mSettingsHash; }
+    /*!< \brief Returns settings hash of recorded or loaded session */
+
+    uint64_t GetTickCount() const { return mTickCount; }
+    /*!< \brief Returns number of recorded ticks */
+
+    constexpr static uint32_t mFormatVersion = 1;
+    /*!< Version of replay file format, files of other versions are refused */
+
+  private:
+
+    using Run_t = struct
+    {
+      uint32_t ticks;
+      ControlStateFlags_t controlState;
+      ControlValue_t controlValue;
+    };
+    //!< \brief Controls held without change for given number of ticks
+
+    std::vector<Run_t> mRuns;
+    /*!< \brief Recorded or loaded runs */
+
+    std::string mFileName;
+    /*!< \brief Name of the replay file */
+
+    uint32_t mSeed;
+    /*!< \brief Seed of random number generator */
+
+    uint64_t mSettingsHash;
+    /*!< \brief Hash of settings the session was played with */
+
+    uint64_t mTickCount;
+    /*!< \brief Number of recorded ticks */
+
+    size_t mPlayRun;
+    /*!< \brief Index of run being played */
+
+    uint32_t mPlayRunTicksDone;
+    /*!< \brief Number of ticks already played from actual run */
+
+    bool mRecording;
+    /*!< \brief true if session is being recorded */
+
+    bool mPlaying;
+    /*!< \brief true if session is being played back */
+  };
+
+} // namespace Inv
+
+#endif
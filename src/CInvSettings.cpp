@@ -25,6 +25,7 @@ namespace Inv
      mGameIdentifier( "Invaders"),
      mSeed( -1 ),
      mTickPerSecond( 60 ),
+     mWorkerThreads( 0 ),
      mFullScreen( true ),
      mScreenWidth( 800 ),
      mScreenHeight( 600 ),
@@ -36,9 +37,14 @@ namespace Inv
      mSpeedupPerKill( 0.05f ),
      mDifficultyBuildup( 1.1f ),
      mQuickDeathTime( 60.0f ),
+     mRaidFlowFieldCell( 0 ),
      mInitialLives( 3 ),
      mAmmo( 3 ),
-     mReloadTime( 1.0f )
+     mReloadTime( 1.0f ),
+     mHeadlessTicks( 0 ),
+     mInputScript(),
+     mRecordReplay(),
+     mPlayReplay()
    {}
 
    //-------------------------------------------------------------------------------------------------
@@ -73,6 +79,7 @@ namespace Inv
 
        mSeed = (int32_t)inCfg.GetValueInteger( {}, "Seed", -1 );
        mTickPerSecond = (uint32_t)inCfg.GetValueInteger( {}, "TickPerSecond", 60 );
+       mWorkerThreads = (uint32_t)inCfg.GetValueInteger( {}, "WorkerThreads", 0 );
 
        mFullScreen = inCfg.GetValueBool( "graphics", "FullScreen", false );
 
@@ -88,11 +95,19 @@ namespace Inv
        mSpeedupPerKill = (float)inCfg.GetValueDouble( "game", "SpeedupPerKill", 0.05f );
        mDifficultyBuildup = (float)inCfg.GetValueDouble( "game", "DifficultyBuildup", 1.1f );
        mQuickDeathTime = (float)inCfg.GetValueDouble( "game", "QuickDeathTime", 60.0f );
+       mRaidFlowFieldCell = (uint32_t)inCfg.GetValueInteger( "game", "RaidFlowFieldCell", 0 );
 
        mInitialLives = (uint32_t)inCfg.GetValueInteger( "player", "InitialLives", 3 );
        mAmmo = (uint32_t)inCfg.GetValueInteger( "player", "Ammo", 3 );
        mReloadTime = (float)inCfg.GetValueDouble( "player", "ReloadTime", 1.0f );
 
+       mHeadlessTicks = (uint32_t)inCfg.GetValueInteger( {}, "HeadlessTicks", 0 );
+       mInputScript = inCfg.GetValueStr( {}, "InputScript", "" );
+       mRecordReplay = inCfg.GetValueStr( {}, "RecordReplay", "" );
+       mPlayReplay = inCfg.GetValueStr( {}, "PlayReplay", "" );
+       if( !mRecordReplay.empty() && !mPlayReplay.empty() )
+         vErrors.emplace_back( "RecordReplay and PlayReplay cannot be used together" );
+
      }
      catch( std::exception& e )
      {
@@ -108,6 +123,41 @@ namespace Inv
 
    //-------------------------------------------------------------------------------------------------
 
+   uint64_t CInvSettings::GetSettingsHash() const
+   {
+     uint64_t hash = 14695981039346656037ull;
+     auto hashBytes = [&hash]( const void * data, size_t size )
+     {                  // FNV-1a
+       auto bytes = static_cast<const unsigned char *>( data );
+       for( size_t i = 0; i < size; ++i )
+       {
+         hash ^= bytes[i];
+         hash *= 1099511628211ull;
+       } // for
+     };
+
+     hashBytes( &mTickPerSecond, sizeof( mTickPerSecond ) );
+     hashBytes( &mScreenWidth, sizeof( mScreenWidth ) );
+     hashBytes( &mScreenHeight, sizeof( mScreenHeight ) );
+     hashBytes( &mMinScore, sizeof( mMinScore ) );
+     hashBytes( &mRaidScoreCoef, sizeof( mRaidScoreCoef ) );
+     hashBytes( &mZeroExplosionV, sizeof( mZeroExplosionV ) );
+     hashBytes( &mSpeedupPerKill, sizeof( mSpeedupPerKill ) );
+     hashBytes( &mDifficultyBuildup, sizeof( mDifficultyBuildup ) );
+     hashBytes( &mQuickDeathTime, sizeof( mQuickDeathTime ) );
+     hashBytes( &mRaidFlowFieldCell, sizeof( mRaidFlowFieldCell ) );
+     hashBytes( &mInitialLives, sizeof( mInitialLives ) );
+     hashBytes( &mAmmo, sizeof( mAmmo ) );
+     hashBytes( &mReloadTime, sizeof( mReloadTime ) );
+                        // Only values influencing the simulation are hashed; paths, fullscreen
+                        // and headless mode do not change the outcome of the game
+
+     return hash;
+
+   } // CInvSettings::GetSettingsHash
+
+   //-------------------------------------------------------------------------------------------------
+
    std::ostream & CInvSettings::PrpLine()
    {
      return LOG << std::setw(Inv::gPrintoutIdWidth) << std::left;
@@ -120,6 +170,7 @@ namespace Inv
      PrpLine() << "GameIdentifier:" << mGameIdentifier;
      PrpLine() << "Seed:" << mSeed;
      PrpLine() << "TickPerSecond:" << mTickPerSecond;
+     PrpLine() << "WorkerThreads:" << mWorkerThreads;
      LOG;
 
      PrpLine() << "FullScreen:" << ( mFullScreen ? gTrueName : gFalseName );
@@ -135,6 +186,7 @@ namespace Inv
      PrpLine() << "SpeedupPerKill:" << mSpeedupPerKill;
      PrpLine() << "DifficultyBuildup:" << mDifficultyBuildup;
      PrpLine() << "QuickDeathTime:" << mQuickDeathTime;
+     PrpLine() << "RaidFlowFieldCell:" << mRaidFlowFieldCell;
      LOG;
 
      PrpLine() << "InitialLives:" << mInitialLives;
@@ -142,6 +194,21 @@ namespace Inv
      PrpLine() << "ReloadTime:" << mReloadTime;
      LOG;
 
+     if( 0 < mHeadlessTicks || !mInputScript.empty() )
+     {
+       PrpLine() << "HeadlessTicks:" << mHeadlessTicks;
+       PrpLine() << "InputScript:" << mInputScript;
+       LOG;
+     } // if
+
+     if( !mRecordReplay.empty() || !mPlayReplay.empty() )
+     {
+       PrpLine() << "RecordReplay:" << mRecordReplay;
+       PrpLine() << "PlayReplay:" << mPlayReplay;
+       PrpLine() << "SettingsHash:" << std::hex << GetSettingsHash() << std::dec;
+       LOG;
+     } // if
+
    } // CInvSettings::Preprint
 
 } // namespace Inv
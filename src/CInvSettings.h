@@ -64,6 +64,10 @@ namespace Inv
     uint32_t GetTickPerSecond() const { return mTickPerSecond; }
     //!< \brief Returns number of ticks per second (updates of game logic and rendering)
 
+    uint32_t GetWorkerThreads() const { return mWorkerThreads; }
+    //!< \brief Returns number of worker threads running independent processors concurrently, 0 means
+    //!  all processors run on main thread
+
     bool GetFullScreen() const { return mFullScreen; }
     //!< \brief Returns true if the game should run in fullscreen mode
 
@@ -97,6 +101,10 @@ namespace Inv
     float GetQuickDeathTime() const { return mQuickDeathTime; }
     //!< \brief Returns time (in seconds) for sudden death mode
 
+    uint32_t GetRaidFlowFieldCell() const { return mRaidFlowFieldCell; }
+    //!< \brief Returns size of cell (in pixels) of vector field guiding raiding aliens, 0 means every
+    //!  alien steers by its own vector to the target
+
     uint32_t GetInitialLives() const { return mInitialLives; }
     //!< \brief Returns number of player lives (ships) at the beginning of the game
 
@@ -106,6 +114,22 @@ namespace Inv
     float GetReloadTime() const { return mReloadTime; }
     //!< \brief Returns time (in seconds) to reload one rocket
 
+    uint32_t GetHeadlessTicks() const { return mHeadlessTicks; }
+    //!< \brief Returns number of ticks simulated in headless mode, 0 means until input script ends
+
+    const std::string & GetInputScript() const { return mInputScript; }
+    //!< \brief Returns path to file with scripted input used in headless mode
+
+    const std::string & GetRecordReplay() const { return mRecordReplay; }
+    //!< \brief Returns path to replay file the played session is recorded to (empty if none)
+
+    const std::string & GetPlayReplay() const { return mPlayReplay; }
+    //!< \brief Returns path to replay file the session is replayed from (empty if none)
+
+    uint64_t GetSettingsHash() const;
+    /*!< \brief Returns hash of all settings which influence the simulation (seed excluded, it is
+         stored in replay separately). Replay can be played only with settings of the same hash. */
+
   protected:
 
     //@}----------------------------------------------------------------------------------------------
@@ -120,6 +144,9 @@ namespace Inv
     uint32_t mTickPerSecond;
                         //!< Number of ticks per second (updates of game logic and rendering)
 
+    uint32_t mWorkerThreads;
+                        //!< Number of worker threads running independent processors concurrently
+
     bool mFullScreen;   //!< If true, game runs in fullscreen mode
 
     uint32_t mScreenWidth;
@@ -151,6 +178,9 @@ namespace Inv
     float mQuickDeathTime;
     //!< Time (in seconds) for sudden death mode
 
+    uint32_t mRaidFlowFieldCell;
+    //!< Size of cell (in pixels) of vector field guiding raiding aliens, 0 = field is not used
+
     uint32_t mInitialLives;
     //!< \brief Number of player lives (ships) at the beginning of the game
 
@@ -160,6 +190,18 @@ namespace Inv
     float mReloadTime;
     //!< \brief Time (in seconds) to reload one rocket
 
+    uint32_t mHeadlessTicks;
+    //!< \brief Number of ticks simulated in headless mode, 0 means until input script ends
+
+    std::string mInputScript;
+    //!< \brief Path to file with scripted input used in headless mode
+
+    std::string mRecordReplay;
+    //!< \brief Path to replay file the played session is recorded to
+
+    std::string mPlayReplay;
+    //!< \brief Path to replay file the session is replayed from
+
 
 
     std::ostream & PrpLine();
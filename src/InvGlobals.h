@@ -20,7 +20,7 @@
 #include <set>
 #include <map>
 
-#include <windows.h>
+#include <InvPlatform.h>
 
 namespace Inv
 {
@@ -85,7 +85,7 @@ namespace Inv
   constexpr unsigned gHelpMarginWidth = 5;
   //!< Standard left margin for commandline help printout
 
-  constexpr unsigned gHelpItemWidth = 20;
+  constexpr unsigned gHelpItemWidth = 28;
   //!< Standard width for commandline help items
 
   constexpr double_t gPI = 3.141592653589793;
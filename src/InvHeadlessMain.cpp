@@ -0,0 +1,150 @@
+//****************************************************************************************************
+//! \file InvHeadlessMain.cpp
+//! Module contains main entrypoint for the headless build (simulation without window, graphics
+//! and sound).
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <iomanip>
+#include <filesystem>
+#include <iostream>
+
+#include <InvGlobals.h>
+#include <CInvLogger.h>
+#include <CInvConfig.h>
+#include <CInvSettings.h>
+#include <CInvHeadlessGame.h>
+#include <engine/InvMotionKernels.h>
+#include <graphics/CInvCollisionTest.h>
+
+static const std::string lModLogId( "MAIN" );
+
+//******* Command line help **************************************************************************
+
+std::ostream & HlpLine()
+{
+  static const std::string hMargin( Inv::gHelpMarginWidth, ' ' );
+  return std::cout << hMargin << std::setw( Inv::gHelpItemWidth ) << std::left;
+} // HlpLine
+
+void PrintCommandlineHelp()
+{
+
+  std::cout << std::endl << std::endl;
+  std::cout << "Command line expected values: " << std::endl << std::endl;
+
+  HlpLine() << "--help" << "Print this help" << std::endl;
+  HlpLine() << "--setup <File name>" << "Path to INI file containing setup, default invaders.ini" << std::endl;
+  HlpLine() << "--HeadlessTicks <N>" << "Number of ticks simulated, 0 means until input ends" << std::endl;
+  HlpLine() << "--InputScript <File name>" << "Input script driving the simulation" << std::endl;
+  HlpLine() << "--RecordReplay <File name>" << "Records simulated session to replay file" << std::endl;
+  HlpLine() << "--PlayReplay <File name>" << "Plays back session recorded in replay file" << std::endl;
+  HlpLine() << "--BenchMotion" << "Measures motion and steering kernels on 1k, 10k and 100k entities and quits" << std::endl;
+  HlpLine() << "--BenchMaskOverlap" << "Measures mask overlap kernels on invader, rocket and spit frames and quits" << std::endl;
+  HlpLine() << "--CheckSwept" << "Checks swept collision test of rocket and invader at several tick rates and quits" << std::endl;
+
+  std::cout << std::endl << std::endl;
+
+} // PrintCommandlineHelp
+
+//******* Main function ******************************************************************************
+
+int main( int argc, char * argv[] )
+{
+  //------ Open log file --------------------------------------------------------------------------------
+
+  auto & log = Inv::CInvLoggger::GetInstance();
+  if( !log.IsOpen() )
+  {
+    std::cerr << "Cannot open log file 'invaders.log', quitting." << std::endl;
+    return -1;
+  } // if
+
+  //------ Import command line arguments -------------------------------------------------------------
+
+  Inv::CInvConfig cfg;
+  cfg.ParseCommandLine( argc, argv );
+
+  if( cfg.GetValueBool( {}, "help" ) || cfg.GetValueBool( {}, "h" ) )
+  {
+    PrintCommandlineHelp();
+    return 0;
+  } // if
+
+  if( cfg.GetValueBool( {}, "BenchMotion" ) )
+  {
+    Inv::BenchmarkIntegrateCullKernels();
+    Inv::BenchmarkSteerClampKernels();
+    return 0;           // Results are written to the log
+  } // if
+
+  //------ Import settings from configuration file ---------------------------------------------------
+
+  auto inFileName = cfg.GetValueStr( {}, "setup", "invaders.ini" );
+  if( !std::filesystem::exists( inFileName ) )
+  {
+    LOG << "Setup file '" << inFileName << "' does not exist.";
+    return -1;
+  } // if
+
+  std::ifstream inFile;
+  inFile.open( inFileName, std::ifstream::in );
+  if( !inFile.is_open() )
+  {
+    LOG << "Cannot open setup file '" << inFileName << "'.";
+    return -1;
+  } // if
+
+  size_t lastLineRead = 0;
+  if( !cfg.ParseINIFile( inFile, lastLineRead ) )
+  {
+    LOG << "Error reading setup file '" << inFileName << "', problem on line " << lastLineRead;
+    return -1;
+  } // if
+
+  inFile.close();
+
+  Inv::CInvSettings gameSettings;
+  gameSettings.ImportSettings( cfg );
+  gameSettings.Preprint();
+
+  //------ Run the simulation ---------------------------------------------------------------------------
+
+  Inv::CInvHeadlessGame game( gameSettings );
+
+  if( !game.Initialize() )
+  {
+    LOG << "Headless game initialization failed, quitting.";
+    return -1;
+  } // if
+
+  if( cfg.GetValueBool( {}, "BenchMaskOverlap" ) )
+  {
+    Inv::CInvCollisionTest::BenchmarkMaskOverlap( game.GetSpriteStorage() );
+    return 0;           // Results are written to the log, sprites are loaded by Initialize()
+  } // if
+
+  if( cfg.GetValueBool( {}, "CheckSwept" ) )
+  {
+    Inv::CInvCollisionTest collisionTest( gameSettings, nullptr );
+    return collisionTest.CheckSweptAtTickRates( game.GetSpriteStorage() ) ? 0 : -1;
+  } // if
+
+  if( !game.Run() )
+  {
+    LOG << "Headless game run failed, quitting.";
+    return -1;
+  } // if
+
+  if( !game.Cleanup() )
+  {
+    LOG << "Headless game cleanup failed.";
+    return -1;
+  } // if
+
+  return 0;
+
+} // main
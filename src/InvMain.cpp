@@ -15,6 +15,8 @@
 #include <CInvConfig.h>
 #include <CInvSettings.h>
 #include <CInvGame.h>
+#include <engine/InvMotionKernels.h>
+#include <graphics/CInvCollisionTest.h>
 
 static const std::string lModLogId( "MAIN" );
 
@@ -34,6 +36,11 @@ void PrintCommandlineHelp()
 
   HlpLine() << "--help" << "Print this help" << std::endl;
   HlpLine() << "--setup <File name>" << "Path to INI file containing setup, default invaders.ini" << std::endl;
+  HlpLine() << "--RecordReplay <File name>" << "Records played session to replay file" << std::endl;
+  HlpLine() << "--PlayReplay <File name>" << "Plays back session recorded in replay file" << std::endl;
+  HlpLine() << "--BenchMotion" << "Measures motion and steering kernels on 1k, 10k and 100k entities and quits" << std::endl;
+  HlpLine() << "--BenchMaskOverlap" << "Measures mask overlap kernels on invader, rocket and spit frames and quits" << std::endl;
+  HlpLine() << "--CheckSwept" << "Checks swept collision test of rocket and invader at several tick rates and quits" << std::endl;
 
   std::cout << std::endl << std::endl;
   std::cout << "INI file expected values: " << std::endl << std::endl;
@@ -66,6 +73,13 @@ INT WINAPI WinMain( HINSTANCE hInst, HINSTANCE, LPSTR cmd, INT )
     return 0;
   } // if
 
+  if( cfg.GetValueBool( {}, "BenchMotion" ) )
+  {
+    Inv::BenchmarkIntegrateCullKernels();
+    Inv::BenchmarkSteerClampKernels();
+    return 0;           // Results are written to the log
+  } // if
+
   //------ Import settings from configuration file ---------------------------------------------------
 
   auto inFileName = cfg.GetValueStr( {}, "setup", "invaders.ini" );
@@ -113,6 +127,18 @@ INT WINAPI WinMain( HINSTANCE hInst, HINSTANCE, LPSTR cmd, INT )
     return -1;
   } // if
 
+  if( cfg.GetValueBool( {}, "BenchMaskOverlap" ) )
+  {
+    Inv::CInvCollisionTest::BenchmarkMaskOverlap( game.GetSpriteStorage() );
+    return 0;           // Results are written to the log, sprites are loaded by Initialize()
+  } // if
+
+  if( cfg.GetValueBool( {}, "CheckSwept" ) )
+  {
+    Inv::CInvCollisionTest collisionTest( gameSettings, nullptr );
+    return collisionTest.CheckSweptAtTickRates( game.GetSpriteStorage() ) ? 0 : -1;
+  } // if
+
   if( !game.Run() )
   {
     LOG << "Game run failed, quitting.";
@@ -0,0 +1,158 @@
+//****************************************************************************************************
+//! \file InvPlatform.h
+//! Module provides the small subset of Win32 API the simulation uses, so that it can be built
+//! without windows.h (headless build on other platforms).
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_InvPlatform
+#define H_InvPlatform
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+#define INV_X86
+  //!< Defined on x86 targets, where SSE2 and AVX2 kernels are compiled in
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define INV_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#else
+#define INV_TARGET_AVX2
+#endif
+  //!< Marks function using AVX2 intrinsics. MSVC allows them in any function, GCC and clang must
+  //!  be told explicitly
+#endif
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+#else
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+//------ Basic types ---------------------------------------------------------------------------------
+
+typedef uint8_t  BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef int32_t  LONG;
+typedef int64_t  LONGLONG;
+typedef unsigned long ULONG;
+typedef uint32_t UINT;
+typedef int32_t  BOOL;
+typedef float    FLOAT;
+typedef int32_t  HRESULT;
+typedef void *   HWND;
+
+#ifndef TRUE
+#define TRUE  1
+#define FALSE 0
+#endif
+
+#define S_OK                  ( (HRESULT)0 )
+#define E_FAIL                ( (HRESULT)0x80004005 )
+#define SUCCEEDED( hr )       ( (HRESULT)( hr ) >= 0 )
+#define FAILED( hr )          ( (HRESULT)( hr ) < 0 )
+
+#define ZeroMemory( dst, len ) memset( ( dst ), 0, ( len ) )
+
+#define VK_BACK               0x08
+#define VK_RETURN             0x0D
+#define VK_ESCAPE             0x1B
+#define VK_SPACE              0x20
+#define VK_LEFT               0x25
+#define VK_UP                 0x26
+#define VK_RIGHT              0x27
+#define VK_DOWN               0x28
+  // Virtual key codes the game reacts to, values are the same as in Win32
+
+//! \brief 64-bit integer accessible also by halves, as Win32 LARGE_INTEGER
+union LARGE_INTEGER
+{
+  struct
+  {
+    DWORD LowPart;
+    LONG HighPart;
+  } u;
+  LONGLONG QuadPart;
+};
+
+//! \brief Rectangle given by its edges, right and bottom edges are exclusive, as Win32 RECT
+struct RECT
+{
+  LONG left;
+  LONG top;
+  LONG right;
+  LONG bottom;
+};
+
+//------ Functions -----------------------------------------------------------------------------------
+
+template<typename T1, typename T2>
+constexpr std::common_type_t<T1, T2> min( T1 a, T2 b ) { return ( b < a ) ? b : a; }
+  //!< Replaces min macro of windows.h, which the code uses for mixed integer types as well
+
+template<typename T1, typename T2>
+constexpr std::common_type_t<T1, T2> max( T1 a, T2 b ) { return ( a < b ) ? b : a; }
+  //!< Replaces max macro of windows.h, which the code uses for mixed integer types as well
+
+inline BOOL IntersectRect( RECT * dst, const RECT * src1, const RECT * src2 )
+{
+  dst->left = max( src1->left, src2->left );
+  dst->top = max( src1->top, src2->top );
+  dst->right = min( src1->right, src2->right );
+  dst->bottom = min( src1->bottom, src2->bottom );
+  if( dst->left < dst->right && dst->top < dst->bottom )
+    return TRUE;
+
+  *dst = RECT{ 0, 0, 0, 0 };
+  return FALSE;         // Win32 returns empty rectangle when there is no intersection
+} // IntersectRect
+
+inline BOOL OffsetRect( RECT * rect, int dx, int dy )
+{
+  rect->left += dx;
+  rect->right += dx;
+  rect->top += dy;
+  rect->bottom += dy;
+  return TRUE;
+} // OffsetRect
+
+inline BOOL QueryPerformanceCounter( LARGE_INTEGER * counter )
+{
+  counter->QuadPart = (LONGLONG)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch() ).count();
+  return TRUE;
+} // QueryPerformanceCounter
+
+inline BOOL QueryPerformanceFrequency( LARGE_INTEGER * frequency )
+{
+  frequency->QuadPart = 1000000000;
+  return TRUE;          // Counter above runs in nanoseconds
+} // QueryPerformanceFrequency
+
+inline void Sleep( DWORD milliseconds )
+{
+  std::this_thread::sleep_for( std::chrono::milliseconds( milliseconds ) );
+} // Sleep
+
+inline int mbstowcs_s( size_t * converted, wchar_t * dst, size_t dstSize, const char * src, size_t count )
+{
+  size_t len = mbstowcs( dst, src, min( dstSize, count + 1 ) );
+  if( (size_t)-1 == len )
+    return -1;
+  if( nullptr != converted )
+    *converted = len + 1;
+  return 0;             // Win32 counts terminating zero as well
+} // mbstowcs_s
+
+#endif
+
+#endif
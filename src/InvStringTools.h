@@ -10,6 +10,8 @@
 #ifndef H_InvStringTools
 #define H_InvStringTools
 
+#include <climits>
+
 #include <InvGlobals.h>
 
 namespace Inv
@@ -169,8 +171,14 @@ namespace Inv
   inline double_t format_argument_typecast( double_t value ) noexcept { return value; }
   inline bool format_argument_typecast( bool value ) noexcept { return value; }
 
+#if LONG_MAX == LLONG_MAX
+  inline long long format_argument_typecast( long long value ) noexcept { return value; }
+  inline unsigned long long format_argument_typecast( unsigned long long value ) noexcept { return value; }
+                        // 64-bit long is already int64_t, long long is the type left over
+#else
   inline long format_argument_typecast( long value ) noexcept { return value; }
   inline unsigned long format_argument_typecast( unsigned long value ) noexcept { return value; }
+#endif
 
   inline const char * format_argument_typecast( const char * value ) noexcept { return value; }
   inline const wchar_t * format_argument_typecast( const wchar_t * value ) noexcept { return value; }
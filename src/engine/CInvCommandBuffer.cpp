@@ -0,0 +1,68 @@
+//****************************************************************************************************
+//! \file CInvCommandBuffer.cpp
+//! Module defines class CInvCommandBuffer, which records structural changes of EnTT registry
+//! (creation of entities, emplacing of components, destruction) to be applied later at once.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <engine/CInvCommandBuffer.h>
+
+namespace Inv
+{
+  CInvCommandBuffer::CInvCommandBuffer():
+    mCreatedCount( 0 ),
+    mBatches(),
+    mCreatedHooks(),
+    mPooled(),
+    mDestroyed(),
+    mCreated()
+  {}
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvCommandBuffer::~CInvCommandBuffer() = default;
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvCommandBuffer::Apply( entt::registry & reg )
+  {
+    if( IsEmpty() )
+      return;
+
+    std::erase_if( mDestroyed, [&]( entt::entity entity ) { return !reg.valid( entity ); } );
+                        // Entity may have been destroyed already by someone else
+    reg.destroy( mDestroyed.begin(), mDestroyed.end() );
+    mDestroyed.clear();
+
+    mCreated.resize( mCreatedCount );
+    if( mPooled.empty() )
+      reg.create( mCreated.begin(), mCreated.end() );
+    else
+    {                   // Pooled entities are taken from their pools, in order of handles
+      size_t pooled = 0;
+      for( Handle_t handle = 0; handle < mCreatedCount; ++handle )
+      {
+        if( pooled < mPooled.size() && mPooled[pooled].first == handle )
+          mCreated[handle] = mPooled[pooled++].second->Acquire( reg );
+        else
+          mCreated[handle] = reg.create();
+      } // for
+      mPooled.clear();
+    } // else
+
+    for( auto & batch : mBatches )
+      batch.second->Apply( reg, mCreated );
+                        // Components of one type are inserted at once, in order of creation
+
+    for( auto & hook : mCreatedHooks )
+      hook.second( reg, mCreated[hook.first] );
+
+    mCreatedHooks.clear();
+    mCreatedCount = 0;
+
+  } // CInvCommandBuffer::Apply
+
+} // namespace Inv
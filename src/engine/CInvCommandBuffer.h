@@ -0,0 +1,177 @@
+//****************************************************************************************************
+//! \file CInvCommandBuffer.h
+//! Module declares class CInvCommandBuffer, which records structural changes of EnTT registry
+//! (creation of entities, emplacing of components, destruction) to be applied later at once.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvCommandBuffer
+#define H_CInvCommandBuffer
+
+#include <entity/registry.hpp>
+
+#include <InvGlobals.h>
+#include <engine/CInvEntityPool.h>
+
+namespace Inv
+{
+
+  /*! \brief Class records structural changes of the registry instead of doing them immediately, so
+      they can be requested from inside of iteration over a view or from processor running
+      concurrently with others (see CInvProcessorScheduler). Recorded changes are applied by Apply()
+      at a sync point, where no other thread accesses the registry.
+
+      Entities created by the buffer are identified by handles (index of creation) until the buffer
+      is applied. Components emplaced to them are kept in one batch per component type, the batch
+      is inserted into its storage in one call, so components created in the same tick lie next to
+      each other. Every buffer must be used by single thread at a time; processors running
+      concurrently have buffers of their own, applied in fixed order, so the result does not depend
+      on thread timing.
+
+      Buffer keeps capacity of its vectors between ticks, so recording does not allocate once the
+      game runs for a while. */
+  class CInvCommandBuffer
+  {
+  public:
+
+    using Handle_t = uint32_t;
+    //!< Handle of entity created by the buffer, valid until the buffer is applied
+
+    using FnCreated_t = void( * )( entt::registry &, entt::entity );
+    //!< Function called when the entity is created and all its components are emplaced. Plain
+    //!  function (or lambda without captures), so recording it never allocates.
+
+    static constexpr Handle_t mInvalidHandle = UINT32_MAX;
+    //!< Handle not representing any entity
+
+    CInvCommandBuffer();
+
+    CInvCommandBuffer( const CInvCommandBuffer & ) = delete;
+    CInvCommandBuffer & operator=( const CInvCommandBuffer & ) = delete;
+    ~CInvCommandBuffer();
+
+    Handle_t Create() { return mCreatedCount++; }
+    /*!< \brief Records creation of new entity and returns its handle */
+
+    Handle_t CreatePooled( CInvEntityPool & pool )
+    {
+      mPooled.push_back( { mCreatedCount, &pool } );
+      return mCreatedCount++;
+    } // CreatePooled
+    /*!< \brief Records creation of entity taken from given pool and returns its handle. Components
+         the pooled entity already has are replaced by recorded ones, the others are emplaced. Pool
+         is accessed only when the buffer is applied. */
+
+    template<typename Component, typename... Args>
+    void Emplace( Handle_t handle, Args &&... args )
+    {
+      auto & batch = GetBatch<Component>();
+      batch.handles.push_back( handle );
+      batch.values.push_back( Component{ std::forward<Args>( args )... } );
+    } // Emplace
+    /*!< \brief Records emplacing of component to entity created by the buffer.
+
+         \tparam    Component  Type of component
+         \param[in] handle     Handle of entity returned by Create()
+         \param[in] args       Values of members of the component */
+
+    void OnCreated( Handle_t handle, FnCreated_t fn ) { mCreatedHooks.push_back( { handle, fn } ); }
+    /*!< \brief Records function called when the entity is created and all components of all recorded
+         entities are emplaced (in order of recording). Used for actions needing real identifier
+         of the entity, as binding of callbacks or update of collision layers. */
+
+    void Destroy( entt::entity entity ) { mDestroyed.push_back( entity ); }
+    /*!< \brief Records destruction of existing entity, every entity may be recorded only once.
+         Entity no longer valid when the buffer is applied is skipped. */
+
+    void Apply( entt::registry & reg );
+    /*!< \brief Applies all recorded changes and clears the buffer. Entities are destroyed first,
+         then all entities are created at once, components are inserted batch by batch and finally
+         hooks are called. */
+
+    bool IsEmpty() const { return 0 == mCreatedCount && mDestroyed.empty(); }
+    /*!< \brief Returns true if there is nothing to apply */
+
+  private:
+
+    struct BatchBase_t
+    {
+      virtual ~BatchBase_t() = default;
+      virtual void Apply( entt::registry & reg, const std::vector<entt::entity> & created ) = 0;
+    };
+    //!< \brief Batch of components of one type, type erased
+
+    template<typename Component>
+    struct Batch_t: public BatchBase_t
+    {
+      std::vector<Handle_t> handles;
+      std::vector<Component> values;
+      std::vector<entt::entity> entities;
+
+      void Apply( entt::registry & reg, const std::vector<entt::entity> & created ) override
+      {
+        if( values.empty() )
+          return;
+
+        auto & storage = reg.storage<Component>();
+        bool isFresh = true;
+        entities.clear();
+        for( auto handle : handles )
+        {
+          entities.push_back( created[handle] );
+          isFresh = isFresh && !storage.contains( entities.back() );
+        } // for
+
+        if( isFresh )
+          reg.insert<Component>( entities.begin(), entities.end(), values.begin() );
+        else            // Entities reused from pools may have the component already
+          for( size_t index = 0; index < entities.size(); ++index )
+            reg.emplace_or_replace<Component>( entities[index], std::move( values[index] ) );
+
+        handles.clear();
+        values.clear();
+      } // Apply
+    };
+    //!< \brief Components of one type recorded for entities given by handles
+
+    template<typename Component>
+    Batch_t<Component> & GetBatch()
+    {
+      auto typeId = entt::type_hash<Component>::value();
+      for( auto & batch : mBatches )
+      {
+        if( batch.first == typeId )
+          return static_cast<Batch_t<Component> &>( *batch.second );
+      } // for
+
+      mBatches.push_back( { typeId, std::make_unique<Batch_t<Component>>() } );
+      return static_cast<Batch_t<Component> &>( *mBatches.back().second );
+    } // GetBatch
+    //!< \brief Returns batch of given component type, it is created on first use
+
+    Handle_t mCreatedCount;
+    //!< Number of entities recorded for creation
+
+    std::vector<std::pair<entt::id_type, std::unique_ptr<BatchBase_t>>> mBatches;
+    //!< Batches of components in order of first use, with hash of their type
+
+    std::vector<std::pair<Handle_t, FnCreated_t>> mCreatedHooks;
+    //!< Functions to be called for created entities
+
+    std::vector<std::pair<Handle_t, CInvEntityPool *>> mPooled;
+    //!< Entities to be taken from pools instead of created, in order of handles
+
+    std::vector<entt::entity> mDestroyed;
+    //!< Entities recorded for destruction
+
+    std::vector<entt::entity> mCreated;
+    //!< Entities created by last Apply(), indexed by handle, working variable
+
+  }; // class CInvCommandBuffer
+
+} // namespace Inv
+
+#endif
@@ -11,13 +11,12 @@
 
 #include <engine/CInvEntityFactory.h>
 #include <engine/InvENTTComponents.h>
+#include <engine/InvENTTCollisionLayers.h>
 #include <engine/CInvGameScene.h>
 
+#include <engine/InvENTTEffects.h>
+
 #include <graphics/CInvSprite.h>
-#include <graphics/CInvEffectSpriteAnimation.h>
-#include <graphics/CInvEffectSpriteBlink.h>
-#include <graphics/CInvEffectSpriteShrink.h>
-#include <graphics/CInvEffectSpriteMirror.h>
 
 namespace Inv
 {
@@ -25,6 +24,28 @@ namespace Inv
 
   //-------------------------------------------------------------------------------------------------
 
+  static float lAspectRatio( const CInvSprite & sprite )
+  {
+    auto baseSize = sprite.GetImageSize( 0 );
+    return (float)baseSize.second / (float)baseSize.first;
+  } // lAspectRatio
+
+  //-------------------------------------------------------------------------------------------------
+
+  static void lRespawnPooled( entt::registry & reg, entt::entity entity )
+  {
+    auto [ gph, anim ] = reg.get<cpGraphics, cpFxAnimation>( entity );
+    gph.diffTick.QuadPart = 0;
+    gph.isHidden = false;
+    RestoreEffect( anim.standard );
+                        // Animation of reused entity starts from the beginning
+
+    UpdateCollisionLayers( reg, entity );
+                        // components: collision layer and mask (according to initial state)
+  } // lRespawnPooled
+
+  //-------------------------------------------------------------------------------------------------
+
   CInvEntityFactory::CInvEntityFactory(
     const CInvSettings & settings,
     const CInvSpriteStorage & spriteStorage,
@@ -58,13 +79,13 @@ namespace Inv
     float vXGroup, float vYGroup,
     float alienSizeX )
   {
-    std::shared_ptr<CInvSprite> entitySprite = mSpriteStorage.GetSprite( entityType );
-    if( nullptr == entitySprite )
+    CInvSprite entitySprite = mSpriteStorage.GetSpriteInstance( entityType );
+    if( !entitySprite.IsValid() )
     {
       LOG << "Error: Sprite with ID '" << entityType << "' does not exist, cannot create entity.";
       return {};
     } // if
-    entitySprite->SetLevel( LVL_ALIEN );
+    entitySprite.SetLevel( LVL_ALIEN );
 
     const auto invader = mEnTTRegistry.create();
 
@@ -77,7 +98,7 @@ namespace Inv
     mEnTTRegistry.emplace<cpVelocity>( invader, vXGroup, vYGroup, 0.0f);
                         // component: velocity
 
-    auto baseSize = entitySprite->GetImageSize( 0 );
+    auto baseSize = entitySprite.GetImageSize( 0 );
     auto aspectRatio = (float)baseSize.second / (float)baseSize.first;
     mEnTTRegistry.emplace<cpGeometry>( invader, alienSizeX, alienSizeX * aspectRatio );
                         // component: geometry
@@ -100,11 +121,15 @@ namespace Inv
       false,            // isDying
       false,            // isInRaid
       false,            // isReturningToFormation
-      0u,               // raidTicksLeft
-      posX,             // formationX
-      posY              // formationY
+      false,            // isRaidStarting
+      false,            // isRaidTimeOver
+      gNoTimer,         // raidTimer
+      0u                // scheduleStamp
     );
 
+    mEnTTRegistry.emplace<cpInFormation>( invader );
+                        // component: alien stays in formation, moves with it
+
     mEnTTRegistry.emplace<cpHealth>( invader, 1u, 1u );
                         // component: health points (single hit will do)
 
@@ -118,46 +143,25 @@ namespace Inv
 /* specify different animation points of interest and so on.                          */
 /**//**//**//**//**//**//**//**//**//**//**//**//**//**//**//**//**//**//**//**//**//**/
 
-    auto standardAnimationEffect = std::make_shared<CInvEffectSpriteAnimation>(
-      mSettings, mPd3dDevice, 1u );
-    standardAnimationEffect->SetPace( 6 );
-    standardAnimationEffect->SetImageRange( 16u, 23u );
-    standardAnimationEffect->SetContinuous( false );
-    standardAnimationEffect->Suspend();
-    standardAnimationEffect->AddEventCallback(
-      BIND_MEMBER_EVENT_CALLBACK_ON( &mGameScene, CInvGameScene::CallbackAlienAnimationDone, invader )  );
-    entitySprite->AddEffect( standardAnimationEffect );
-                        // Standard animation effect starts suspended, it will be
-                        // activated on random event.
-
-    auto firingAnimationEffect = std::make_shared<CInvEffectSpriteAnimation>(
-      mSettings, mPd3dDevice, 1u );
-    firingAnimationEffect->SetPace( 6 );
-    firingAnimationEffect->SetImageRange( 0u, 23u );
-    firingAnimationEffect->SetContinuous( false );
-    firingAnimationEffect->Suspend();
-    firingAnimationEffect->AddEventCallback(
-      BIND_MEMBER_EVENT_CALLBACK_ON( &mGameScene, CInvGameScene::CallbackAlienFiringDone, invader ) );
-    firingAnimationEffect->AddEventCallback(
-      8u, BIND_MEMBER_EVENT_CALLBACK_ON( &mGameScene, CInvGameScene::CallbackAlienShootRequested, invader ) );
-    entitySprite->AddEffect( firingAnimationEffect );
-                        // Firing animation effect starts suspended, it will be
-                        // activated on random event.
-
-    auto shrinkAnimationEffect = std::make_shared<CInvEffectSpriteShrink>( mSettings, mPd3dDevice, 11u );
-    shrinkAnimationEffect->SetPace( 6 );
-    shrinkAnimationEffect->SetContinuous( false );
-    shrinkAnimationEffect->Suspend();
-    shrinkAnimationEffect->AddEventCallback(
-      BIND_MEMBER_EVENT_CALLBACK_ON( &mGameScene, CInvGameScene::CallbackUnsetActive, invader ) );
-    entitySprite->AddEffect( shrinkAnimationEffect );
-                        // Shrink animation effect starts suspended (dying effect, not needed for now), it will
-                        //  be activated on external event.
-
-    mEnTTRegistry.emplace<cpGraphics>( invader,
-      entitySprite, 0u, standardAnimationEffect, firingAnimationEffect, shrinkAnimationEffect, LARGE_INTEGER{0}, false );
-                        // component: graphics (sprite, static image index, standard animation
-                        // sequence, firing animation sequence, animation driver is zeroed )
+    mEnTTRegistry.emplace<cpFxAnimation>( invader,
+      FxAnimationTrack_t{ 6u, 16u, 23u, true, false, false, false, UINT32_MAX,
+        nullptr, BIND_MEMBER_EVENT_CALLBACK( &mGameScene, CInvGameScene::CallbackAlienAnimationDone ) },
+      FxAnimationTrack_t{ 6u, 0u, 23u, true, false, false, false, 8u,
+        BIND_MEMBER_EVENT_CALLBACK( &mGameScene, CInvGameScene::CallbackAlienShootRequested ),
+        BIND_MEMBER_EVENT_CALLBACK( &mGameScene, CInvGameScene::CallbackAlienFiringDone ) } );
+                        // component: animation (standard and firing sequence, both start suspended, they
+                        // will be activated on random event)
+
+    mEnTTRegistry.emplace<cpFxShrink>( invader, 6u, 0.0f, 6u, true, false,
+      BIND_MEMBER_EVENT_CALLBACK( &mGameScene, CInvGameScene::CallbackUnsetActive ) );
+                        // component: shrink effect (dying effect starts suspended, it will be activated
+                        // on external event)
+
+    mEnTTRegistry.emplace<cpGraphics>( invader, std::move( entitySprite ), 0u, LARGE_INTEGER{0}, false );
+                        // component: graphics (sprite, static image index, animation driver is zeroed )
+
+    UpdateCollisionLayers( mEnTTRegistry, invader );
+                        // components: collision layer and mask (according to initial state)
 
     return invader;
 
@@ -170,13 +174,13 @@ namespace Inv
     bool fromLeft, float posY,
     float vX, float vY, float alienSizeX )
   {
-    std::shared_ptr<CInvSprite> entitySprite = mSpriteStorage.GetSprite( bossType.mSpriteId );
-    if( nullptr == entitySprite )
+    CInvSprite entitySprite = mSpriteStorage.GetSpriteInstance( bossType.mSpriteId );
+    if( !entitySprite.IsValid() )
     {
       LOG << "Error: Sprite with ID '" << bossType.mSpriteId << "' does not exist, cannot create entity.";
       return {};
     } // if
-    entitySprite->SetLevel( LVL_ALIEN );
+    entitySprite.SetLevel( LVL_ALIEN );
 
     const auto boss = mEnTTRegistry.create();
 
@@ -197,7 +201,7 @@ namespace Inv
     mEnTTRegistry.emplace<cpVelocity>( boss, vX * div, vY * div, 0.0f );
                         // component: velocity
 
-    auto baseSize = entitySprite->GetImageSize( 0 );
+    auto baseSize = entitySprite.GetImageSize( 0 );
     auto aspectRatio = (float)baseSize.second / (float)baseSize.first;
     mEnTTRegistry.emplace<cpGeometry>( boss, alienSizeX, alienSizeX * aspectRatio );
                         // component: geometry
@@ -220,37 +224,29 @@ namespace Inv
                         // not dying/removed on hit)
 
     auto nrOfTicksToFullCycle = (float)mSettings.GetTickPerSecond() * bossType.mAnimationLength;
-    auto ticksPerImage = (uint32_t)( nrOfTicksToFullCycle / (float)entitySprite->GetNumberOfImages() );
-
-    auto standardAnimationEffect = std::make_shared<CInvEffectSpriteAnimation>(
-      mSettings, mPd3dDevice, 1u );
-    standardAnimationEffect->SetPace( ticksPerImage );
-    standardAnimationEffect->SetContinuous( true );
-    entitySprite->AddEffect( standardAnimationEffect );
-                        // Standard animation effect starts running in case of the bos and is continuous
-
-    auto shrinkAnimationEffect = std::make_shared<CInvEffectSpriteShrink>( mSettings, mPd3dDevice, 11u );
-    shrinkAnimationEffect->SetPace( 6 );
-    shrinkAnimationEffect->SetContinuous( false );
-    shrinkAnimationEffect->Suspend();
-    shrinkAnimationEffect->AddEventCallback(
-      BIND_MEMBER_EVENT_CALLBACK_ON( &mGameScene, CInvGameScene::CallbackUnsetActive, boss ) );
-    entitySprite->AddEffect( shrinkAnimationEffect );
-                        // Shrink animation effect starts suspended (dying effect, not needed for now),
-                        // it will be activated on external event.
+    auto ticksPerImage = (uint32_t)( nrOfTicksToFullCycle / (float)entitySprite.GetNumberOfImages() );
+
+    mEnTTRegistry.emplace<cpFxAnimation>( boss,
+      FxAnimationTrack_t{ max( ticksPerImage, 1u ), 0u, UINT32_MAX, false, true, false, false, UINT32_MAX, nullptr, nullptr },
+      FxAnimationTrack_t{ 1u, 0u, UINT32_MAX, true, false, false, false, UINT32_MAX, nullptr, nullptr } );
+                        // component: animation (standard animation starts running in case of the boss
+                        // and is continuous, boss has no specific sequence)
+
+    mEnTTRegistry.emplace<cpFxShrink>( boss, 6u, 0.0f, 6u, true, false,
+      BIND_MEMBER_EVENT_CALLBACK( &mGameScene, CInvGameScene::CallbackUnsetActive ) );
+                        // component: shrink effect (dying effect starts suspended, it will be activated
+                        // on external event)
 
     if( !fromLeft && bossType.mMirrorIfFromRight )
-    {
-      auto mirrorEffect = std::make_shared<CInvEffectSpriteMirror>( mSettings, mPd3dDevice, 50u );
-      entitySprite->AddEffect( mirrorEffect );
-                         // Mirroring effect is applied immediately if the boss enters
-                         // from right side (if necessary)
-    } // if
+      mEnTTRegistry.emplace<cpFxMirror>( boss );
+                        // component: mirroring effect is applied immediately if the boss enters
+                        // from right side (if necessary)
 
-    mEnTTRegistry.emplace<cpGraphics>( boss,
-      entitySprite, 0u, standardAnimationEffect, nullptr, shrinkAnimationEffect, LARGE_INTEGER{ 0 }, false );
-                        // component: graphics (sprite, static image index, standard animation
-                        // sequence, firing animation sequence, animation driver is zeroed )
+    mEnTTRegistry.emplace<cpGraphics>( boss, std::move( entitySprite ), 0u, LARGE_INTEGER{ 0 }, false );
+                        // component: graphics (sprite, static image index, animation driver is zeroed )
+
+    UpdateCollisionLayers( mEnTTRegistry, boss );
+                        // components: collision layer and mask (according to initial state)
 
     return boss;
 
@@ -263,17 +259,17 @@ namespace Inv
     float posX, float posY,
     float playerSizeX )
   {
-    std::shared_ptr<CInvSprite> entitySprite = mSpriteStorage.GetSprite( entityType );
-    if( nullptr == entitySprite )
+    CInvSprite entitySprite = mSpriteStorage.GetSpriteInstance( entityType );
+    if( !entitySprite.IsValid() )
     {
       LOG << "Error: Sprite with ID '" << entityType << "' does not exist, cannot create entity.";
       return {};
     } // if
-    entitySprite->SetLevel( LVL_PLAYER );
+    entitySprite.SetLevel( LVL_PLAYER );
 
 
 #ifdef _DEBUG
-    entitySprite->SetDebugId( DEBUG_ID_FIGHTER );
+    entitySprite.SetDebugId( DEBUG_ID_FIGHTER );
 #endif
 
     const auto fighter = mEnTTRegistry.create();
@@ -287,7 +283,7 @@ namespace Inv
     mEnTTRegistry.emplace<cpVelocity>( fighter, 0.0f, 0.0f, 0.0f );
                         // component: velocity
 
-    auto baseSize = entitySprite->GetImageSize( 0 );
+    auto baseSize = entitySprite.GetImageSize( 0 );
     auto aspectRatio = (float)baseSize.second / (float)baseSize.first;
     mEnTTRegistry.emplace<cpGeometry>( fighter, playerSizeX, playerSizeX * aspectRatio );
                         // component: geometry
@@ -301,33 +297,21 @@ namespace Inv
     mEnTTRegistry.emplace<cpHealth>( fighter, 1u, 1u );
                         // component: health points (single hit will do)
 
-    auto blinkAnimationEffect = std::make_shared<CInvEffectSpriteBlink>( mSettings, mPd3dDevice, 1u );
-    blinkAnimationEffect->SetPace( 6 );
-    blinkAnimationEffect->SetTicks( mSettingsRuntime.mPlayerInvulnerabilityTicks );
-    blinkAnimationEffect->SetContinuous( false );
-    blinkAnimationEffect->AddEventCallback(
-      BIND_MEMBER_EVENT_CALLBACK_ON( &mGameScene, CInvGameScene::CallbackPlayerInvulnerabilityCanceled, fighter ) );
-    entitySprite->AddEffect( blinkAnimationEffect );
-                        // Blinking animation effect starts running, as player is invulnerable on spawn.
-
-   auto shrinkAnimationEffect = std::make_shared<CInvEffectSpriteShrink>( mSettings, mPd3dDevice, 11u );
-   shrinkAnimationEffect->SetPace( 6 );
-   shrinkAnimationEffect->SetContinuous( false );
-   shrinkAnimationEffect->Suspend();
-   shrinkAnimationEffect->AddEventCallback(
-     BIND_MEMBER_EVENT_CALLBACK_ON( &mGameScene, CInvGameScene::CallbackUnsetActive, fighter ) );
-   entitySprite->AddEffect( shrinkAnimationEffect );
-                        // Shrink animation effect starts suspended (dying effect, not needed for now), it will
-                        //  be activated on external event.
+    auto invulnerabilityTicks = mSettingsRuntime.mPlayerInvulnerabilityTicks;
+    mEnTTRegistry.emplace<cpFxBlink>( fighter, 6u, invulnerabilityTicks, invulnerabilityTicks, false, false,
+      BIND_MEMBER_EVENT_CALLBACK( &mGameScene, CInvGameScene::CallbackPlayerInvulnerabilityCanceled ) );
+                        // component: blinking effect starts running, as player is invulnerable on spawn
 
-#ifdef _DEBUG
-   shrinkAnimationEffect->SetDebugId( DEBUG_ID_FIGHTER );
-#endif
+    mEnTTRegistry.emplace<cpFxShrink>( fighter, 6u, 0.0f, 6u, true, false,
+      BIND_MEMBER_EVENT_CALLBACK( &mGameScene, CInvGameScene::CallbackUnsetActive ) );
+                        // component: shrink effect (dying effect starts suspended, it will be activated
+                        // on external event)
 
-    mEnTTRegistry.emplace<cpGraphics>( fighter,
-      entitySprite, 0u, blinkAnimationEffect, nullptr, shrinkAnimationEffect, LARGE_INTEGER{ 0 }, false );
-                        // component: graphics (sprite, invulnerability and dying effects are stored, animation
-                        // driver is zeroed )
+    mEnTTRegistry.emplace<cpGraphics>( fighter, std::move( entitySprite ), 0u, LARGE_INTEGER{ 0 }, false );
+                        // component: graphics (sprite, static image index, animation driver is zeroed )
+
+    UpdateCollisionLayers( mEnTTRegistry, fighter );
+                        // components: collision layer and mask (according to initial state)
 
     return fighter;
 
@@ -335,7 +319,8 @@ namespace Inv
 
   //-------------------------------------------------------------------------------------------------
 
-  entt::entity CInvEntityFactory::AddMissileEntity(
+  CInvCommandBuffer::Handle_t CInvEntityFactory::AddMissileEntity(
+    CInvCommandBuffer & commands,
     const std::string & entityType,
     bool fromPlayer,
     float posX, float posY,
@@ -343,50 +328,54 @@ namespace Inv
     float directionX,
     float directionY )
   {
+    auto findPool = mPools.find( entityType );
+    bool isPooled = ( findPool != mPools.end() );
+                        // Pooled missile reuses sprite and effects of parked entity, nothing is
+                        // allocated
 
-    std::shared_ptr<CInvSprite> entitySprite = mSpriteStorage.GetSprite( entityType );
-    if( nullptr == entitySprite )
-    {
-      LOG << "Error: Sprite with ID '" << entityType << "' does not exist, cannot create entity.";
-      return {};
-    } // if
-    entitySprite->SetLevel( LVL_MISSILE );
+    cpGraphics gph{};
+    cpFxAnimation anim{};
+    if( !isPooled && !BuildMissileGraphics( entityType, gph, anim ) )
+      return CInvCommandBuffer::mInvalidHandle;
 
-    const auto missile = mEnTTRegistry.create();
+    const auto missile = isPooled ? commands.CreatePooled( *findPool->second.pool ) : commands.Create();
 
-
-    mEnTTRegistry.emplace<cpId>( missile, 3u, entityType, true, false );
+    commands.Emplace<cpId>( missile, 3u, entityType, true, false );
                         // component: entity full identifier
 
-    mEnTTRegistry.emplace<cpPosition>( missile, posX, posY, 0.0f );
+    commands.Emplace<cpPosition>( missile, posX, posY, 0.0f );
                         // component: position
 
     float vDiv = std::sqrt( directionX * directionX + directionY * directionY );
     vDiv = ( IsZero( vDiv ) ? 1.0f : 1.0f / vDiv );
     float vSize = ( fromPlayer ? mSettingsRuntime.mRocketVelocity : mSettingsRuntime.mSpitVelocity );
     vSize /= (float)mSettings.GetTickPerSecond();
-    mEnTTRegistry.emplace<cpVelocity>( missile, directionX * vSize * vDiv, directionY * vSize * vDiv, 0.0f );
+    commands.Emplace<cpVelocity>( missile, directionX * vSize * vDiv, directionY * vSize * vDiv, 0.0f );
                         // component: velocity
 
-    auto baseSize = entitySprite->GetImageSize( 0 );
-    auto aspectRatio = (float)baseSize.second / (float)baseSize.first;
-    mEnTTRegistry.emplace<cpGeometry>( missile, missileSizeX, missileSizeX * aspectRatio );
+    auto aspectRatio = isPooled ? findPool->second.aspectRatio : lAspectRatio( gph.standardSprite );
+    commands.Emplace<cpGeometry>( missile, missileSizeX, missileSizeX * aspectRatio );
                         // component: geometry
 
-    mEnTTRegistry.emplace<cpDamage>( missile, 1u, !fromPlayer, fromPlayer, true );
+    commands.Emplace<cpDamage>( missile, 1u, !fromPlayer, fromPlayer, true );
                         // component: entity damage
 
-    auto standardAnimationEffect = std::make_shared<CInvEffectSpriteAnimation>(
-      mSettings, mPd3dDevice, 1u );
-    standardAnimationEffect->SetPace( 6 );
-    standardAnimationEffect->SetContinuous( true );
-    entitySprite->AddEffect( standardAnimationEffect );
-                        // Missile is animated continuously and have no event bound to animation
+    if( isPooled )
+    {
+      commands.OnCreated( missile, lRespawnPooled );
+      return missile;   // Graphics of pooled entity is kept, only its animation is restarted
+    } // if
+
+    commands.Emplace<cpFxAnimation>( missile, std::move( anim ) );
+                        // component: animation (continuous standard sequence)
 
-    mEnTTRegistry.emplace<cpGraphics>( missile,
-      entitySprite, 0u, standardAnimationEffect,  nullptr, nullptr, LARGE_INTEGER{ 0 }, false );
-                        // component: graphics (sprite, static image index, standard animation
-                        // sequence, no firing animation sequence, animation driver is zeroed )
+    commands.Emplace<cpGraphics>( missile, std::move( gph ) );
+                        // component: graphics (sprite, static image index, animation driver is zeroed )
+
+    commands.OnCreated( missile, []( entt::registry & reg, entt::entity entity )
+    {
+      UpdateCollisionLayers( reg, entity );
+    } );                // components: collision layer and mask (according to initial state)
 
     return missile;
 
@@ -394,66 +383,154 @@ namespace Inv
 
   //-------------------------------------------------------------------------------------------------
 
-  entt::entity CInvEntityFactory::AddExplosionEntity(
+  CInvCommandBuffer::Handle_t CInvEntityFactory::AddExplosionEntity(
+    CInvCommandBuffer & commands,
     const std::string & entityType,
     float posX, float posY,
     float explosionSizeX,
     float velocityX, float velocityY )
   {
-    std::shared_ptr<CInvSprite> entitySprite = mSpriteStorage.GetSprite( entityType );
-    if( nullptr == entitySprite )
-    {
-      LOG << "Error: Sprite with ID '" << entityType << "' does not exist, cannot create entity.";
-      return {};
-    } // if
-    entitySprite->SetLevel( LVL_EXPLOSION );
+    auto findPool = mPools.find( entityType );
+    bool isPooled = ( findPool != mPools.end() );
 
-#ifdef _DEBUG
-    entitySprite->SetDebugId( DEBUG_ID_FIGHTER_EXPLODE );
-#endif
+    cpGraphics gph{};
+    cpFxAnimation anim{};
+    if( !isPooled && !BuildExplosionGraphics( entityType, gph, anim ) )
+      return CInvCommandBuffer::mInvalidHandle;
 
-    const auto explosion = mEnTTRegistry.create();
+    const auto explosion = isPooled ? commands.CreatePooled( *findPool->second.pool ) : commands.Create();
 
-    auto & explosionId = mEnTTRegistry.emplace<cpId>( explosion, 4u, entityType, true, false );
+    commands.Emplace<cpId>( explosion, 4u, entityType, true, false );
                         // component: entity full identifier
 
-    mEnTTRegistry.emplace<cpPosition>( explosion, posX, posY, 0.0f );
+    commands.Emplace<cpPosition>( explosion, posX, posY, 0.0f );
                         // component: position
 
-    mEnTTRegistry.emplace<cpVelocity>( explosion, velocityX, velocityY, 0.0f );
+    commands.Emplace<cpVelocity>( explosion, velocityX, velocityY, 0.0f );
                         // component: velocity
 
-    auto baseSize = entitySprite->GetImageSize( 0 );
-    auto aspectRatio = (float)baseSize.second / (float)baseSize.first;
-    mEnTTRegistry.emplace<cpGeometry>( explosion, explosionSizeX, explosionSizeX * aspectRatio );
+    auto aspectRatio = isPooled ? findPool->second.aspectRatio : lAspectRatio( gph.standardSprite );
+    commands.Emplace<cpGeometry>( explosion, explosionSizeX, explosionSizeX * aspectRatio );
                         // component: geometry
 
-    auto explosionTicks = (uint32_t)( mExplosionTime * (float)mSettings.GetTickPerSecond() );
-    auto explosionPace = (uint32_t)( explosionTicks / entitySprite->GetNumberOfImages() );
-    if( 0u == explosionPace )
-      explosionPace = 1u;
+    if( isPooled )
+    {
+      commands.OnCreated( explosion, lRespawnPooled );
+      return explosion; // Graphics of pooled entity is kept, only its animation is restarted
+    } // if
+
+    commands.Emplace<cpFxAnimation>( explosion, std::move( anim ) );
+                        // component: animation (explosion is animated once, after animation is finished,
+                        // it is removed from game)
+
+    commands.Emplace<cpGraphics>( explosion, std::move( gph ) );
+                        // component: graphics (sprite, static image index, animation driver is zeroed )
+
+    return explosion;
+
+  } // CInvEntityFactory::AddExplosionEntity
+
+  //-------------------------------------------------------------------------------------------------
+
+  void CInvEntityFactory::PrepareMissilePool( const std::string & entityType, size_t count )
+  {
+    cpGraphics gph{};
+    cpFxAnimation anim{};
+    if( !BuildMissileGraphics( entityType, gph, anim ) )
+      return;
+
+    auto & entry = mPools[entityType];
+    entry.aspectRatio = lAspectRatio( gph.standardSprite );
+    entry.pool = std::make_unique<CInvEntityPool>( [gph, anim]( entt::registry & reg, entt::entity entity )
+    {
+      reg.emplace<cpFxAnimation>( entity, anim );
+      reg.emplace<cpGraphics>( entity, gph );
+    } );                // Every pooled entity gets a copy of the components built once
+    entry.pool->Prewarm( mEnTTRegistry, count );
 
-    auto standardAnimationEffect = std::make_shared<CInvEffectSpriteAnimation>(
-      mSettings, mPd3dDevice, 1u );
-    standardAnimationEffect->SetPace( explosionPace );
-    standardAnimationEffect->SetContinuous( false );
-    standardAnimationEffect->AddEventCallback(
-      BIND_MEMBER_EVENT_CALLBACK_ON( &mGameScene, CInvGameScene::CallbackUnsetActive, explosion ) );
-    entitySprite->AddEffect( standardAnimationEffect );
-                        // Explosion is animated once. After animation is finished, it is removed from game.
+  } // CInvEntityFactory::PrepareMissilePool
+
+  //-------------------------------------------------------------------------------------------------
+
+  void CInvEntityFactory::PrepareExplosionPool( const std::string & entityType, size_t count )
+  {
+    cpGraphics gph{};
+    cpFxAnimation anim{};
+    if( !BuildExplosionGraphics( entityType, gph, anim ) )
+      return;
+
+    auto & entry = mPools[entityType];
+    entry.aspectRatio = lAspectRatio( gph.standardSprite );
+    entry.pool = std::make_unique<CInvEntityPool>( [gph, anim]( entt::registry & reg, entt::entity entity )
+    {
+      reg.emplace<cpFxAnimation>( entity, anim );
+      reg.emplace<cpGraphics>( entity, gph );
+    } );                // Every pooled entity gets a copy of the components built once
+    entry.pool->Prewarm( mEnTTRegistry, count );
+
+  } // CInvEntityFactory::PrepareExplosionPool
+
+  //-------------------------------------------------------------------------------------------------
+
+  void CInvEntityFactory::ClearPools()
+  {
+    mPools.clear();
+  } // CInvEntityFactory::ClearPools
+
+  //-------------------------------------------------------------------------------------------------
+
+  bool CInvEntityFactory::BuildMissileGraphics(
+    const std::string & entityType, cpGraphics & gph, cpFxAnimation & anim ) const
+  {
+    CInvSprite entitySprite = mSpriteStorage.GetSpriteInstance( entityType );
+    if( !entitySprite.IsValid() )
+    {
+      LOG << "Error: Sprite with ID '" << entityType << "' does not exist, cannot create entity.";
+      return false;
+    } // if
+    entitySprite.SetLevel( LVL_MISSILE );
+
+    anim = cpFxAnimation{
+      FxAnimationTrack_t{ 6u, 0u, UINT32_MAX, false, true, false, false, UINT32_MAX, nullptr, nullptr },
+      FxAnimationTrack_t{ 1u, 0u, UINT32_MAX, true, false, false, false, UINT32_MAX, nullptr, nullptr } };
+                        // Missile is animated continuously and have no event bound to animation
+
+    gph = cpGraphics{ std::move( entitySprite ), 0u, LARGE_INTEGER{ 0 }, false };
+    return true;
+
+  } // CInvEntityFactory::BuildMissileGraphics
+
+  //-------------------------------------------------------------------------------------------------
+
+  bool CInvEntityFactory::BuildExplosionGraphics(
+    const std::string & entityType, cpGraphics & gph, cpFxAnimation & anim ) const
+  {
+    CInvSprite entitySprite = mSpriteStorage.GetSpriteInstance( entityType );
+    if( !entitySprite.IsValid() )
+    {
+      LOG << "Error: Sprite with ID '" << entityType << "' does not exist, cannot create entity.";
+      return false;
+    } // if
+    entitySprite.SetLevel( LVL_EXPLOSION );
 
 #ifdef _DEBUG
-    standardAnimationEffect->SetDebugId( DEBUG_ID_FIGHTER_EXPLODE );
+    entitySprite.SetDebugId( DEBUG_ID_FIGHTER_EXPLODE );
 #endif
 
-    mEnTTRegistry.emplace<cpGraphics>( explosion,
-      entitySprite, 0u, standardAnimationEffect, nullptr, nullptr, LARGE_INTEGER{ 0 }, false );
-                        // component: graphics (sprite, static image index, standard animation
-                        // sequence, no firing animation sequence, animation driver is zeroed )
+    auto explosionTicks = (uint32_t)( mExplosionTime * (float)mSettings.GetTickPerSecond() );
+    auto explosionPace = (uint32_t)( explosionTicks / entitySprite.GetNumberOfImages() );
+    if( 0u == explosionPace )
+      explosionPace = 1u;
 
-    return explosion;
+    anim = cpFxAnimation{
+      FxAnimationTrack_t{ explosionPace, 0u, UINT32_MAX, false, false, false, false, UINT32_MAX,
+        nullptr, BIND_MEMBER_EVENT_CALLBACK( &mGameScene, CInvGameScene::CallbackUnsetActive ) },
+      FxAnimationTrack_t{ 1u, 0u, UINT32_MAX, true, false, false, false, UINT32_MAX, nullptr, nullptr } };
+                        // Explosion is animated once, after animation is finished, it is removed from game
 
-  } // CInvEntityFactory::AddExplosionEntity
+    gph = cpGraphics{ std::move( entitySprite ), 0u, LARGE_INTEGER{ 0 }, false };
+    return true;
 
+  } // CInvEntityFactory::BuildExplosionGraphics
 
 } // namespace Inv
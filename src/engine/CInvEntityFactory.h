@@ -16,6 +16,9 @@
 #include <CInvSettingsRuntime.h>
 
 #include <graphics/CInvSpriteStorage.h>
+#include <engine/CInvCommandBuffer.h>
+#include <engine/CInvEntityPool.h>
+#include <engine/InvENTTComponents.h>
 
 #define DEBUG_ID_FIGHTER  50
 #define DEBUG_ID_FIGHTER_EXPLODE 100
@@ -26,7 +29,7 @@ namespace Inv
   class CInvGameScene;
 
   /*! \brief Descriptor structure for alien boss entity types. */
-  using AlienBossDescriptor_t = struct
+  struct AlienBossDescriptor_t
   {
     uint32_t mBossTypeId;
     //!< \brief Unique ID of this alien entity type
@@ -131,15 +134,20 @@ namespace Inv
          \param[in] playerSizeX  Width of the player entity [px], height will be calculated according
                                  to sprite aspect ratio. */
 
-    entt::entity AddMissileEntity(
+    CInvCommandBuffer::Handle_t AddMissileEntity(
+      CInvCommandBuffer & commands,
       const std::string & entityType,
       bool fromPlayer,
       float posX, float posY,
       float missileSizeX,
       float directionX = 0.0f, float directionY = 1.0f );
-    /*!< \brief Adds a new missile entity of given type at given position. Missile velocity is specified
-         in runtime config, its direction can be affected by directionX and directionY parameters.
+    /*!< \brief Records creation of a new missile entity of given type at given position into command
+         buffer, the missile appears in the registry when the buffer is applied. Missile velocity is
+         specified in runtime config, its direction can be affected by directionX and directionY
+         parameters. Registry is not accessed, so the method may be called during iteration or
+         from concurrently running processor.
 
+         \param[in] commands       Command buffer the creation is recorded into
          \param[in] entityType     Type of missile entity to be created, must correspond to a
                                    sprite ID in sprite storage.
          \param[in] fromPlayer     \b true if the missile is fired by player, \b false if by alien.
@@ -148,18 +156,22 @@ namespace Inv
          \param[in] missileSizeX   Width of the missile entity [px], height will be calculated
                                    according to sprite aspect ratio.
          \param[in] directionX     X component of direction vector, does not need to be normalized.
-         \param[in] directionY     Y component of direction vector, does not need to be normalized. */
+         \param[in] directionY     Y component of direction vector, does not need to be normalized.
+         \return Handle of the entity in command buffer, mInvalidHandle if the sprite does not exist */
 
     constexpr static float mExplosionTime = 0.75f;
     //!< \brief Standard time for explosion animation, in seconds
 
-    entt::entity AddExplosionEntity(
+    CInvCommandBuffer::Handle_t AddExplosionEntity(
+      CInvCommandBuffer & commands,
       const std::string & entityType,
       float posX, float posY,
       float explosionSizeX,
       float velocityX = 0.0f, float velocityY = 0.0f );
-    /*!< \brief Adds a new explosion entity of given type at given position.
+    /*!< \brief Records creation of a new explosion entity of given type at given position into
+         command buffer, the explosion appears in the registry when the buffer is applied.
 
+         \param[in] commands        Command buffer the creation is recorded into
          \param[in] entityType      Type of explosion entity to be created, must correspond to a
                                     sprite ID in sprite storage.
          \param[in] posX            X position of the explosion entity (of centre of object) [px]
@@ -167,10 +179,56 @@ namespace Inv
          \param[in] explosionSizeX  Width of the explosion entity [px], height will be calculated
                                     according to sprite aspect ratio.
          \param[in] velocityX       X translation velocity (of centre of object) [px/tick]
-         \param[in] velocityY       Y translation velocity (of centre of object) [px/tick] */
+         \param[in] velocityY       Y translation velocity (of centre of object) [px/tick]
+         \return Handle of the entity in command buffer, mInvalidHandle if the sprite does not exist */
+
+    constexpr static size_t mMissilePoolSize = 32;
+    //!< \brief Number of alien missiles built in advance, when level starts
+
+    constexpr static size_t mExplosionPoolSize = 16;
+    //!< \brief Number of alien explosions built in advance, when level starts
+
+    void PrepareMissilePool( const std::string & entityType, size_t count );
+    /*!< \brief Creates pool of missile entities of given type and builds given number of them in
+         advance. AddMissileEntity() then reuses entities of the pool instead of creating new ones.
+         Must not be called while processors run, pools are looked up concurrently.
+
+         \param[in] entityType  Type of missile entity, must correspond to a sprite ID
+         \param[in] count       Number of entities built in advance */
+
+    void PrepareExplosionPool( const std::string & entityType, size_t count );
+    /*!< \brief Creates pool of explosion entities of given type, see PrepareMissilePool(). */
+
+    void ClearPools();
+    /*!< \brief Removes all pools, must be called when the registry is cleared. */
 
   private:
 
+    bool BuildMissileGraphics(
+      const std::string & entityType, cpGraphics & gph, cpFxAnimation & anim ) const;
+    /*!< \brief Fills graphics and animation components of missile (instance of sprite, continuous
+         animation).
+         \return False if the sprite does not exist */
+
+    bool BuildExplosionGraphics(
+      const std::string & entityType, cpGraphics & gph, cpFxAnimation & anim ) const;
+    /*!< \brief Fills graphics and animation components of explosion (instance of sprite, single
+         run animation pruning the explosion when finished).
+         \return False if the sprite does not exist */
+
+    struct Pool_t
+    {
+      std::unique_ptr<CInvEntityPool> pool;
+      //!< Pool of entities of one type
+
+      float aspectRatio;
+      //!< Aspect ratio (height / width) of the sprite of the type
+    };
+    //!< \brief Pool of entities together with properties of the type needed when it is spawned
+
+    std::map<std::string, Pool_t> mPools;
+    //!< \brief Pools of missiles and explosions by type of entity
+
     const CInvSettings & mSettings;
     //!< \brief Reference to global settings object, used to access configuration parameters.
 
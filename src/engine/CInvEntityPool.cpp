@@ -0,0 +1,88 @@
+//****************************************************************************************************
+//! \file CInvEntityPool.cpp
+//! Module defines class CInvEntityPool, which keeps pruned entities of one type for reuse.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <engine/CInvEntityPool.h>
+#include <engine/InvENTTComponents.h>
+
+
+namespace Inv
+{
+  CInvEntityPool::CInvEntityPool( FnBuild_t build ):
+    mBuild( std::move( build ) ),
+    mParked(),
+    mBuiltCount( 0 )
+  {}
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvEntityPool::~CInvEntityPool() = default;
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvEntityPool::Prewarm( entt::registry & reg, size_t count )
+  {
+    for( size_t i = 0; i < count; ++i )
+      Park( reg, Build( reg ) );
+  } // CInvEntityPool::Prewarm
+
+  //----------------------------------------------------------------------------------------------
+
+  entt::entity CInvEntityPool::Acquire( entt::registry & reg )
+  {
+    if( mParked.empty() )
+      return Build( reg );
+
+    entt::entity entity = mParked.back();
+    mParked.pop_back();
+    reg.remove<cpParked>( entity );
+    return entity;
+
+  } // CInvEntityPool::Acquire
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvEntityPool::Park( entt::registry & reg, entt::entity entity )
+  {
+    if( reg.all_of<cpParked>( entity ) )
+      return;           // Entity parked twice would be acquired twice
+
+    reg.remove<cpPosition, cpCollisionLayer, cpCollisionMask, cpCollisionMotion, cpPendingDestroy>( entity );
+    reg.emplace_or_replace<cpParked>( entity );
+                        // Storages keep their capacity, so neither removing nor emplacing allocates
+                        // once the pool is warm
+    mParked.push_back( entity );
+
+  } // CInvEntityPool::Park
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvEntityPool::Clear()
+  {
+    mParked.clear();
+    mBuiltCount = 0;
+  } // CInvEntityPool::Clear
+
+  //----------------------------------------------------------------------------------------------
+
+  entt::entity CInvEntityPool::Build( entt::registry & reg )
+  {
+    entt::entity entity = reg.create();
+    reg.emplace<cpPooled>( entity, this );
+    mBuild( reg, entity );
+
+    ++mBuiltCount;
+    if( mParked.capacity() < mBuiltCount )
+      mParked.reserve( 2 * mBuiltCount );
+                        // Every entity built may be parked at once
+
+    return entity;
+
+  } // CInvEntityPool::Build
+
+} // namespace Inv
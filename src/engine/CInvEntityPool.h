@@ -0,0 +1,83 @@
+//****************************************************************************************************
+//! \file CInvEntityPool.h
+//! Module declares class CInvEntityPool, which keeps pruned entities of one type for reuse.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvEntityPool
+#define H_CInvEntityPool
+
+#include <entity/registry.hpp>
+
+#include <InvGlobals.h>
+
+namespace Inv
+{
+
+  /*! \brief Class represents pool of entities of one short-living type (missiles, explosions). Such
+      entities are created and pruned many times a second; building them from scratch means copying
+      the sprite and allocating its effects every time. Pooled entity is built only once, when it
+      is pruned, it is parked (see cpParked) instead of destroyed and next entity of the same type
+      reuses it, only its components are initialized again in place.
+
+      Entities built by the pool have component cpPooled, so garbage collector knows where to return
+      them. Parked entity loses its position and collision layers, components describing its look
+      (cpGraphics, which holds the sprite) are kept. Pool must be used from the simulation thread
+      only (usually when command buffer is applied, see CInvCommandBuffer::CreatePooled()). */
+  class CInvEntityPool
+  {
+  public:
+
+    using FnBuild_t = std::function<void( entt::registry &, entt::entity )>;
+    //!< \brief Function emplacing persistent components (sprite, effects) to newly created entity
+
+    CInvEntityPool( FnBuild_t build );
+
+    CInvEntityPool( const CInvEntityPool & ) = delete;
+    CInvEntityPool & operator=( const CInvEntityPool & ) = delete;
+    ~CInvEntityPool();
+
+    void Prewarm( entt::registry & reg, size_t count );
+    /*!< \brief Builds given number of entities and parks them, so that no entity needs to be built
+         while the game runs (unless more of them are alive at once). */
+
+    entt::entity Acquire( entt::registry & reg );
+    /*!< \brief Returns parked entity, or builds new one if no entity is parked. Persistent
+         components of the entity are emplaced, the others (position, velocity...) must be emplaced
+         or replaced by the caller. */
+
+    void Park( entt::registry & reg, entt::entity entity );
+    /*!< \brief Parks pruned entity belonging to the pool, instead of destroying it. Entity which
+         is already parked is ignored. */
+
+    void Clear();
+    /*!< \brief Forgets all parked entities, must be called when the registry is cleared. */
+
+    size_t GetParkedCount() const { return mParked.size(); }
+    /*!< \brief Returns number of entities waiting for reuse */
+
+    size_t GetBuiltCount() const { return mBuiltCount; }
+    /*!< \brief Returns number of entities built by the pool since last Clear() */
+
+  private:
+
+    entt::entity Build( entt::registry & reg );
+    /*!< \brief Creates new entity belonging to the pool */
+
+    FnBuild_t mBuild;
+    //!< Function emplacing persistent components to new entity
+
+    std::vector<entt::entity> mParked;
+    //!< Entities waiting for reuse, the last parked one is reused first
+
+    size_t mBuiltCount;
+    //!< Number of entities built since last Clear(), parked vector is reserved for all of them
+
+  }; // class CInvEntityPool
+
+} // namespace Inv
+
+#endif
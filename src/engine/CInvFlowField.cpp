@@ -0,0 +1,72 @@
+//****************************************************************************************************
+//! \file CInvFlowField.cpp
+//! Module defines class CInvFlowField, coarse vector field leading actors towards common target.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <engine/CInvFlowField.h>
+
+
+namespace Inv
+{
+  CInvFlowField::CInvFlowField():
+    mInvCellSize( 1.0f ),
+    mColumns( 0 ),
+    mRows( 0 ),
+    mDirX(),
+    mDirY(),
+    mNear(),
+    mIsValid( false )
+  {}
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvFlowField::~CInvFlowField() = default;
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvFlowField::Build( float cellSize, float nearDistance, float width, float height,
+                             float tgtLeft, float tgtTop, float tgtRight, float tgtBottom )
+  {
+    if( cellSize < 1.0f )
+      cellSize = 1.0f;
+
+    mInvCellSize = 1.0f / cellSize;
+    mColumns = max( 1u, (uint32_t)ceilf( width * mInvCellSize ) );
+    mRows = max( 1u, (uint32_t)ceilf( height * mInvCellSize ) );
+
+    size_t cells = (size_t)mColumns * mRows;
+    mDirX.resize( cells );
+    mDirY.resize( cells );
+    mNear.resize( cells );
+
+    float nearCentre = max( mNearCells * cellSize, nearDistance + 0.7072f * cellSize );
+    float nearDistanceSq = nearCentre * nearCentre;
+                        // Any point of the cell is at most half of the diagonal from its centre
+
+    for( uint32_t cy = 0; cy < mRows; ++cy )
+    {
+      float centreY = ( (float)cy + 0.5f ) * cellSize;
+      float dy = min( max( centreY, tgtTop ), tgtBottom ) - centreY;
+                        // Nearest point of the rectangle is the centre clamped to it
+
+      for( uint32_t cx = 0; cx < mColumns; ++cx )
+      {
+        float centreX = ( (float)cx + 0.5f ) * cellSize;
+        float dx = min( max( centreX, tgtLeft ), tgtRight ) - centreX;
+
+        size_t cell = (size_t)cy * mColumns + cx;
+        mDirX[cell] = dx;
+        mDirY[cell] = dy;
+        mNear[cell] = ( dx * dx + dy * dy < nearDistanceSq ) ? 1 : 0;
+      } // for
+    } // for
+
+    mIsValid = true;
+
+  } // CInvFlowField::Build
+
+} // namespace Inv
@@ -0,0 +1,124 @@
+//****************************************************************************************************
+//! \file CInvFlowField.h
+//! Module declares class CInvFlowField, coarse vector field leading actors towards common target.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvFlowField
+#define H_CInvFlowField
+
+#include <InvGlobals.h>
+
+namespace Inv
+{
+
+  /*! \brief Class represents grid of square cells covering the scene, every cell holds direction
+      from its centre to the nearest point of target rectangle (point target is rectangle of zero
+      size). Field is built once per tick, actors heading to the same target then only look up
+      their cell instead of evaluating their own vector to the target, so the cost of building
+      depends on number of cells, not on number of actors.
+
+      Directions are not normalized, the steering kernel (see FnSteerClamp_t) uses them as
+      vectors to the target. Cells near to the target (where direction from the centre of the
+      cell differs too much from direction from actor) are marked, actors in them must steer by
+      their own vector to the target. Cell vectors are not released between builds. */
+  class CInvFlowField
+  {
+  public:
+
+    CInvFlowField();
+
+    CInvFlowField( const CInvFlowField & ) = delete;
+    CInvFlowField & operator=( const CInvFlowField & ) = delete;
+    ~CInvFlowField();
+
+    void Build( float cellSize, float nearDistance, float width, float height,
+                float tgtLeft, float tgtTop, float tgtRight, float tgtBottom );
+    /*!< \brief Builds the field for given target rectangle.
+
+         \param[in] cellSize      Size of one (square) cell in pixels
+         \param[in] nearDistance  Actors nearer to the target than this distance are guaranteed
+                                  to lie in cells marked as near (Sample() fails for them), so
+                                  the caller need not measure distance of actors in other cells
+         \param[in] width         Width of covered area (scene), starting at X = 0
+         \param[in] height        Height of covered area (scene), starting at Y = 0
+         \param[in] tgtLeft       Left edge of target rectangle
+         \param[in] tgtTop        Top edge of target rectangle
+         \param[in] tgtRight      Right edge of target rectangle
+         \param[in] tgtBottom     Bottom edge of target rectangle */
+
+    void Invalidate() { mIsValid = false; }
+    /*!< \brief Marks the field as not built, Sample() fails until next Build() */
+
+    bool Sample( float x, float y, float & dx, float & dy ) const
+    {
+      if( !mIsValid )
+        return false;
+
+      uint32_t cell = CellIndex( x, y );
+      if( 0 != mNear[cell] )
+        return false;
+
+      dx = mDirX[cell];
+      dy = mDirY[cell];
+      return true;
+    } // Sample
+    /*!< \brief Returns direction towards the target at given position. Positions out of the covered
+         area use the nearest border cell.
+
+         \param[in]  x   X coordinate of the actor
+         \param[in]  y   Y coordinate of the actor
+         \param[out] dx  X component of direction (not normalized)
+         \param[out] dy  Y component of direction (not normalized)
+         \return False if the field is not built or the position is near to the target, actor
+                 must use its own vector to the target then */
+
+    bool IsValid() const { return mIsValid; }
+    /*!< \brief Returns true if the field was built since last Invalidate() */
+
+  private:
+
+    uint32_t CellIndex( float x, float y ) const
+    {
+      int32_t cx = (int32_t)floorf( x * mInvCellSize );
+      int32_t cy = (int32_t)floorf( y * mInvCellSize );
+      cx = ( cx < 0 ) ? 0 : min( cx, (int32_t)mColumns - 1 );
+      cy = ( cy < 0 ) ? 0 : min( cy, (int32_t)mRows - 1 );
+      return (uint32_t)cy * mColumns + (uint32_t)cx;
+    } // CellIndex
+    /*!< \brief Converts scene coordinates to index of cell, clamped to covered area */
+
+    static constexpr float mNearCells = 1.5f;
+    //!< Cells whose centre is nearer to the target than this number of cells are marked as near,
+    //!  at least (direction from the centre of the cell then differs from direction from any
+    //!  point of the cell by less than 30 degrees)
+
+    float mInvCellSize;
+    //!< Inverse value of cell size, multiplication is cheaper than division
+
+    uint32_t mColumns;
+    //!< Number of columns of the grid
+
+    uint32_t mRows;
+    //!< Number of rows of the grid
+
+    std::vector<float> mDirX;
+    //!< X component of direction to the target for every cell, indexed by row * columns + column
+
+    std::vector<float> mDirY;
+    //!< Y component of direction to the target for every cell
+
+    std::vector<uint8_t> mNear;
+    //!< Non-zero for cells near to the target
+
+    bool mIsValid;
+    //!< True if the field was built
+
+  }; // class CInvFlowField
+
+} // namespace Inv
+
+#endif
@@ -0,0 +1,308 @@
+//****************************************************************************************************
+//! \file CInvFormationIndex.cpp
+//! Module defines class CInvFormationIndex, lattice index of alien formation used to find aliens
+//! near to given point without searching the whole swarm.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <bit>
+
+#include <engine/CInvFormationIndex.h>
+
+#include <CInvLogger.h>
+
+
+static const std::string lModLogId( "FORMATION" );
+
+namespace Inv
+{
+  CInvFormationIndex::CInvFormationIndex():
+    mOriginX( 0.0f ),
+    mColumnPitch( 1.0f ),
+    mSlotHalfWidth( 0.0f ),
+    mDisplacementX( 0.0f ),
+    mDisplacementY( 0.0f ),
+    mRowTop(),
+    mRowBottom(),
+    mColumnBits(),
+    mSlotItems(),
+    mOccupiedCount( 0 ),
+    mColumnMembers(),
+    mRowMembers(),
+    mRowMemberBits( 0ull ),
+    mMembersCount( 0 ),
+    mFirstMemberColumn( 0 ),
+    mLastMemberColumn( 0 ),
+    mStayingBits(),
+    mRowStaying(),
+    mRowStayingBits( 0ull )
+  {}
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvFormationIndex::~CInvFormationIndex() = default;
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvFormationIndex::Reset( float originX, float columnPitch, float slotWidth )
+  {
+    mOriginX = originX;
+    mColumnPitch = IsPositive( columnPitch ) ? columnPitch : 1.0f;
+    mSlotHalfWidth = 0.5f * slotWidth;
+    mDisplacementX = 0.0f;
+    mDisplacementY = 0.0f;
+    mRowTop.clear();
+    mRowBottom.clear();
+    mColumnBits.clear();
+    mSlotItems.clear();
+    mOccupiedCount = 0;
+    mColumnMembers.clear();
+    mRowMembers.clear();
+    mRowMemberBits = 0ull;
+    mMembersCount = 0;
+    mFirstMemberColumn = 0;
+    mLastMemberColumn = 0;
+    mStayingBits.clear();
+    mRowStaying.clear();
+    mRowStayingBits = 0ull;
+
+  } // CInvFormationIndex::Reset
+
+  //----------------------------------------------------------------------------------------------
+
+  uint32_t CInvFormationIndex::AddRow( float yCentre, float slotHeight )
+  {
+    if( mMaxRows <= mRowTop.size() )
+    {
+      LOG << "Formation cannot have more than " << mMaxRows << " rows.";
+      return UINT32_MAX;
+    } // if
+
+    mRowTop.push_back( yCentre - 0.5f * slotHeight );
+    mRowBottom.push_back( yCentre + 0.5f * slotHeight );
+    mRowMembers.push_back( 0 );
+    mRowStaying.push_back( 0 );
+    return (uint32_t)mRowTop.size() - 1;
+
+  } // CInvFormationIndex::AddRow
+
+  //----------------------------------------------------------------------------------------------
+
+  uint32_t CInvFormationIndex::GetColumn( float x ) const
+  {
+    float column = floorf( ( x - mOriginX ) / mColumnPitch + 0.5f );
+    return ( column < 0.0f ) ? 0u : (uint32_t)column;
+
+  } // CInvFormationIndex::GetColumn
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvFormationIndex::ClearOccupancy()
+  {
+    std::fill( mColumnBits.begin(), mColumnBits.end(), 0ull );
+    mOccupiedCount = 0;
+
+  } // CInvFormationIndex::ClearOccupancy
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvFormationIndex::SetOccupied( uint32_t row, uint32_t column, uint32_t item )
+  {
+    if( mRowTop.size() <= row )
+      return;
+
+    if( mColumnBits.size() <= column )
+    {                   // Lattice grows to the widest row, it is done only in first ticks
+      mColumnBits.resize( column + 1, 0ull );
+      mSlotItems.resize( (size_t)( column + 1 ) * mMaxRows, 0u );
+    } // if
+
+    uint64_t bit = 1ull << row;
+    if( 0 == ( mColumnBits[column] & bit ) )
+      ++mOccupiedCount;
+
+    mColumnBits[column] |= bit;
+    mSlotItems[(size_t)column * mMaxRows + row] = item;
+
+  } // CInvFormationIndex::SetOccupied
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvFormationIndex::Query( float xMin, float xMax, float yMin, float yMax, std::vector<uint32_t> & items ) const
+  {
+    if( 0 == mOccupiedCount )
+      return;
+
+    xMin -= mDisplacementX + mSlotHalfWidth + mMargin;
+    xMax -= mDisplacementX - mSlotHalfWidth - mMargin;
+    yMin -= mDisplacementY + mMargin;
+    yMax -= mDisplacementY - mMargin;
+                        // Box is converted to starting coordinates of formation and enlarged
+                        // by half of the slot, so that the test can be done against column
+                        // centres only.
+
+    float firstColumn = ceilf( ( xMin - mOriginX ) / mColumnPitch );
+    float lastColumn = floorf( ( xMax - mOriginX ) / mColumnPitch );
+    if( lastColumn < 0.0f || lastColumn < firstColumn )
+      return;
+
+    uint32_t colFrom = ( firstColumn < 0.0f ) ? 0u : (uint32_t)firstColumn;
+    uint32_t colTo = min( (uint32_t)lastColumn, (uint32_t)mColumnBits.size() - 1u );
+
+    for( uint32_t column = colFrom; column <= colTo && column < mColumnBits.size(); ++column )
+    {
+      uint64_t bits = mColumnBits[column];
+      while( 0 != bits )
+      {                 // Only occupied slots of the column are visited
+        uint32_t row = (uint32_t)std::countr_zero( bits );
+        bits &= bits - 1;
+
+        if( mRowBottom[row] < yMin || yMax < mRowTop[row] )
+          continue;
+
+        items.push_back( mSlotItems[(size_t)column * mMaxRows + row] );
+      } // while
+    } // for
+
+  } // CInvFormationIndex::Query
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvFormationIndex::AddMember( uint32_t row, uint32_t column )
+  {
+    if( mRowTop.size() <= row )
+      return;
+
+    if( mColumnMembers.size() <= column )
+      mColumnMembers.resize( column + 1, 0u );
+
+    if( 0 == mMembersCount )
+    {
+      mFirstMemberColumn = column;
+      mLastMemberColumn = column;
+    } // if
+    else
+    {
+      mFirstMemberColumn = min( mFirstMemberColumn, column );
+      mLastMemberColumn = max( mLastMemberColumn, column );
+    } // else
+
+    ++mColumnMembers[column];
+    ++mRowMembers[row];
+    mRowMemberBits |= 1ull << row;
+    ++mMembersCount;
+
+  } // CInvFormationIndex::AddMember
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvFormationIndex::RemoveMember( uint32_t row, uint32_t column )
+  {
+    if( mRowTop.size() <= row || mColumnMembers.size() <= column ||
+        0 == mColumnMembers[column] || 0 == mRowMembers[row] )
+      return;
+
+    SetStaying( row, column, false );
+
+    --mMembersCount;
+    if( 0 == --mRowMembers[row] )
+      mRowMemberBits &= ~( 1ull << row );
+
+    if( 0 < --mColumnMembers[column] || 0 == mMembersCount )
+      return;           // Edges change only when some column becomes empty
+
+    while( 0 == mColumnMembers[mFirstMemberColumn] )
+      ++mFirstMemberColumn;
+    while( 0 == mColumnMembers[mLastMemberColumn] )
+      --mLastMemberColumn;
+                        // Each column is skipped at most once during whole life of the formation
+
+  } // CInvFormationIndex::RemoveMember
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvFormationIndex::SetStaying( uint32_t row, uint32_t column, bool staying )
+  {
+    if( mRowTop.size() <= row )
+      return;
+
+    if( mStayingBits.size() <= column )
+    {
+      if( !staying )
+        return;
+      mStayingBits.resize( column + 1, 0ull );
+    } // if
+
+    uint64_t bit = 1ull << row;
+    if( staying == ( 0 != ( mStayingBits[column] & bit ) ) )
+      return;           // Nothing changes, the same alien may be reported by more signals
+
+    if( staying )
+    {
+      mStayingBits[column] |= bit;
+      ++mRowStaying[row];
+      mRowStayingBits |= bit;
+    } // if
+    else
+    {
+      mStayingBits[column] &= ~bit;
+      if( 0 == --mRowStaying[row] )
+        mRowStayingBits &= ~bit;
+    } // else
+
+  } // CInvFormationIndex::SetStaying
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvFormationIndex::GetStayingTop( float & yCentre ) const
+  {
+    if( 0 == mRowStayingBits )
+      return false;
+
+    bool first = true;
+    uint64_t bits = mRowStayingBits;
+    while( 0 != bits )
+    {                   // Rows need not be ordered from top to bottom, at most 64 of them are visited
+      uint32_t row = (uint32_t)std::countr_zero( bits );
+      bits &= bits - 1;
+
+      float rowCentre = 0.5f * ( mRowTop[row] + mRowBottom[row] );
+      yCentre = first ? rowCentre : min( yCentre, rowCentre );
+      first = false;
+    } // while
+
+    yCentre += mDisplacementY;
+    return true;
+
+  } // CInvFormationIndex::GetStayingTop
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvFormationIndex::GetExtents( float & left, float & right, float & top, float & bottom ) const
+  {
+    left = mOriginX + (float)mFirstMemberColumn * mColumnPitch - mSlotHalfWidth + mDisplacementX;
+    right = mOriginX + (float)mLastMemberColumn * mColumnPitch + mSlotHalfWidth + mDisplacementX;
+
+    top = 0.0f;
+    bottom = 0.0f;
+    bool first = true;
+    uint64_t bits = mRowMemberBits;
+    while( 0 != bits )
+    {                   // Rows may be of different heights, at most 64 of them are visited
+      uint32_t row = (uint32_t)std::countr_zero( bits );
+      bits &= bits - 1;
+
+      top = first ? mRowTop[row] : min( top, mRowTop[row] );
+      bottom = first ? mRowBottom[row] : max( bottom, mRowBottom[row] );
+      first = false;
+    } // while
+
+    top += mDisplacementY;
+    bottom += mDisplacementY;
+
+  } // CInvFormationIndex::GetExtents
+
+} // namespace Inv
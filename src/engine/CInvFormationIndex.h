@@ -0,0 +1,201 @@
+//****************************************************************************************************
+//! \file CInvFormationIndex.h
+//! Module declares class CInvFormationIndex, lattice index of alien formation used to find aliens
+//! near to given point without searching the whole swarm.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvFormationIndex
+#define H_CInvFormationIndex
+
+#include <InvGlobals.h>
+
+namespace Inv
+{
+
+  /*! \brief Class represents lattice of slots in which aliens of the formation are placed when the
+      scene is generated (see CInvGameScene::GenerateNewScene()). The lattice is described in starting
+      coordinates of the formation; as the formation moves rigidly, the actual position of the lattice
+      is given by single displacement vector. Rows may have different heights (different alien types)
+      and may be shifted horizontally against each other, so columns have half of the alien pitch,
+      alien in formation occupies one column of the lattice.
+
+      Occupancy is held as one bitboard per column (bit \e n is set if the slot in row \e n is
+      occupied), every occupied slot contains an item (usually index into some external vector).
+      Aliens which left the formation (raid) must not be marked as occupying their slot, they
+      must be searched by some generic method.
+
+      The displacement is the origin of the formation: aliens staying in formation do not move
+      themselves, their actual position is their starting position (cpAlienBehave) plus the
+      displacement, so moving whole formation is single translation. Independently of occupancy,
+      the index counts living members of the formation in every column and row (raiding aliens
+      included, their place in formation moves as well), so the extents of the formation are
+      maintained incrementally as aliens die, without scanning the swarm. Members actually staying
+      in their slots (living and not raiding) are marked separately, the topmost of them gives
+      the danger line for the player. */
+  class CInvFormationIndex
+  {
+  public:
+
+    CInvFormationIndex();
+
+    CInvFormationIndex( const CInvFormationIndex & ) = delete;
+    CInvFormationIndex & operator=( const CInvFormationIndex & ) = delete;
+    ~CInvFormationIndex();
+
+    void Reset( float originX, float columnPitch, float slotWidth );
+    /*!< \brief Removes all rows and sets horizontal parameters of the lattice.
+
+         \param[in] originX      X coordinate of centre of column 0 (starting coordinates)
+         \param[in] columnPitch  Distance between centres of neighbouring columns
+         \param[in] slotWidth    Width of alien placed in a slot */
+
+    uint32_t AddRow( float yCentre, float slotHeight );
+    /*!< \brief Adds new row to the lattice.
+
+         \param[in] yCentre     Y coordinate of centre of the row (starting coordinates)
+         \param[in] slotHeight  Height of aliens placed in the row
+         \return Index of added row, or UINT32_MAX if maximal number of rows was reached */
+
+    uint32_t GetColumn( float x ) const;
+    /*!< \brief Returns index of column whose centre is nearest to given X coordinate (starting
+         coordinates). Coordinates left of column 0 are mapped to column 0. */
+
+    void SetDisplacement( float dx, float dy ) { mDisplacementX = dx; mDisplacementY = dy; }
+    /*!< \brief Sets actual displacement of the formation against its starting position */
+
+    void Translate( float dx, float dy ) { mDisplacementX += dx; mDisplacementY += dy; }
+    /*!< \brief Moves whole formation by given vector */
+
+    float GetDisplacementX() const { return mDisplacementX; }
+    /*!< \brief Returns actual displacement of the formation in X axis, actual X position of alien
+         staying in formation is its starting X position plus this value */
+
+    float GetDisplacementY() const { return mDisplacementY; }
+    /*!< \brief Returns actual displacement of the formation in Y axis, actual Y position of alien
+         staying in formation is its starting Y position plus this value */
+
+    void AddMember( uint32_t row, uint32_t column );
+    /*!< \brief Registers living alien belonging to given slot. Slots outside of the lattice are
+         ignored. */
+
+    void RemoveMember( uint32_t row, uint32_t column );
+    /*!< \brief Unregisters alien belonging to given slot (it died or left the scene). Extents are
+         updated, edge moves inwards only over columns which became empty. Alien is no longer
+         staying in the slot as well. */
+
+    void SetStaying( uint32_t row, uint32_t column, bool staying );
+    /*!< \brief Marks member of given slot as staying in the slot (or not). Marking is idempotent,
+         so it may be called from every signal concerning the alien. */
+
+    bool GetStayingTop( float & yCentre ) const;
+    /*!< \brief Finds topmost row with member staying in its slot.
+
+         \param[out] yCentre  Y coordinate of centre of the row in actual scene coordinates
+         \return False if no member stays in formation, yCentre is not changed then */
+
+    bool HasMembers() const { return 0 < mMembersCount; }
+    /*!< \brief Returns true if at least one living alien belongs to the formation */
+
+    void GetExtents( float & left, float & right, float & top, float & bottom ) const;
+    /*!< \brief Returns bounding box of slots of all living members of the formation, in actual
+         scene coordinates. Must not be called if there are no members.
+
+         \param[out] left    Left edge of the leftmost occupied column
+         \param[out] right   Right edge of the rightmost occupied column
+         \param[out] top     Top edge of the topmost occupied row
+         \param[out] bottom  Bottom edge of the bottommost occupied row */
+
+    void ClearOccupancy();
+    /*!< \brief Marks all slots as empty */
+
+    void SetOccupied( uint32_t row, uint32_t column, uint32_t item );
+    /*!< \brief Marks slot as occupied by given item. Slots outside of the lattice are ignored. */
+
+    void Query( float xMin, float xMax, float yMin, float yMax, std::vector<uint32_t> & items ) const;
+    /*!< \brief Appends items from all occupied slots, whose area overlaps given box (in actual scene
+         coordinates) to the vector. Only columns overlapped by the box are examined.
+
+         \param[in]  xMin   Left edge of box
+         \param[in]  xMax   Right edge of box
+         \param[in]  yMin   Top edge of box
+         \param[in]  yMax   Bottom edge of box
+         \param[out] items  Vector to which found items are appended */
+
+    bool IsEmpty() const { return 0 == mOccupiedCount; }
+    /*!< \brief Returns true if no slot is occupied */
+
+  private:
+
+    static constexpr uint32_t mMaxRows = 64;
+    //!< Maximal number of rows, given by size of column bitboard
+
+    static constexpr float mMargin = 2.0f;
+    //!< Slot area is enlarged by this margin [px], so that the rounding of sprite position in
+    //!  renderer cannot cause missed candidate
+
+    float mOriginX;
+    //!< X coordinate of centre of column 0 (starting coordinates)
+
+    float mColumnPitch;
+    //!< Distance between centres of neighbouring columns
+
+    float mSlotHalfWidth;
+    //!< Half of width of alien in the slot
+
+    float mDisplacementX;
+    //!< Actual displacement of formation in X axis
+
+    float mDisplacementY;
+    //!< Actual displacement of formation in Y axis
+
+    std::vector<float> mRowTop;
+    //!< Top edge of every row (starting coordinates)
+
+    std::vector<float> mRowBottom;
+    //!< Bottom edge of every row (starting coordinates)
+
+    std::vector<uint64_t> mColumnBits;
+    //!< Occupancy bitboard of every column, bit n represents row n
+
+    std::vector<uint32_t> mSlotItems;
+    //!< Items stored in slots, indexed by column * mMaxRows + row
+
+    uint32_t mOccupiedCount;
+    //!< Number of occupied slots
+
+    std::vector<uint32_t> mColumnMembers;
+    //!< Number of living members of the formation in every column
+
+    std::vector<uint32_t> mRowMembers;
+    //!< Number of living members of the formation in every row
+
+    uint64_t mRowMemberBits;
+    //!< Bit n is set if row n has at least one living member
+
+    uint32_t mMembersCount;
+    //!< Number of living members of the formation
+
+    uint32_t mFirstMemberColumn;
+    //!< Leftmost column with living member, valid if there is any member
+
+    uint32_t mLastMemberColumn;
+    //!< Rightmost column with living member, valid if there is any member
+
+    std::vector<uint64_t> mStayingBits;
+    //!< Bitboard of members staying in their slots for every column, bit n represents row n
+
+    std::vector<uint32_t> mRowStaying;
+    //!< Number of members staying in their slots in every row
+
+    uint64_t mRowStayingBits;
+    //!< Bit n is set if row n has at least one member staying in its slot
+
+  }; // class CInvFormationIndex
+
+} // namespace Inv
+
+#endif
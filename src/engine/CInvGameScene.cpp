@@ -10,6 +10,8 @@
 
 #include <engine/CInvGameScene.h>
 #include <engine/InvENTTComponents.h>
+#include <engine/InvENTTCollisionLayers.h>
+#include <engine/InvENTTEffects.h>
 
 #include <graphics/CInvSprite.h>
 #include <InvStringTools.h>
@@ -49,6 +51,9 @@ namespace Inv
 
     mTickReferencePoint( tickReferencePoint ),
     mDiffTickPoint{ 0 },
+    mActualTickPoint{ 0 },
+    mControlState( 0 ),
+    mControlValue( 0 ),
 
     //------ References to superior global objects (DI) and owned genral objects -----------------------
 
@@ -110,8 +115,10 @@ namespace Inv
     mPlayerLivesLeft( 0 ),
     mPlayerAmmoLeft( 0 ),
     mReloadingTicks( 0 ),
-    mTickLeftToReload( 0 ),
+    mReloadTimer( gNoTimer ),
     mIsInDangerousArea( false ),
+    mQuickDeathTicks( 0u ),
+    mQuickDeathTimer( gNoTimer ),
     mQuickDeathTicksLeft( 0u ),
 
     //------ Alien (group) global state ---------------------------------------------------------------
@@ -122,30 +129,78 @@ namespace Inv
     mAlienBossesLeft( 0 ),
     mAlienBosses( alienBosses ),
     mLastPipBeeped( 0u ),
+    mTimers(),
+    mFormationIndex(),
+    mCommands(),
+    mOutOfSceneEntities(),
+    mTickArena(),
+    mStatTicks( 0u ),
+    mStatTicksWithNew( 0u ),
+    mStatNewInTicks( 0u ),
 
     //------ EnTT processors --------------------------------------------------------------------------
 
 #define PROCCMN  tickReferencePoint, settings, settingsRuntime
 
     mProcGarbageCollector     ( PROCCMN, BIND_MEMBER_EVENT_CALLBACK( this, CInvGameScene::EntityJustPruned ) ),
-    mProcActorStateSelector   ( PROCCMN, mIsInDangerousArea ),
+    mProcActorStateSelector   ( PROCCMN, mIsInDangerousArea, mFormationIndex ),
     mProcEntitySpawner        ( PROCCMN, mEntityFactory, mSoundStorage ),
     mProcSpecialActorSpawner  ( PROCCMN, mEntityFactory, mSoundStorage, mAliensLeft, mAlienBossesLeft, mAlienBosses ),
-    mProcActorMover           ( PROCCMN, mVXGroup, mVYGroup ),
-    mProcAlienRaidDriver      ( PROCCMN ),
+    mProcActorMover           ( PROCCMN, mVXGroup, mVYGroup, mFormationIndex, mOutOfSceneEntities,
+                                0.0f, 0.0f, (float)settings.GetWidth(), (float)settings.GetHeight() ),
+    mProcAlienRaidDriver      ( PROCCMN, mFormationIndex, mTimers ),
     mProcPlayerFireUpdater    ( PROCCMN, mEntityFactory, mSoundStorage, mPlayerAmmoLeft ),
     mProcPlayerSpeedUpdater   ( PROCCMN ),
     mProcPlayerBoundsGuard    ( PROCCMN, 0.0f, 0.0f, (float)settings.GetWidth(), (float)settings.GetHeight(), mPlayerActX, mPlayerActY ),
-    mProcPlayerInDanger       ( PROCCMN, mIsInDangerousArea ),
-    mProcAlienBoundsGuard     ( PROCCMN, mVXGroup, mVYGroup, 0.0f, 0.0f, (float)settings.GetWidth(), (float)settings.GetHeight() ),
-    mProcActorOutOfSceneCheck ( PROCCMN, 0.0f, 0.0f, (float)settings.GetWidth(), (float)settings.GetHeight() ),
-    mProcCollisionDetector    ( PROCCMN, mCollisionTest ),
-    mProcActorRender          ( PROCCMN )
-  {}
+    mProcPlayerInDanger       ( PROCCMN, mIsInDangerousArea, mFormationIndex ),
+    mProcAlienBoundsGuard     ( PROCCMN, mFormationIndex, mVXGroup, mVYGroup, 0.0f, 0.0f, (float)settings.GetWidth(), (float)settings.GetHeight() ),
+    mProcActorOutOfSceneCheck ( PROCCMN, mOutOfSceneEntities ),
+    mProcActorAnimator        ( PROCCMN, mFormationIndex ),
+    mProcCollisionDetector    ( PROCCMN, mCollisionTest, mFormationIndex ),
+    mProcActorRender          ( PROCCMN ),
+    mScheduler( settings.GetWorkerThreads() )
+  {
+    mEnTTRegistry.on_construct<cpFormationSlot>().connect<&CInvGameScene::FormationStayingBegins>( *this );
+    mEnTTRegistry.on_construct<cpInFormation>().connect<&CInvGameScene::FormationStayingBegins>( *this );
+    mEnTTRegistry.on_destroy<cpInFormation>().connect<&CInvGameScene::FormationStayingEnds>( *this );
+    mEnTTRegistry.on_destroy<cpFormationSlot>().connect<&CInvGameScene::FormationStayingEnds>( *this );
+                        // Aliens staying in formation are tracked by formation lattice, so that
+                        // danger line need not be searched for every tick. Dying is reported to
+                        // the lattice directly by EliminateEntity().
+
+    mEnTTRegistry.on_construct<cpInFormation>().connect<&procActorStateSelector::formationJoined>( mProcActorStateSelector );
+                        // Aliens joining formation get their random events scheduled
+
+    ScheduleProcessors();
+  } // CInvGameScene::CInvGameScene
 
   //-------------------------------------------------------------------------------------------------
 
-  CInvGameScene::~CInvGameScene() = default;
+  CInvGameScene::~CInvGameScene()
+  {
+    mEnTTRegistry.on_construct<cpFormationSlot>().disconnect( this );
+    mEnTTRegistry.on_construct<cpInFormation>().disconnect( this );
+    mEnTTRegistry.on_destroy<cpInFormation>().disconnect( this );
+    mEnTTRegistry.on_destroy<cpFormationSlot>().disconnect( this );
+    mEnTTRegistry.on_construct<cpInFormation>().disconnect( &mProcActorStateSelector );
+
+    LOG;
+    LOG << "Collision candidates tested: " << mProcCollisionDetector.mStatCandidatesTested;
+    LOG << "Collision pairs hit: " << mProcCollisionDetector.mStatPairsHit;
+    if( 0 < mProcCollisionDetector.mStatCacheLookups )
+      LOG << "Collision pair cache hit rate: "
+          << 100.0 * (double)mProcCollisionDetector.mStatCacheHits / (double)mProcCollisionDetector.mStatCacheLookups
+          << " % (" << mProcCollisionDetector.mStatCacheHits << " of " << mProcCollisionDetector.mStatCacheLookups << ")";
+    if( 0 < mProcCollisionDetector.mPairCache.GetRefusedCount() )
+      LOG << "Collision pair cache was full, " << mProcCollisionDetector.mPairCache.GetRefusedCount()
+          << " pairs refused (capacity " << mProcCollisionDetector.mPairCache.GetCapacity() << " slots)";
+    LOG << "Tick arena size: " << mTickArena.GetCapacity() << " B, overflowed in "
+        << mTickArena.GetOverflowCount() << " ticks";
+#ifdef _DEBUG
+    LOG << "Ticks with global allocation: " << mStatTicksWithNew << " of " << mStatTicks
+        << " (" << mStatNewInTicks << " calls of operator new)";
+#endif
+  } // CInvGameScene::~CInvGameScene
 
   //-------------------------------------------------------------------------------------------------
 
@@ -231,6 +286,14 @@ namespace Inv
     mAliensLeft = 0;    // No aliens on the scene yet and alien group is not moving
     mAlienBossesLeft = 0;
 
+    auto widestRow = alienWidth * (float)maxAliens + spaceInBetween * (float)( maxAliens - 1u );
+    mFormationIndex.Reset(
+      mSceneTopLeftX + ( mSceneWidth - widestRow ) * 0.5f + alienWidth * 0.5f,
+      ( alienWidth + spaceInBetween ) * 0.5f,
+      alienWidth );     // Formation lattice starts at the first alien of the widest row. Its columns
+                        // have half of the alien pitch, so that rows with odd and even number of
+                        // aliens (shifted by half of pitch) fit in.
+
     uint32_t rowIndex = 0;
     for( auto & ar : alienRows )
     {                   // Generate aliens row by row
@@ -247,10 +310,18 @@ namespace Inv
       auto spaceTakenByAliens = alienWidth * (float)ar.first;
       auto spaceTakenByRow = spaceTakenByAliens + spaceInBetween * ( (uint32_t)ar.first - 1u );
 
+      auto latticeRow = mFormationIndex.AddRow( yPos, alienHeight );
+
       auto xPos = mSceneTopLeftX + ( mSceneWidth - spaceTakenByRow ) * 0.5f + alienWidth * 0.5f;
       for( uint32_t i = 0; i < ar.first; ++i )
       {
-        mEntityFactory.AddAlienEntity( ar.second, xPos, yPos, 0.0f, 0.0f, alienWidth );
+        auto alien = mEntityFactory.AddAlienEntity( ar.second, xPos, yPos, 0.0f, 0.0f, alienWidth );
+        if( UINT32_MAX != latticeRow && mEnTTRegistry.valid( alien ) )
+        {
+          auto & slot = mEnTTRegistry.emplace<cpFormationSlot>( alien, latticeRow, mFormationIndex.GetColumn( xPos ) );
+          mFormationIndex.AddMember( slot.row, slot.column );
+        } // if
+        UpdateCollisionLayers( mEnTTRegistry, alien );
         xPos += alienWidth + spaceInBetween;
         ++mAliensLeft;
       } // for
@@ -351,7 +422,7 @@ namespace Inv
 //     if( 0u < raiders )
 //     {
 //       pStat.isInRaid = true;
-//       pStat.raidTicksLeft = UINT32_MAX;
+//       pStat.isRaidStarting = true;
 //       --raiders;
 //     }
 //   } );
@@ -369,85 +440,74 @@ namespace Inv
     ControlValue_t controlValue )
   {
 
-    mProcGarbageCollector.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint );
-                        // Removes entities marked as inactive from the registry, noticing
-                        // main scene class if demanded.
-
-    mProcActorStateSelector.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint, mQuickDeathTicksLeft );
-                        // All entities are checked for state changes (firing, raid, etc.) according
-                        // to their behavior component and random events.
-
-    mProcEntitySpawner.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint );
-                        // New entities are spawned according to spawn requests stored in the
-                        // registry by other processors (as missiles, for example).
+#ifdef _DEBUG
+    uint64_t newCountAtStart = GetGlobalNewCount();
+#endif
 
-    mProcSpecialActorSpawner.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint, mPlayerActY, mQuickDeathTicksLeft );
-                        // Special entities (as alien boss) are spawned according to special
-                        // spawn requests stored in the registry by other processors.
-
-    mProcPlayerSpeedUpdater.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint, controlState, controlValue );
-                        // Player velocity is updated according to control state (keyboard)
-
-    mProcPlayerFireUpdater.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint, controlState, controlValue );
-                        // Player shoot requests are processed, new missiles are created if possible
-
-    mProcPlayerBoundsGuard.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint );
-                        // Player entity is kept within scene bounds
-
-    mProcPlayerInDanger.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint );
-                        // Player is marked as being in dangerous area (above alien formation)
-
-    mProcAlienBoundsGuard.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint, mPlayerHeight * 1.25f );
-                        // Alien entities are kept within scene bounds, alien group velocity is
-                        // changed if needed. When first alien reaches left or right scene border,
-                        // whole alien group is moved down for a few moment ant then starts moving in
-                        // X-axis in opposite direction.
+    mActualTickPoint = actualTickPoint;
+    mControlState = controlState;
+    mControlValue = controlValue;
 
-    mProcActorMover.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint );
-                        // All entities are moved according to their velocity
+    mQuickDeathTicksLeft = mTimers.IsPending( mQuickDeathTimer ) ?
+      (uint32_t)mTimers.GetTicksLeft( mQuickDeathTimer ) : mQuickDeathTicks;
+                        // Processors get ticks left to sudden death as plain value
 
-    mProcAlienRaidDriver.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint, mQuickDeathTicksLeft );
-                        // Raiding or returning aliens have their velocity adjusted
-
-    mProcActorOutOfSceneCheck.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint );
-                        // All entities out of scene are marked as inactive and will be removed by garbage
-                        // collector in next loop.
+    mScheduler.Run( mEnTTRegistry );
+                        // Simulation processors (from garbage collector to animator) are run according
+                        // to their dependencies, see ScheduleProcessors().
 
     mBackground.Draw( mTickReferencePoint, actualTickPoint, mDiffTickPoint );
                         // Background is drawn first, then all entities on it by procActorRender
                         // processor.
 
     mProcActorRender.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint );
-                        // All entities are rendered according to their graphics component and status
+                        // All entities are drawn as computed by procActorAnimator, no game state
+                        // is changed here
 
-    mProcCollisionDetector.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint );
-    for( auto & item : mProcCollisionDetector.mCollidedPairs )
-    {                   // Missile hits and alien-player collisions are handled
-      auto [ id1, dmg1 ] = mEnTTRegistry.try_get<cpId, cpDamage>( item.first );
+    {
+      procCollisionDetector::CollidedPairs_t collidedPairs( mTickArena.GetResource() );
+      mProcCollisionDetector.update( mEnTTRegistry, actualTickPoint, mDiffTickPoint, collidedPairs );
+      for( auto & item : collidedPairs )
+      {                 // Missile hits and alien-player collisions are handled
+        auto [ id1, dmg1 ] = mEnTTRegistry.try_get<cpId, cpDamage>( item.first );
 
-      if( nullptr != id1 && nullptr != dmg1 && dmg1->removeOnHit )
-        id1->active = false;
+        if( nullptr != id1 && nullptr != dmg1 && dmg1->removeOnHit )
+        {
+          DeactivateEntity( mEnTTRegistry, item.first );
+        } // if
                         // Missile is being removed by simple pruning and garbage collecting (it simply
                         // disappears). Alien that rams into the player, on other hand, is not eliminated
                         // at all (as its removeOnHit flag is set to false).
 
-      EliminateEntity( item.second );
+        EliminateEntity( item.second );
                         // Player or alien hit by missile is eliminated from the scene by much more complex
                         // procedure, involving explosion creation (and possible player respawn).
-    } // for
-
-    if( 0 < mTickLeftToReload )
-      --mTickLeftToReload;
-    else                // Player weapon is reloaded and ready to fire again
-    {
-      mTickLeftToReload = mReloadingTicks;
-      if( mPlayerAmmoLeft < mSettings.GetAmmo() )
-        ++mPlayerAmmoLeft;
-    } // else
+      } // for
+    }                   // List of collided pairs lives in the tick arena, it must not outlive the tick
+
+    mCommands.Apply( mEnTTRegistry );
+                        // Explosions recorded while collisions were handled are created at once
+
+    mTimers.Advance();  // Countdowns expiring in this tick fire (weapon reloading, sudden death,
+                        // end of alien raids)
+
+#ifdef _DEBUG
+    uint64_t newCount = GetGlobalNewCount() - newCountAtStart;
+    ++mStatTicks;
+    if( 0 < newCount )
+    {                   // Some allocation still goes around the tick arena. Every such tick is
+                        // reported. Known sources: first use of a cache slot of scaled collision
+                        // mask of an image, growth of retained vectors above their largest size so
+                        // far, first use of command buffer batch, processor graph built in the
+                        // first tick. Counter sees global operator new only, so a tick without
+                        // report is not proof that nothing was allocated (malloc of libraries).
+      ++mStatTicksWithNew;
+      mStatNewInTicks += newCount;
+      LOG << "Tick " << mStatTicks << " called global operator new " << newCount << " times";
+    } // if
+#endif
 
-    if( !mPlayerEntryInProgress && 0u < mQuickDeathTicksLeft )
-      --mQuickDeathTicksLeft;
-                        // Sudden death period after player spawn or respawn is counted down
+    mTickArena.Reset(); // Transient working sets of all processors are released at once
 
     return true;
 
@@ -455,6 +515,145 @@ namespace Inv
 
   //-------------------------------------------------------------------------------------------------
 
+  void CInvGameScene::ScheduleProcessors()
+  {
+    mEnTTRegistry.storage<cpId>();
+    mEnTTRegistry.storage<cpPosition>();
+    mEnTTRegistry.storage<cpVelocity>();
+    mEnTTRegistry.storage<cpGeometry>();
+    mEnTTRegistry.storage<cpAlienBehave>();
+    mEnTTRegistry.storage<cpAlienStatus>();
+    mEnTTRegistry.storage<cpFormationSlot>();
+    mEnTTRegistry.storage<cpInFormation>();
+    mEnTTRegistry.storage<cpAlienBossStatus>();
+    mEnTTRegistry.storage<cpPlayBehave>();
+    mEnTTRegistry.storage<cpPlayStatus>();
+    mEnTTRegistry.storage<cpHealth>();
+    mEnTTRegistry.storage<cpDamage>();
+    mEnTTRegistry.storage<cpCollisionLayer>();
+    mEnTTRegistry.storage<cpCollisionMask>();
+    mEnTTRegistry.storage<cpCollisionMotion>();
+    mEnTTRegistry.storage<cpGraphics>();
+    mEnTTRegistry.storage<cpFxAnimation>();
+    mEnTTRegistry.storage<cpFxBlink>();
+    mEnTTRegistry.storage<cpFxShrink>();
+    mEnTTRegistry.storage<cpFxMirror>();
+    mEnTTRegistry.storage<cpPendingDestroy>();
+                        // Storages of all components are created in advance, so that views created
+                        // concurrently by processors never add new storage into the registry
+
+    mProcActorMover.mScheduler = &mScheduler;
+    mProcAlienRaidDriver.mScheduler = &mScheduler;
+    mProcCollisionDetector.mScheduler = &mScheduler;
+                        // Large loops of these processors are split into chunks processed by the
+                        // thread pool of the scheduler. State selector stays on single thread, its
+                        // random draws must come in the same order regardless of number of threads.
+
+    mProcGarbageCollector.mArena = &mTickArena;
+    mProcCollisionDetector.mArena = &mTickArena;
+    mProcActorRender.mArena = &mTickArena;
+                        // Working sets of these processors live in the tick arena. Garbage collector
+                        // runs exclusively (it writes rsEntities), the others after the scheduler.
+
+    mScheduler.AddTask<rsEntities, cpId, cpPendingDestroy>( "GarbageCollector", [this]()
+    {                   // Removes entities marked as inactive from the registry, noticing
+                        // main scene class if demanded.
+      mProcGarbageCollector.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint );
+    } );
+
+    mScheduler.AddTask<rsEntities, rsRandom, const rsDangerArea, const rsAlienGroup,
+      const cpAlienBehave, cpAlienStatus, cpPosition, cpInFormation, cpGraphics, cpFxAnimation>(
+      "ActorStateSelector", [this]()
+    {                   // All entities are checked for state changes (firing, raid, etc.) according
+                        // to their behavior component and random events.
+      mProcActorStateSelector.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint, mQuickDeathTicksLeft );
+    } );
+
+    mScheduler.AddTask<const rsEntities, cpAlienStatus, const cpGraphics>( "EntitySpawner", [this]()
+    {                   // New entities are spawned according to spawn requests stored in the
+                        // registry by other processors (as missiles, for example). They are only
+                        // recorded to command buffer of the processor, see CommandsApply.
+      mProcEntitySpawner.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint );
+    } );
+
+    mScheduler.AddTask<rsEntities, rsRandom, const rsPlayerPosition>( "SpecialActorSpawner", [this]()
+    {                   // Special entities (as alien boss) are spawned according to special
+                        // spawn requests stored in the registry by other processors.
+      mProcSpecialActorSpawner.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint, mPlayerActY, mQuickDeathTicksLeft );
+    } );
+
+    mScheduler.AddTask<const rsEntities, const cpPlayBehave, const cpPlayStatus, cpVelocity>(
+      "PlayerSpeedUpdater", [this]()
+    {                   // Player velocity is updated according to control state (keyboard)
+      mProcPlayerSpeedUpdater.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint, mControlState, mControlValue );
+    } );
+
+    mScheduler.AddTask<const rsEntities, cpPlayStatus, const cpGraphics>( "PlayerFireUpdater", [this]()
+    {                   // Player shoot requests are processed, new missiles are recorded if possible
+      mProcPlayerFireUpdater.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint, mControlState, mControlValue );
+    } );
+
+    mScheduler.AddTask<rsEntities>( "CommandsApply", [this]()
+    {                   // Sync point - entities recorded by spawners are created, always in the same
+                        // order, so the result does not depend on which thread ran which spawner.
+      mProcEntitySpawner.mCommands.Apply( mEnTTRegistry );
+      mProcPlayerFireUpdater.mCommands.Apply( mEnTTRegistry );
+    } );
+
+    mScheduler.AddTask<const rsEntities, rsPlayerPosition,
+      const cpPlayBehave, const cpPlayStatus, const cpPosition, cpVelocity, const cpGeometry>(
+      "PlayerBoundsGuard", [this]()
+    {                   // Player entity is kept within scene bounds
+      mProcPlayerBoundsGuard.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint );
+    } );
+
+    mScheduler.AddTask<const rsEntities, rsDangerArea, const rsAlienGroup,
+      const cpPlayBehave, const cpPlayStatus, const cpPosition>(
+      "PlayerInDanger", [this]()
+    {                   // Player is marked as being in dangerous area (above alien formation)
+      mProcPlayerInDanger.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint );
+    } );
+
+    mScheduler.AddTask<const rsEntities, rsAlienGroup>( "AlienBoundsGuard", [this]()
+    {                   // Alien entities are kept within scene bounds, alien group velocity is
+                        // changed if needed. When first alien reaches left or right scene border,
+                        // whole alien group is moved down for a few moment ant then starts moving in
+                        // X-axis in opposite direction.
+      mProcAlienBoundsGuard.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint, mPlayerHeight * 1.25f );
+    } );
+
+    mScheduler.AddTask<const rsEntities, rsAlienGroup, rsOutOfScene,
+      const cpAlienStatus, const cpInFormation, cpPosition, const cpVelocity, const cpGeometry>(
+      "ActorMover", [this]()
+    {                   // All entities are moved according to their velocity, alien formation as
+                        // a whole by its displacement. Entities out of scene are found.
+      mProcActorMover.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint );
+    } );
+
+    mScheduler.AddTask<rsEntities, const rsAlienGroup, const cpAlienBehave, cpAlienStatus, cpPosition, cpVelocity>(
+      "AlienRaidDriver", [this]()
+    {                   // Raiding or returning aliens have their velocity adjusted
+      mProcAlienRaidDriver.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint, mQuickDeathTicksLeft );
+    } );
+
+    mScheduler.AddTask<rsEntities, rsOutOfScene, cpId, cpPendingDestroy>( "ActorOutOfSceneCheck", [this]()
+    {                   // Entities found out of scene by mover are marked as inactive and will be removed
+                        // by garbage collector in next loop.
+      mProcActorOutOfSceneCheck.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint );
+    } );
+
+    mScheduler.AddTask<rsEntities, const rsAlienGroup,
+      cpGraphics, cpFxAnimation, cpFxBlink, cpFxShrink, const cpFxMirror>( "ActorAnimator", [this]()
+    {                   // Effects are applied on sprites of all entities (animations, dying effects,
+                        // event callbacks), resulting geometry is used by collision detector. This
+                        // is part of simulation, it does not depend on rendering.
+      mProcActorAnimator.update( mEnTTRegistry, mActualTickPoint, mDiffTickPoint );
+    } );
+
+  } // CInvGameScene::ScheduleProcessors
+
+  //-------------------------------------------------------------------------------------------------
+
   bool CInvGameScene::PlayerEntryProcessing( LARGE_INTEGER actTick )
   {
     if( !mPlayerEntryInProgress )
@@ -478,9 +677,10 @@ namespace Inv
                         // control his ship (which is not visible at all).
 
       auto view = mEnTTRegistry.view<cpPlayBehave, cpPlayStatus, cpGraphics>();
-      view.each( [=]( cpPlayBehave & pBehave, cpPlayStatus & pStat, cpGraphics & pGph )
+      view.each( [&]( entt::entity entity, cpPlayBehave & pBehave, cpPlayStatus & pStat, cpGraphics & pGph )
       {
           pGph.isHidden = true;
+          UpdateCollisionLayers( mEnTTRegistry, entity );
       } );
     } // if
 
@@ -522,12 +722,20 @@ namespace Inv
           mPlayerActX = mPlayerStartX;
           mPlayerActY = mPlayerStartY;
           pStatus->isInvulnerable = true;
-          pGph->standardAnimationEffect->Restore();
+          UpdateCollisionLayers( mEnTTRegistry, mPlayerEntity );
+          auto pBlink = mEnTTRegistry.try_get<cpFxBlink>( mPlayerEntity );
+          if( nullptr != pBlink )
+            RestoreEffect( *pBlink );
                         // Player is made invulnerable for a while, blinking effect is started on his sprite.
         } // if
       } // else
 
       mPlayerEntryInProgress = false;
+      mQuickDeathTimer = mTimers.Schedule( mQuickDeathTicks, [this]( TimerHandle_t )
+      {                 // Sudden death period after player spawn or respawn is counted down
+        mQuickDeathTicks = 0u;
+      } );
+
       if( IsZero( mVXGroup ) )
         mVXGroup = mSettingsRuntime.mAlienVelocity * mSettingsRuntime.mSceneLevelMultiplicator / (float)mSettings.GetTickPerSecond();
 
@@ -535,9 +743,10 @@ namespace Inv
                         // Aliens start moving and player can control his ship again.
 
       auto view = mEnTTRegistry.view<cpPlayBehave, cpPlayStatus, cpGraphics>();
-      view.each( [=]( cpPlayBehave & pBehave, cpPlayStatus & pStat, cpGraphics & pGph )
+      view.each( [&]( entt::entity entity, cpPlayBehave & pBehave, cpPlayStatus & pStat, cpGraphics & pGph )
       {                 // If (alive) player was hidden during entry sequence, he is made visible now.
         pGph.isHidden = false;
+        UpdateCollisionLayers( mEnTTRegistry, entity );
       } );
 
     } // else
@@ -569,6 +778,16 @@ namespace Inv
     mTickReferencePoint = newTickRefPoint;
     mEnTTRegistry.clear();
 
+    mEntityFactory.ClearPools();
+    mEntityFactory.PrepareMissilePool( "ROCKET", mSettings.GetAmmo() );
+    mEntityFactory.PrepareMissilePool( "SPIT", CInvEntityFactory::mMissilePoolSize );
+    mEntityFactory.PrepareExplosionPool( "FIGHTEXPL", 1 );
+    mEntityFactory.PrepareExplosionPool( "PINKEXPL", CInvEntityFactory::mExplosionPoolSize );
+    for( auto & boss : mAlienBosses )
+      mEntityFactory.PrepareExplosionPool( boss.second.mSpriteId + "EXPL", boss.second.mMaxSpawned );
+                        // Missiles and explosions are built in advance, while the game runs they
+                        // are parked and reused instead of being destroyed and created again
+
     mActualScore = 0;
     mPlayerAlive = false;
                         // Score is zeroed, player is not alive (not spawned) yet.
@@ -578,7 +797,8 @@ namespace Inv
                         // Player lives and ammo are reset to initial values.
 
     mReloadingTicks = (LONGLONG)( (float)mSettings.GetTickPerSecond() * mSettings.GetReloadTime() );
-    mTickLeftToReload = mReloadingTicks;
+    mTimers.Clear();    // Entities the countdowns belong to were removed
+    ScheduleReload();
                         // Player weapon reloading time is set according to settings.
 
     CalculateSuddenDeathTicks();
@@ -614,15 +834,17 @@ namespace Inv
       mSceneTopLeftX, mSceneTopLeftY,
       mSceneBottomRightX, mSceneBottomRightY );
 
-    mProcActorMover.reset( newTickRefPoint );
-
-    mProcAlienRaidDriver.reset( newTickRefPoint );
-
-    mProcActorOutOfSceneCheck.reset(
+    mProcActorMover.reset(
       newTickRefPoint,
       mSceneTopLeftX, mSceneTopLeftY,
       mSceneBottomRightX, mSceneBottomRightY );
 
+    mProcAlienRaidDriver.reset( newTickRefPoint );
+
+    mProcActorOutOfSceneCheck.reset( newTickRefPoint );
+
+    mProcActorAnimator.reset( newTickRefPoint );
+
     mProcActorRender.reset( newTickRefPoint );
 
     mProcCollisionDetector.reset( newTickRefPoint );
@@ -664,6 +886,7 @@ namespace Inv
 
       playStatus->isDying = true;
                         // Welcome to the scrapyard, pal ...
+      UpdateCollisionLayers( mEnTTRegistry, entity );
 
       auto [ pPos, pVel, pGeo] = mEnTTRegistry.try_get<cpPosition, cpVelocity, cpGeometry>( entity );
 
@@ -674,18 +897,19 @@ namespace Inv
         pVel->vZ = 0.0f;
       }  // if
 
-      auto explosionSize = ( nullptr == pGeo ? 150.0f : playGph->standardSprite->GetResultingSizeX() * 1.5f );
+      auto explosionSize = ( nullptr == pGeo ? 150.0f : playGph->standardSprite.GetResultingSizeX() * 1.5f );
       auto xplX = ( nullptr == pPos ? 0.0f : pPos->X );
       auto xplY = ( nullptr == pPos ? 0.0f : pPos->Y );
       auto xplVx = ( nullptr == pVel ? 0.0f : pVel->vX );
       auto xplVy = ( nullptr == pVel ? 0.0f : pVel->vY );
-      mEntityFactory.AddExplosionEntity( "FIGHTEXPL", xplX, xplY, explosionSize, xplVx, xplVy );
+      mEntityFactory.AddExplosionEntity( mCommands, "FIGHTEXPL", xplX, xplY, explosionSize, xplVx, xplVy );
       mSoundStorage.PlaySound( "FIGHTEXPL" );
                         // Explosion is created at player position, moving with the player. Explosion entity
                         // is automatically pruned from game scene when its animation finishes.
 
-      if( nullptr != playGph && nullptr != playGph->dyingAnimationEffect )
-        playGph->dyingAnimationEffect->Restore();
+      auto playShrink = mEnTTRegistry.try_get<cpFxShrink>( entity );
+      if( nullptr != playShrink )
+        RestoreEffect( *playShrink );
                         // Dying effect is started on player sprite. When the effect finishes, player entity
                         // is marked for pruning and removed from game scene by garbage collector. This
                         // then triggers EntityJustPruned() method, which notifies main game scene about
@@ -716,8 +940,19 @@ namespace Inv
 
       alienStatus->isDying = true;
                         // Welcome to the graveard, bastard ...
+      UpdateCollisionLayers( mEnTTRegistry, entity );
+
+      auto alienSlot = mEnTTRegistry.try_get<cpFormationSlot>( entity );
+      if( nullptr != alienSlot )
+        mFormationIndex.RemoveMember( alienSlot->row, alienSlot->column );
+                        // Place of the alien in formation no longer counts to formation extents
 
       auto [ pPos, pVel, pGeo] = mEnTTRegistry.try_get<cpPosition, cpVelocity, cpGeometry>( entity );
+      if( nullptr != pPos && mEnTTRegistry.all_of<cpInFormation>( entity ) )
+      {                 // Position of alien in formation is not maintained, it is derived now
+        pPos->X = alienBehave->startingX + mFormationIndex.GetDisplacementX();
+        pPos->Y = alienBehave->startingY + mFormationIndex.GetDisplacementY();
+      } // if
 
       if( mSettings.GetZeroExplosionV() )
       {                 // If demanded, destroyed alien stops and explosion does not inherit his velocity.
@@ -726,18 +961,19 @@ namespace Inv
         pVel->vZ = 0.0f;
       }  // if
 
-      auto explosionSize = ( nullptr == pGeo ? 150.0f : alienGph->standardSprite->GetResultingSizeX() * 1.5f );
+      auto explosionSize = ( nullptr == pGeo ? 150.0f : alienGph->standardSprite.GetResultingSizeX() * 1.5f );
       auto xplX = ( nullptr == pPos ? 0.0f : pPos->X );
       auto xplY = ( nullptr == pPos ? 0.0f : pPos->Y );
       auto xplVx = ( nullptr == pVel ? 0.0f : pVel->vX );
       auto xplVy = ( nullptr == pVel ? 0.0f : pVel->vY );
-      mEntityFactory.AddExplosionEntity( "PINKEXPL", xplX, xplY, explosionSize, xplVx, xplVy );
+      mEntityFactory.AddExplosionEntity( mCommands, "PINKEXPL", xplX, xplY, explosionSize, xplVx, xplVy );
       mSoundStorage.PlaySound( "PINKEXPL" );
                         // Explosion is created at alien position, moving with the invader. Explosion entity
                         // is automatically pruned from game scene when its animation finishes.
 
-      if( nullptr != alienGph && nullptr != alienGph->dyingAnimationEffect )
-        alienGph->dyingAnimationEffect->Restore();
+      auto alienShrink = mEnTTRegistry.try_get<cpFxShrink>( entity );
+      if( nullptr != alienShrink )
+        RestoreEffect( *alienShrink );
                         // Dying effect is started on invader sprite. When the effect finishes, entity
                         // is marked for pruning and removed from game scene by garbage collector. This
                         // then triggers EntityJustPruned() method, which notifies main game scene about
@@ -767,6 +1003,7 @@ namespace Inv
 
       alienBossStatus->isDying = true;
                         // Aaaaaand ... stardust!
+      UpdateCollisionLayers( mEnTTRegistry, entity );
 
       auto [pPos, pVel, pGeo] = mEnTTRegistry.try_get<cpPosition, cpVelocity, cpGeometry>( entity );
 
@@ -782,12 +1019,12 @@ namespace Inv
       {                 // Explosion is created at alien position, moving with the invader.
                         // Explosion entity is automatically pruned from game scene when its
                         // animation finishes.
-        auto explosionSize = ( nullptr == pGeo ? 150.0f : alienGph->standardSprite->GetResultingSizeX() * 1.5f );
+        auto explosionSize = ( nullptr == pGeo ? 150.0f : alienGph->standardSprite.GetResultingSizeX() * 1.5f );
         auto xplX = ( nullptr == pPos ? 0.0f : pPos->X );
         auto xplY = ( nullptr == pPos ? 0.0f : pPos->Y );
         auto xplVx = ( nullptr == pVel ? 0.0f : pVel->vX );
         auto xplVy = ( nullptr == pVel ? 0.0f : pVel->vY );
-        mEntityFactory.AddExplosionEntity(
+        mEntityFactory.AddExplosionEntity( mCommands,
           findBoss->second.mSpriteId + "EXPL", xplX, xplY, explosionSize, xplVx, xplVy );
         mSoundStorage.PlaySound( findBoss->second.mSpriteId + "EXPL" );
                         // Boss boss explosion is accompanied by appropriate sound (running sound
@@ -795,8 +1032,9 @@ namespace Inv
 
       } // if
 
-      if( nullptr != alienBossGph && nullptr != alienBossGph->dyingAnimationEffect )
-        alienBossGph->dyingAnimationEffect->Restore();
+      auto alienBossShrink = mEnTTRegistry.try_get<cpFxShrink>( entity );
+      if( nullptr != alienBossShrink )
+        RestoreEffect( *alienBossShrink );
                         // Dying effect is started on invader sprite. When the effect finishes,
                         // entity is marked for pruning and removed from game scene by garbage
                         // collector. This then triggers EntityJustPruned() method, which notifies
@@ -852,8 +1090,15 @@ namespace Inv
                         // If alien was killed during raid, player gets extra points.
 
       mActualScore += deltaScore;
+      mTimers.Cancel( aStatus->raidTimer );
       mSettingsRuntime.mAlienSpeedupFactor += mSettings.GetSpeedupPerKill();
 
+      auto aSlot = mEnTTRegistry.try_get<cpFormationSlot>( entity );
+      if( nullptr != aSlot && ! aStatus->isDying )
+        mFormationIndex.RemoveMember( aSlot->row, aSlot->column );
+                        // Alien left the scene without being shot, its place in formation is
+                        // released now (dying alien released it already)
+
       LOG << "Alien was pruned from game scene, " << deltaScore
           << " points added, speed upscaled to " << mSettingsRuntime.mAlienSpeedupFactor;
 
@@ -922,6 +1167,26 @@ namespace Inv
 
   //-------------------------------------------------------------------------------------------------
 
+  void CInvGameScene::FormationStayingBegins( entt::registry & reg, entt::entity entity )
+  {
+    auto [ slot, status ] = reg.try_get<cpFormationSlot, cpAlienStatus>( entity );
+    if( nullptr != slot && nullptr != status && ! status->isDying && reg.all_of<cpInFormation>( entity ) )
+      mFormationIndex.SetStaying( slot->row, slot->column, true );
+
+  } // CInvGameScene::FormationStayingBegins
+
+  //-------------------------------------------------------------------------------------------------
+
+  void CInvGameScene::FormationStayingEnds( entt::registry & reg, entt::entity entity )
+  {
+    auto slot = reg.try_get<cpFormationSlot>( entity );
+    if( nullptr != slot )
+      mFormationIndex.SetStaying( slot->row, slot->column, false );
+
+  } // CInvGameScene::FormationStayingEnds
+
+  //-------------------------------------------------------------------------------------------------
+
   void CInvGameScene::NewSwarm()
   {
 
@@ -931,16 +1196,17 @@ namespace Inv
     mPlayerEntryTick.QuadPart = 0;
 
     auto viewP = mEnTTRegistry.view<cpPlayBehave, cpPlayStatus, cpGraphics>();
-    viewP.each( [=]( cpPlayBehave & pBehave, cpPlayStatus & pStat, cpGraphics & pGph )
+    viewP.each( [&]( entt::entity e, cpPlayBehave & pBehave, cpPlayStatus & pStat, cpGraphics & pGph )
     {                   // Player must be hidden during new swarm generation sequence,
                         // because new aliens are placed in the scene and if the player
                         // is alive, he could be hit by them immediately. Player ship
                         // is made visible again by PlayerEntryProcessing() method.
       pGph.isHidden = true;
+      UpdateCollisionLayers( mEnTTRegistry, e );
     } );
 
-    auto viewE = mEnTTRegistry.view<cpId, cpDamage>();
-    viewE.each( [=]( entt::entity e, cpId & eId, cpDamage & dmg )
+    auto viewE = mEnTTRegistry.view<cpId, cpDamage>( entt::exclude<cpParked> );
+    viewE.each( [&]( entt::entity e, cpId & eId, cpDamage & dmg )
     {                   // All missiles currently in the scene are removed, as they have no target
                         // to hit anymore in current swarm - and we do not want to have them flying
                         // around while new swarm is being generated.
@@ -956,7 +1222,7 @@ namespace Inv
       if( nullptr != pStat )
         return;
 
-      eId.active = false;
+      DeactivateEntity( mEnTTRegistry, e );
     } );
 
     GenerateNewScene();
@@ -990,14 +1256,30 @@ namespace Inv
     mLastPipBeeped = UINT32_MAX;
                         // Sudden death sound warning is resetted
 
-    mQuickDeathTicksLeft =
+    mTimers.Cancel( mQuickDeathTimer );
+    mQuickDeathTimer = gNoTimer;
+    mQuickDeathTicks =
       (uint32_t)( quickDeathTime * (uint32_t)mSettings.GetTickPerSecond() );
-                        // Sudden death time ticks is set.
+    mQuickDeathTicksLeft = mQuickDeathTicks;
+                        // Sudden death time ticks is set, countdown starts when player entry
+                        // sequence finishes.
 
   } // CInvGameScene::CalculateSuddenDeathTicks
 
   //-------------------------------------------------------------------------------------------------
 
+  void CInvGameScene::ScheduleReload()
+  {
+    mReloadTimer = mTimers.Schedule( (uint64_t)mReloadingTicks + 1u, [this]( TimerHandle_t )
+    {                   // Player weapon is reloaded and ready to fire again
+      if( mPlayerAmmoLeft < mSettings.GetAmmo() )
+        ++mPlayerAmmoLeft;
+      ScheduleReload();
+    } );
+  } // CInvGameScene::ScheduleReload
+
+  //-------------------------------------------------------------------------------------------------
+
   bool CInvGameScene::RenderStatusBar( LARGE_INTEGER actualTickPoint )
   {
     float topLine = mStatusLineTopLeftY * 1.04f;
@@ -1054,9 +1336,7 @@ namespace Inv
 
   void CInvGameScene::CallbackUnsetActive( entt::entity ent, uint32_t nr )
   {
-    auto pId = mEnTTRegistry.try_get<cpId>( ent );
-    if( nullptr != pId )
-      pId->active = false;
+    DeactivateEntity( mEnTTRegistry, ent );
   } // CInvGameScene::CallbackUnsetActive
 
   //-------------------------------------------------------------------------------------------------
@@ -1065,7 +1345,10 @@ namespace Inv
   {
     auto pStat = mEnTTRegistry.try_get<cpPlayStatus>( ent );
     if( nullptr != pStat )
+    {
       pStat->isInvulnerable = false;
+      UpdateCollisionLayers( mEnTTRegistry, ent );
+    } // if
   } // CInvGameScene::CallbackPlayerInvulnerabilityCanceled
 
   //-------------------------------------------------------------------------------------------------
@@ -1074,7 +1357,10 @@ namespace Inv
   {
     auto aStat = mEnTTRegistry.try_get<cpAlienStatus>( ent );
     if( nullptr != aStat )
+    {
       aStat->isAnimating = false;
+      mProcActorStateSelector.actionFinished( ent );
+    } // if
   } // CInvGameScene::CallbackAlienAnimationDone
 
   //-------------------------------------------------------------------------------------------------
@@ -1083,7 +1369,10 @@ namespace Inv
   {
     auto aStat = mEnTTRegistry.try_get<cpAlienStatus>( ent );
     if( nullptr != aStat )
+    {
       aStat->isFiring = false;
+      mProcActorStateSelector.actionFinished( ent );
+    } // if
 
   } // CInvGameScene::CallbackAlienFiringDone
 
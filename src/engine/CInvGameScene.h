@@ -11,7 +11,7 @@
 #ifndef H_CInvGameScene
 #define H_CInvGameScene
 
-#include <d3d9.h>
+#include <graphics/InvD3D9.h>
 
 #include <CInvSettings.h>
 #include <CInvSettingsRuntime.h>
@@ -27,6 +27,10 @@
 #include <graphics/CInvEffectSpriteBlink.h>
 
 #include <engine/CInvEntityFactory.h>
+#include <engine/CInvFormationIndex.h>
+#include <engine/CInvProcessorScheduler.h>
+#include <engine/CInvTickArena.h>
+#include <engine/CInvTimerWheel.h>
 #include <engine/InvENTTProcessors.h>
 #include <engine/InvENTTProcessorsAI.h>
 
@@ -142,12 +146,29 @@ namespace Inv
          registry. If the pruned entity is the player, appropriate measures are taken (chain of
          events that leads respawn, reduce number of lives, end of game etc. is initiated) */
 
+    void FormationStayingBegins( entt::registry & reg, entt::entity entity );
+    /*!< \brief Signal handler called when alien gets its formation slot or formation tag, alien
+         is marked as staying in formation lattice if it has both and is not dying. */
+
+    void FormationStayingEnds( entt::registry & reg, entt::entity entity );
+    /*!< \brief Signal handler called when alien loses formation tag (leaves for raid) or slot
+         (is destroyed), alien is no longer marked as staying in formation lattice. */
+
     void NewSwarm();
     /*!< \brief Generates new alien swarm, increases level counter and speedup factor. It is called
          when all aliens are destroyed. */
 
     void CalculateSuddenDeathTicks();
 
+    void ScheduleReload();
+    /*!< \brief Schedules timer adding one ammo to the player after reloading time, the timer
+         schedules itself again when it fires. */
+
+    void ScheduleProcessors();
+    /*!< \brief Registers simulation processors in the scheduler, together with the resources each
+         of them reads and writes. Processors are registered in the order in which they used to be
+         called, conflicting ones keep this order. */
+
     //------ Timing parameters --------------------------------------------------------------------------
 
     LARGE_INTEGER mTickReferencePoint;
@@ -157,6 +178,15 @@ namespace Inv
     //!<\brief Dummy tick difference, usually zero. It used for satisfying of arbitrary diff tick
     //!  parameter in some methods.
 
+    LARGE_INTEGER mActualTickPoint;
+    //!< \brief Tick point of the tick being simulated, passed to scheduled processors
+
+    ControlStateFlags_t mControlState;
+    //!< \brief Control state of the tick being simulated, passed to scheduled processors
+
+    ControlValue_t mControlValue;
+    //!< \brief Control value of the tick being simulated, passed to scheduled processors
+
     //------ References to superior global objects (DI) and owned general objects ----------------------
 
     const CInvSettings & mSettings;
@@ -338,8 +368,8 @@ namespace Inv
     LONGLONG mReloadingTicks;
     //<! \brief Number of ticks needed to reload player weapon after firing.
 
-    LONGLONG mTickLeftToReload;
-    //<! \brief Number of ticks left to reload player weapon after firing.
+    TimerHandle_t mReloadTimer;
+    //<! \brief Timer of player weapon reloading, see ScheduleReload().
 
     CInvText mScoreLabel;
     //<! \brief Text object for "SCORE" label in status line
@@ -356,8 +386,16 @@ namespace Inv
     bool mIsInDangerousArea;
     //<! \brief Flag indicating whether player is in dangerous area (above all aliens)
 
+    uint32_t mQuickDeathTicks;
+    //<! \brief Number of ticks of sudden death countdown when it is not running (during player
+    //!  entry sequence), zero when the countdown expired.
+
+    TimerHandle_t mQuickDeathTimer;
+    //<! \brief Timer of sudden death countdown, started when player entry sequence finishes.
+
     uint32_t mQuickDeathTicksLeft;
-    //<! \brief Number of ticks left to initiate sudden death mode
+    //<! \brief Number of ticks left to initiate sudden death mode, taken from the countdown at
+    //!  the beginning of every tick (processors read it concurrently).
 
     //------ Alien global state -----------------------------------------------------------------------
 
@@ -379,6 +417,36 @@ namespace Inv
     uint32_t mLastPipBeeped;
     //!< \brief Last number of seconds to sudden death when "pip" sound was played.
 
+    CInvTimerWheel mTimers;
+    //!< \brief All countdowns of the simulation (player weapon reloading, sudden death, alien
+    //!  raids) fire their callbacks from here, the wheel is advanced at the end of every tick.
+
+    CInvFormationIndex mFormationIndex;
+    //!< \brief Lattice of alien formation slots, built when new swarm is generated. Used by
+    //!  collision detector to find aliens in formation quickly.
+
+    CInvCommandBuffer mCommands;
+    //!< \brief Structural changes of registry requested by the scene itself while handling collisions
+    //!  (explosions), applied when all collisions are handled.
+
+    std::vector<entt::entity> mOutOfSceneEntities;
+    //!< \brief Entities found out of scene by mover in actual tick, marked as inactive later.
+
+    CInvTickArena mTickArena;
+    //!< \brief Memory of transient working sets of processors (sorted sprites, collided pairs),
+    //!  released at once at the end of every tick.
+
+    uint64_t mStatTicks;
+    //!< \brief Number of ticks processed (since start), counted in debug build only
+
+    uint64_t mStatTicksWithNew;
+    //!< \brief Number of ticks in which global operator new was called (since start), counted in
+    //!  debug build only
+
+    uint64_t mStatNewInTicks;
+    //!< \brief Number of calls of global operator new made inside ticks (since start), counted in
+    //!  debug build only
+
     //------ EnTT processors --------------------------------------------------------------------------
 
     procGarbageCollector mProcGarbageCollector;
@@ -393,9 +461,14 @@ namespace Inv
     procActorMover mProcActorMover;
     procAlienRaidDriver mProcAlienRaidDriver;
     procActorOutOfSceneCheck mProcActorOutOfSceneCheck;
+    procActorAnimator mProcActorAnimator;
     procCollisionDetector mProcCollisionDetector;
     procActorRender mProcActorRender;
 
+    CInvProcessorScheduler mScheduler;
+    //!< \brief Runs simulation processors according to their dependencies, it must be destroyed
+    //!  (worker threads joined) before the processors
+
   };
 
 } // namespace Inv
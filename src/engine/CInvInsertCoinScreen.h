@@ -10,7 +10,7 @@
 #ifndef H_CInvInsertCoinScreen
 #define H_CInvInsertCoinScreen
 
-#include <d3d9.h>
+#include <graphics/InvD3D9.h>
 //#include <d3dx9.h>
 
 #include <InvGlobals.h>
@@ -0,0 +1,141 @@
+//****************************************************************************************************
+//! \file CInvPairCache.cpp
+//! Module defines class CInvPairCache, flat hash table of pairs of entities which cannot collide
+//! for some ticks.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <algorithm>
+#include <bit>
+
+#include <engine/CInvPairCache.h>
+
+namespace Inv
+{
+  CInvPairCache::CInvPairCache( size_t capacity ):
+    mKeys( std::bit_ceil( max( capacity, (size_t)2 ) ), mEmptyKey ),
+    mEntries( mKeys.size() ),
+    mSlotMask( mKeys.size() - 1 ),
+    mShift( 64u - (uint32_t)std::countr_zero( mKeys.size() ) ),
+    mSize( 0 ),
+    mMaxSize( mKeys.size() / 2 ),
+    mStatRefused( 0 )
+  {}
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvPairCache::~CInvPairCache() = default;
+
+  //----------------------------------------------------------------------------------------------
+
+  size_t CInvPairCache::FindSlot( uint64_t key ) const
+  {
+    for( size_t slot = HomeSlot( key ); ; slot = ( slot + 1 ) & mSlotMask )
+    {                   // Table is never full, so the probe sequence always ends by empty slot
+      if( mKeys[slot] == key )
+        return slot;
+      if( mKeys[slot] == mEmptyKey )
+        return SIZE_MAX;
+    } // for
+
+  } // CInvPairCache::FindSlot
+
+  //----------------------------------------------------------------------------------------------
+
+  const CInvPairCache::Entry_t * CInvPairCache::Find( uint64_t key ) const
+  {
+    size_t slot = FindSlot( key );
+    return ( SIZE_MAX == slot ) ? nullptr : &mEntries[slot];
+
+  } // CInvPairCache::Find
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvPairCache::Store( uint64_t key, const Entry_t & entry )
+  {
+    size_t slot = HomeSlot( key );
+    for( ; mKeys[slot] != mEmptyKey; slot = ( slot + 1 ) & mSlotMask )
+    {
+      if( mKeys[slot] == key )
+      {
+        mEntries[slot] = entry;
+        return true;    // Pair is cached already, its entry is replaced
+      } // if
+    } // for
+
+    if( mMaxSize <= mSize )
+    {
+      ++mStatRefused;
+      return false;
+    } // if
+
+    mKeys[slot] = key;
+    mEntries[slot] = entry;
+    ++mSize;
+    return true;
+
+  } // CInvPairCache::Store
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvPairCache::Erase( uint64_t key )
+  {
+    size_t slot = FindSlot( key );
+    if( SIZE_MAX != slot )
+      EraseSlot( slot );
+
+  } // CInvPairCache::Erase
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvPairCache::EraseSlot( size_t slot )
+  {
+    size_t next = slot;
+    while( true )
+    {
+      next = ( next + 1 ) & mSlotMask;
+      if( mKeys[next] == mEmptyKey )
+        break;
+
+      size_t home = HomeSlot( mKeys[next] );
+      if( ( ( next - home ) & mSlotMask ) < ( ( next - slot ) & mSlotMask ) )
+        continue;       // Entry lies between its home slot and the emptied one, it stays
+
+      mKeys[slot] = mKeys[next];
+      mEntries[slot] = mEntries[next];
+      slot = next;      // Entry is moved back to the emptied slot, its own slot is emptied then
+    } // while
+
+    mKeys[slot] = mEmptyKey;
+    --mSize;
+
+  } // CInvPairCache::EraseSlot
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvPairCache::EraseExpired( uint64_t tick )
+  {
+    for( size_t slot = 0; slot < mKeys.size() && 0 < mSize; )
+    {
+      if( mKeys[slot] != mEmptyKey && mEntries[slot].readyTick <= tick )
+        EraseSlot( slot );
+                        // Following entry may be shifted to this slot, it is examined again
+      else
+        ++slot;
+    } // for
+
+  } // CInvPairCache::EraseExpired
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvPairCache::Clear()
+  {
+    std::fill( mKeys.begin(), mKeys.end(), mEmptyKey );
+    mSize = 0;
+
+  } // CInvPairCache::Clear
+
+} // namespace Inv
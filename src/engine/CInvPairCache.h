@@ -0,0 +1,116 @@
+//****************************************************************************************************
+//! \file CInvPairCache.h
+//! Module declares class CInvPairCache, flat hash table of pairs of entities which cannot collide
+//! for some ticks.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvPairCache
+#define H_CInvPairCache
+
+#include <InvGlobals.h>
+
+namespace Inv
+{
+
+  /*! \brief Class represents table of pairs of entities (dangerous entity in upper 32 bits of the key,
+      vulnerable one in lower) which were near but not in contact, with the tick in which they
+      could touch at the earliest (see procCollisionDetector). Keys and entries are held in flat
+      arrays with open addressing (linear probing), the arrays are allocated when the table is
+      created and never grow, so no operation allocates memory during the game.
+
+      Table is filled at most to one half of its capacity. When it is full, new pairs are refused
+      and counted; refused pair is just tested in every tick, as if it was not cached at all. Erased
+      entries are removed by shifting following entries of the same probe sequence back, so the
+      table never contains tombstones and lookups stay short. */
+  class CInvPairCache
+  {
+  public:
+
+    using Entry_t = struct
+    {
+      uint32_t epochDanger;
+      uint32_t epochVulner;
+      uint64_t readyTick;
+    };
+    //!< \brief Cached pair: epochs of motion of both entities and the earliest tick of contact
+
+    CInvPairCache( size_t capacity = mDefaultCapacity );
+    /*!< \brief Allocates table with given number of slots (rounded up to power of two). */
+
+    CInvPairCache( const CInvPairCache & ) = delete;
+    CInvPairCache & operator=( const CInvPairCache & ) = delete;
+    ~CInvPairCache();
+
+    const Entry_t * Find( uint64_t key ) const;
+    /*!< \brief Returns entry of given pair, nullptr if the pair is not cached */
+
+    bool Store( uint64_t key, const Entry_t & entry );
+    /*!< \brief Stores (or replaces) entry of given pair. Returns false if the table is full and the
+         pair was refused. */
+
+    void Erase( uint64_t key );
+    /*!< \brief Removes given pair, nothing happens if the pair is not cached */
+
+    void EraseExpired( uint64_t tick );
+    /*!< \brief Removes all pairs which could touch in given tick or earlier */
+
+    void Clear();
+    /*!< \brief Removes all pairs, capacity is kept */
+
+    size_t GetSize() const { return mSize; }
+    /*!< \brief Returns number of cached pairs */
+
+    size_t GetCapacity() const { return mKeys.size(); }
+    /*!< \brief Returns number of slots of the table */
+
+    uint64_t GetRefusedCount() const { return mStatRefused; }
+    /*!< \brief Returns number of pairs refused because the table was full (since start) */
+
+    static constexpr size_t mDefaultCapacity = 4096;
+    //!< Default number of slots, table holds up to half of them
+
+  private:
+
+    size_t HomeSlot( uint64_t key ) const
+    { return (size_t)( ( key * 0x9E3779B97F4A7C15ull ) >> mShift ); }
+    //!< \brief Returns first slot of probe sequence of the key (Fibonacci hashing)
+
+    size_t FindSlot( uint64_t key ) const;
+    //!< \brief Returns slot holding the key, or SIZE_MAX if the key is not in the table
+
+    void EraseSlot( size_t slot );
+    //!< \brief Empties given slot and shifts following entries of the probe sequence back
+
+    static constexpr uint64_t mEmptyKey = UINT64_MAX;
+    //!< Key of empty slot, pair of two null entities never represents real pair
+
+    std::vector<uint64_t> mKeys;
+    //!< Keys of pairs, mEmptyKey in empty slots
+
+    std::vector<Entry_t> mEntries;
+    //!< Entries of pairs, valid in slots with key
+
+    size_t mSlotMask;
+    //!< Number of slots minus one, slots are indexed modulo the number of slots
+
+    uint32_t mShift;
+    //!< Shift of hashed key giving index of slot
+
+    size_t mSize;
+    //!< Number of cached pairs
+
+    size_t mMaxSize;
+    //!< Maximal number of cached pairs (half of the slots)
+
+    uint64_t mStatRefused;
+    //!< Number of pairs refused because the table was full (since start)
+
+  }; // class CInvPairCache
+
+} // namespace Inv
+
+#endif
@@ -11,7 +11,7 @@
 #ifndef H_CInvPlayItScreen
 #define H_CInvPlayItScreen
 
-#include <d3d9.h>
+#include <graphics/InvD3D9.h>
 //#include <d3dx9.h>
 
 #include <InvGlobals.h>
@@ -0,0 +1,230 @@
+//****************************************************************************************************
+//! \file CInvProcessorScheduler.cpp
+//! Module defines class CInvProcessorScheduler, which runs EnTT processors according to dependency
+//! graph of components they access, independent processors concurrently on pool of worker threads.
+//! Large loops inside of processors may be split into chunks processed by the same pool.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <algorithm>
+
+#include <engine/CInvProcessorScheduler.h>
+
+#include <CInvLogger.h>
+
+
+static const std::string lModLogId( "SCHEDULER" );
+
+namespace Inv
+{
+  CInvProcessorScheduler::CInvProcessorScheduler( uint32_t workerThreads ):
+    mTasks(),
+    mOrganizer(),
+    mGraph(),
+    mRegistry( nullptr ),
+    mWorkers(),
+    mMutex(),
+    mCondition(),
+    mReady(),
+    mPending(),
+    mRemaining( 0 ),
+    mJobs(),
+    mStop( false )
+  {
+    for( uint32_t i = 0; i < workerThreads; ++i )
+      mWorkers.emplace_back( &CInvProcessorScheduler::WorkLoop, this, true );
+  } // CInvProcessorScheduler::CInvProcessorScheduler
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvProcessorScheduler::~CInvProcessorScheduler()
+  {
+    {
+      std::lock_guard<std::mutex> lock( mMutex );
+      mStop = true;
+    }
+    mCondition.notify_all();
+
+    for( auto & worker : mWorkers )
+      worker.join();
+
+  } // CInvProcessorScheduler::~CInvProcessorScheduler
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvProcessorScheduler::BuildGraph()
+  {
+    mGraph = mOrganizer.graph();
+    mPending.assign( mGraph.size(), 0 );
+
+    LOG << "Processor graph built, " << mGraph.size() << " tasks, " << mWorkers.size() << " worker threads";
+    for( size_t i = 0; i < mGraph.size(); ++i )
+    {
+      std::string after;
+      for( auto from : mGraph[i].in_edges() )
+        after += std::string( " " ) + mGraph[from].name();
+
+      LOG << "  " << mGraph[i].name() << ( after.empty() ? " (top level)" : " after" + after );
+    } // for
+
+  } // CInvProcessorScheduler::BuildGraph
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvProcessorScheduler::Run( entt::registry & reg )
+  {
+    if( mGraph.size() != mTasks.size() )
+      BuildGraph();
+
+    if( mWorkers.empty() )
+    {                   // Order of registration is always valid order of the graph
+      for( auto & vertex : mGraph )
+        vertex.callback()( vertex.data(), reg );
+      return;
+    } // if
+
+    {
+      std::lock_guard<std::mutex> lock( mMutex );
+      mRegistry = &reg;
+      mReady.clear();
+      for( size_t i = 0; i < mGraph.size(); ++i )
+      {
+        mPending[i] = mGraph[i].in_edges().size();
+        if( 0 == mPending[i] )
+          mReady.push_back( i );
+      } // for
+      mRemaining = mGraph.size();
+    }
+    mCondition.notify_all();
+
+    WorkLoop( false );  // Calling thread helps the workers
+
+  } // CInvProcessorScheduler::Run
+
+  //----------------------------------------------------------------------------------------------
+
+  size_t CInvProcessorScheduler::GetChunkCount( size_t count, size_t minChunk ) const
+  {
+    minChunk = max( minChunk, (size_t)1 );
+    if( mWorkers.empty() || count < 2 * minChunk )
+      return 1;
+
+    return min( count / minChunk, GetMaxChunkCount() );
+
+  } // CInvProcessorScheduler::GetChunkCount
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvProcessorScheduler::ParallelFor( size_t count, size_t chunks, const FnChunk_t & fn )
+  {
+    if( 0 == count )
+      return;
+
+    if( chunks <= 1 || mWorkers.empty() )
+    {
+      fn( 0, 0, count );
+      return;
+    } // if
+
+    Job_t job{ &fn, count, min( chunks, count ), 0, 0 };
+    {
+      std::lock_guard<std::mutex> lock( mMutex );
+      mJobs.push_back( &job );
+    }
+    mCondition.notify_all();
+
+    RunChunks( job );   // Calling thread works as well, it is not blocked by anything
+
+    std::unique_lock<std::mutex> lock( mMutex );
+    auto it = std::find( mJobs.begin(), mJobs.end(), &job );
+    if( mJobs.end() != it )
+      mJobs.erase( it );
+                        // All chunks are claimed now, the ones taken by helpers are waited for
+    mCondition.wait( lock, [&]() { return 0 == job.helpers; } );
+
+  } // CInvProcessorScheduler::ParallelFor
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvProcessorScheduler::RunChunks( Job_t & job )
+  {
+    size_t chunk;
+    while( ( chunk = job.nextChunk.fetch_add( 1 ) ) < job.chunks )
+      ( *job.fn )( chunk, chunk * job.count / job.chunks, ( chunk + 1 ) * job.count / job.chunks );
+
+  } // CInvProcessorScheduler::RunChunks
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvProcessorScheduler::WorkLoop( bool isWorker )
+  {
+    std::unique_lock<std::mutex> lock( mMutex );
+    while( true )
+    {
+      mCondition.wait( lock, [&]()
+      {
+        return mStop || !mReady.empty() || !mJobs.empty() || ( !isWorker && 0 == mRemaining );
+      } );
+
+      if( mStop || ( !isWorker && 0 == mRemaining ) )
+        return;
+
+      if( !mJobs.empty() )
+      {                 // Chunks of loops are preferred, their owners wait for them
+        Job_t * job = mJobs.back();
+        if( job->chunks <= job->nextChunk.load() )
+        {               // Nothing left to claim, job must not be offered anymore
+          mJobs.pop_back();
+          continue;
+        } // if
+
+        ++job->helpers;
+        lock.unlock();
+        RunChunks( *job );
+        lock.lock();
+
+        if( 0 == --job->helpers )
+          mCondition.notify_all();
+        continue;
+      } // if
+
+      size_t index = mReady.back();
+      mReady.pop_back();
+      auto & vertex = mGraph[index];
+      auto reg = mRegistry;
+
+      lock.unlock();
+      vertex.callback()( vertex.data(), *reg );
+      lock.lock();
+
+      TaskFinished( index );
+    } // while
+
+  } // CInvProcessorScheduler::WorkLoop
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvProcessorScheduler::TaskFinished( size_t index )
+  {
+    bool notify = false;
+    for( auto to : mGraph[index].out_edges() )
+    {
+      if( 0 == --mPending[to] )
+      {
+        mReady.push_back( to );
+        notify = true;
+      } // if
+    } // for
+
+    if( 0 == --mRemaining )
+      notify = true;    // Calling thread waits for this
+
+    if( notify )
+      mCondition.notify_all();
+
+  } // CInvProcessorScheduler::TaskFinished
+
+} // namespace Inv
@@ -0,0 +1,183 @@
+//****************************************************************************************************
+//! \file CInvProcessorScheduler.h
+//! Module declares class CInvProcessorScheduler, which runs EnTT processors according to dependency
+//! graph of components they access, independent processors concurrently on pool of worker threads.
+//! Large loops inside of processors may be split into chunks processed by the same pool.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvProcessorScheduler
+#define H_CInvProcessorScheduler
+
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <entity/registry.hpp>
+#include <entity/organizer.hpp>
+
+#include <InvGlobals.h>
+
+namespace Inv
+{
+
+  /*! \brief Class runs tasks (usually update() methods of EnTT processors) once per tick. Every task
+      is registered with list of resources it reads (const types) and writes (non-const types);
+      resources are components, or tag types representing other shared state (see rsEntities and
+      others in InvENTTComponents.h). Registration is done through entt::organizer, which builds
+      graph of dependencies: task depends on all earlier registered tasks it is in conflict with (one
+      of them writes a resource the other one reads or writes). Order of conflicting tasks is thus the
+      same as order of registration, tasks without conflict may run concurrently.
+
+      If no worker thread is demanded, tasks are simply run one by one in order of registration on
+      the calling thread. Otherwise the calling thread and the workers pick ready tasks (those with all
+      dependencies done) from common queue until whole graph is finished. Result does not depend on
+      the number of threads, provided the declared resources are complete.
+
+      Any task may also split its own loop into chunks through ParallelFor(). Chunks are claimed one
+      by one by the calling thread and by all idle threads of the pool (those waiting for ready task),
+      so the load is balanced dynamically. Loops shorter than given minimal chunk are not split at all,
+      small scenes thus stay on single thread without any synchronization overhead. */
+  class CInvProcessorScheduler
+  {
+  public:
+
+    using FnTask_t = std::function<void()>;
+    //!< Type of task run by the scheduler
+
+    using FnChunk_t = std::function<void( size_t chunk, size_t begin, size_t end )>;
+    //!< Type of function processing one chunk of loop, i.e. items from \e begin to \e end - 1
+
+    CInvProcessorScheduler( uint32_t workerThreads );
+
+    CInvProcessorScheduler( const CInvProcessorScheduler & ) = delete;
+    CInvProcessorScheduler & operator=( const CInvProcessorScheduler & ) = delete;
+    ~CInvProcessorScheduler();
+
+    template<typename... Access>
+    void AddTask( const char * name, FnTask_t task )
+    {
+      mTasks.push_back( { std::move( task ) } );
+      mOrganizer.emplace<&Task_t::Execute, Access...>( mTasks.back(), name );
+      mGraph.clear();
+    } // AddTask
+    /*!< \brief Registers new task. Tasks must be registered in the order they would be run
+         sequentially.
+
+         \tparam    Access  Resources accessed by the task, const ones are only read
+         \param[in] name    Name of the task (for logging purposes)
+         \param[in] task    Task to be run */
+
+    void Run( entt::registry & reg );
+    /*!< \brief Runs all registered tasks once, returns when all of them are finished. Graph of
+         dependencies is built on first call. */
+
+    uint32_t GetWorkerThreads() const { return (uint32_t)mWorkers.size(); }
+    /*!< \brief Returns number of worker threads (the calling thread not included) */
+
+    size_t GetChunkCount( size_t count, size_t minChunk ) const;
+    /*!< \brief Returns number of chunks the loop of given length should be split into. It is 1 if
+         there are no workers or the loop is shorter than two minimal chunks, otherwise a few chunks
+         per thread, so that faster threads can take over work of slower ones.
+
+         \param[in] count     Number of items of the loop
+         \param[in] minChunk  Minimal number of items in one chunk */
+
+    size_t GetMaxChunkCount() const { return mWorkers.empty() ? 1 : ( mWorkers.size() + 1 ) * mChunksPerThread; }
+    /*!< \brief Returns the largest number of chunks GetChunkCount() may return, so that working data
+         of chunks can be prepared in advance */
+
+    void ParallelFor( size_t count, size_t chunks, const FnChunk_t & fn );
+    /*!< \brief Splits loop into given number of chunks of (nearly) the same size and processes them
+         concurrently, returns when all of them are finished. Chunk \e n always contains the same
+         items, so per-chunk partial results merged in order of chunks do not depend on threads.
+         May be called from a task run by the scheduler or from outside of Run().
+
+         \param[in] count   Number of items of the loop
+         \param[in] chunks  Number of chunks (see GetChunkCount())
+         \param[in] fn      Function processing one chunk */
+
+  private:
+
+    struct Task_t
+    {
+      FnTask_t task;
+      void Execute() { task(); }
+    };
+    //!< \brief Registered task, its address must remain stable (organizer keeps pointer to it).
+    //!  Named struct, because unnamed one cannot have member function used as organizer task.
+
+    void BuildGraph();
+    //!< \brief Builds dependency graph of registered tasks and logs it
+
+    struct Job_t
+    {
+      const FnChunk_t * fn;
+      size_t count;
+      size_t chunks;
+      std::atomic<size_t> nextChunk;
+      size_t helpers;
+    };
+    //!< \brief Loop split by ParallelFor(), chunks are claimed by incrementing \e nextChunk.
+    //!  Number of threads helping with the job is guarded by mMutex.
+
+    static void RunChunks( Job_t & job );
+    //!< \brief Processes chunks of the job until all of them are claimed
+
+    void WorkLoop( bool isWorker );
+    /*!< \brief Takes ready tasks from the queue and runs them, helps with chunks of pending loops.
+         Worker thread loops until the scheduler is destroyed, calling thread returns when whole
+         graph is finished. */
+
+    void TaskFinished( size_t index );
+    //!< \brief Marks task as finished and puts tasks depending on it into the queue if they are ready
+
+    std::deque<Task_t> mTasks;
+    //!< Registered tasks
+
+    entt::organizer mOrganizer;
+    //!< Organizer collecting tasks and their resources
+
+    std::vector<entt::organizer::vertex> mGraph;
+    //!< Dependency graph, vertex n belongs to task n
+
+    entt::registry * mRegistry;
+    //!< Registry passed to actual Run() call
+
+    std::vector<std::thread> mWorkers;
+    //!< Worker threads
+
+    std::mutex mMutex;
+    //!< Guards all members below
+
+    std::condition_variable mCondition;
+    //!< Signals new ready task, finished graph or stop request
+
+    std::vector<size_t> mReady;
+    //!< Indices of tasks ready to be run
+
+    std::vector<size_t> mPending;
+    //!< Number of unfinished dependencies of every task
+
+    size_t mRemaining;
+    //!< Number of unfinished tasks of actual run
+
+    std::vector<Job_t *> mJobs;
+    //!< Loops with chunks not yet claimed (owned by threads calling ParallelFor())
+
+    static constexpr size_t mChunksPerThread = 4;
+    //!< Number of chunks per thread the loop is split into
+
+    bool mStop;
+    //!< Request to finish worker threads
+
+  }; // class CInvProcessorScheduler
+
+} // namespace Inv
+
+#endif
@@ -0,0 +1,96 @@
+//****************************************************************************************************
+//! \file CInvSpatialHash.cpp
+//! Module defines class CInvSpatialHash, uniform grid used as broadphase of collision detection.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <engine/CInvSpatialHash.h>
+
+
+namespace Inv
+{
+  CInvSpatialHash::CInvSpatialHash():
+    mInvCellSize( 1.0f ),
+    mCells(),
+    mItemsCount( 0 )
+  {
+    mCells.reserve( mInitialCapacity );
+  } // CInvSpatialHash::CInvSpatialHash
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvSpatialHash::~CInvSpatialHash() = default;
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvSpatialHash::Clear( float cellSize )
+  {
+    mCells.clear();     // Vector keeps its capacity, so there is no allocation in next tick
+
+    mInvCellSize = ( 1.0f < cellSize ) ? 1.0f / cellSize : 1.0f;
+    mItemsCount = 0;
+
+  } // CInvSpatialHash::Clear
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvSpatialHash::Insert( uint32_t item, float xMin, float xMax, float yMin, float yMax )
+  {
+    int32_t cxMin = CellCoord( xMin );
+    int32_t cxMax = CellCoord( xMax );
+    int32_t cyMin = CellCoord( yMin );
+    int32_t cyMax = CellCoord( yMax );
+
+    for( int32_t cy = cyMin; cy <= cyMax; ++cy )
+      for( int32_t cx = cxMin; cx <= cxMax; ++cx )
+        mCells.push_back( { CellKey( cx, cy ), item } );
+
+    ++mItemsCount;
+
+  } // CInvSpatialHash::Insert
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvSpatialHash::Build()
+  {
+    std::sort( mCells.begin(), mCells.end() );
+                        // Items of each cell are in ascending order as well
+
+  } // CInvSpatialHash::Build
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvSpatialHash::QueryShared( float xMin, float xMax, float yMin, float yMax, std::vector<uint32_t> & candidates ) const
+  {
+    candidates.clear();
+    if( 0 == mItemsCount )
+      return;
+
+    int32_t cxMin = CellCoord( xMin );
+    int32_t cxMax = CellCoord( xMax );
+    int32_t cyMin = CellCoord( yMin );
+    int32_t cyMax = CellCoord( yMax );
+
+    for( int32_t cy = cyMin; cy <= cyMax; ++cy )
+    {
+      for( int32_t cx = cxMin; cx <= cxMax; ++cx )
+      {
+        uint64_t key = CellKey( cx, cy );
+        auto it = std::lower_bound( mCells.begin(), mCells.end(), key,
+          []( const std::pair<uint64_t, uint32_t> & cell, uint64_t k ) { return cell.first < k; } );
+
+        for( ; it != mCells.end() && it->first == key; ++it )
+          candidates.push_back( it->second );
+      } // for cx
+    } // for cy
+
+    std::sort( candidates.begin(), candidates.end() );
+    candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+                        // Item covering more cells is reported only once
+
+  } // CInvSpatialHash::QueryShared
+
+} // namespace Inv
@@ -0,0 +1,99 @@
+//****************************************************************************************************
+//! \file CInvSpatialHash.h
+//! Module declares class CInvSpatialHash, uniform grid used as broadphase of collision detection.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvSpatialHash
+#define H_CInvSpatialHash
+
+#include <algorithm>
+
+#include <InvGlobals.h>
+
+namespace Inv
+{
+
+  /*! \brief Class represents uniform grid of square cells, in which items (given by their axis
+      aligned bounding boxes) are binned. Grid is not limited by scene boundaries: every item
+      covering some cell is stored as pair (key of the cell, item) in flat vector, which is sorted
+      by Build() once all items are inserted, so items of one cell form continuous range found by
+      binary search. Items are identified by index (usually index into some external vector),
+      query returns indices of all items whose cells overlap with given box - these are candidates
+      that must be tested by exact (narrowphase) test. The vector keeps its capacity between ticks
+      and no per-cell storage exists, so the grid allocates memory only when more items than ever
+      before are inserted. */
+  class CInvSpatialHash
+  {
+  public:
+
+    CInvSpatialHash();
+
+    CInvSpatialHash( const CInvSpatialHash & ) = delete;
+    CInvSpatialHash & operator=( const CInvSpatialHash & ) = delete;
+    ~CInvSpatialHash();
+
+    void Clear( float cellSize );
+    /*!< \brief Removes all items from grid and sets new size of cells. Cell size should be
+         comparable with size of the largest inserted item, so each item covers few cells only.
+
+         \param[in] cellSize  Size of one (square) cell in pixels */
+
+    void Insert( uint32_t item, float xMin, float xMax, float yMin, float yMax );
+    /*!< \brief Inserts item with given bounding box into all cells covered by the box. Item can
+         be found by queries only after Build() is called.
+
+         \param[in] item   Index of item
+         \param[in] xMin   Left edge of bounding box
+         \param[in] xMax   Right edge of bounding box
+         \param[in] yMin   Top edge of bounding box
+         \param[in] yMax   Bottom edge of bounding box */
+
+    void Build();
+    /*!< \brief Sorts inserted items by cells, must be called after the last Insert() and before
+         the first query. */
+
+    void QueryShared( float xMin, float xMax, float yMin, float yMax, std::vector<uint32_t> & candidates ) const;
+    /*!< \brief Collects all items sharing at least one cell with given bounding box. Each item
+         is reported only once, items are sorted by their index (so the order of subsequent
+         processing is deterministic). The grid is not modified, so the method can be called
+         from more threads at once.
+
+         \param[in]  xMin        Left edge of bounding box
+         \param[in]  xMax        Right edge of bounding box
+         \param[in]  yMin        Top edge of bounding box
+         \param[in]  yMax        Bottom edge of bounding box
+         \param[out] candidates  Indices of found items, previous content is discarded */
+
+    bool IsEmpty() const { return 0 == mItemsCount; }
+    /*!< \brief Returns true if no item was inserted since last Clear() */
+
+  private:
+
+    int32_t CellCoord( float coord ) const { return (int32_t)floorf( coord * mInvCellSize ); }
+    /*!< \brief Converts scene coordinate to cell coordinate */
+
+    static uint64_t CellKey( int32_t cx, int32_t cy )
+    { return ( (uint64_t)(uint32_t)cx << 32 ) | (uint64_t)(uint32_t)cy; }
+    /*!< \brief Combines cell coordinates into single key */
+
+    static constexpr size_t mInitialCapacity = 1024;
+    //!< Number of (cell, item) pairs reserved when the grid is created, enough for usual scene
+
+    float mInvCellSize;
+    //!< Inverse value of cell size, multiplication is cheaper than division
+
+    std::vector<std::pair<uint64_t, uint32_t>> mCells;
+    //!< Pairs (key of cell, item) for all cells covered by items, sorted by Build()
+
+    uint32_t mItemsCount;
+    //!< Number of items inserted since last Clear()
+
+  }; // class CInvSpatialHash
+
+} // namespace Inv
+
+#endif
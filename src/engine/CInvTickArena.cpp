@@ -0,0 +1,172 @@
+//****************************************************************************************************
+//! \file CInvTickArena.cpp
+//! Module defines class CInvTickArena, monotonic memory arena for transient data of single tick.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+#include <engine/CInvTickArena.h>
+
+#ifdef _DEBUG
+
+static std::atomic<uint64_t> lGlobalNewCount( 0u );
+                        // Calls of global operator new, array and nothrow forms call it as well.
+                        // Over-aligned types (std::align_val_t forms) are counted separately
+                        // below, otherwise they would bypass the counter.
+
+void * operator new( std::size_t size )
+{
+  lGlobalNewCount.fetch_add( 1u, std::memory_order_relaxed );
+  if( 0 == size )
+    size = 1;
+
+  while( true )
+  {
+    void * p = std::malloc( size );
+    if( nullptr != p )
+      return p;
+
+    auto handler = std::get_new_handler();
+    if( nullptr == handler )
+      throw std::bad_alloc();
+    handler();
+  } // while
+
+} // operator new
+
+void operator delete( void * p ) noexcept
+{
+  std::free( p );
+} // operator delete
+
+void operator delete( void * p, std::size_t ) noexcept
+{
+  std::free( p );
+} // operator delete
+
+void * operator new( std::size_t size, std::align_val_t alignment )
+{
+  lGlobalNewCount.fetch_add( 1u, std::memory_order_relaxed );
+  if( 0 == size )
+    size = 1;
+
+  const std::size_t align = (std::size_t)alignment;
+  while( true )
+  {
+#ifdef _MSC_VER
+    void * p = _aligned_malloc( size, align );
+#else
+    void * p = std::aligned_alloc( align, ( size + align - 1 ) & ~( align - 1 ) );
+                        // Size must be multiple of the alignment
+#endif
+    if( nullptr != p )
+      return p;
+
+    auto handler = std::get_new_handler();
+    if( nullptr == handler )
+      throw std::bad_alloc();
+    handler();
+  } // while
+
+} // operator new
+
+void operator delete( void * p, std::align_val_t ) noexcept
+{
+#ifdef _MSC_VER
+  _aligned_free( p );   // Memory from _aligned_malloc() must not be passed to free()
+#else
+  std::free( p );
+#endif
+} // operator delete
+
+void operator delete( void * p, std::size_t, std::align_val_t alignment ) noexcept
+{
+  operator delete( p, alignment );
+} // operator delete
+
+#endif
+
+namespace Inv
+{
+  CInvTickArena::CInvTickArena( size_t initialSize ):
+    mBlock( std::make_unique<std::byte[]>( initialSize ) ),
+    mSize( initialSize ),
+    mOverflow(),
+    mResource(),
+    mStatOverflows( 0u )
+  {
+    mResource.emplace( mBlock.get(), mSize, &mOverflow );
+  } // CInvTickArena::CInvTickArena
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvTickArena::~CInvTickArena()
+  {
+    mResource.reset();  // Overflow memory is returned before the block is deleted
+  } // CInvTickArena::~CInvTickArena
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvTickArena::Reset()
+  {
+    mResource->release();
+    if( 0 == mOverflow.mBytes )
+      return;           // Usual case, the block sufficed and it is used again from its beginning
+
+    ++mStatOverflows;
+    size_t newSize = 2 * ( mSize + mOverflow.mBytes );
+    mOverflow.mBytes = 0;
+                        // Block grows with reserve, so that slightly bigger tick does not overflow
+                        // again
+
+    mResource.reset();
+    mBlock = std::make_unique<std::byte[]>( newSize );
+    mSize = newSize;
+    mResource.emplace( mBlock.get(), mSize, &mOverflow );
+
+  } // CInvTickArena::Reset
+
+  //----------------------------------------------------------------------------------------------
+
+  void * CInvTickArena::COverflow::do_allocate( size_t bytes, size_t alignment )
+  {
+    mBytes += bytes;
+    return std::pmr::new_delete_resource()->allocate( bytes, alignment );
+  } // CInvTickArena::COverflow::do_allocate
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvTickArena::COverflow::do_deallocate( void * p, size_t bytes, size_t alignment )
+  {
+    std::pmr::new_delete_resource()->deallocate( p, bytes, alignment );
+  } // CInvTickArena::COverflow::do_deallocate
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvTickArena::COverflow::do_is_equal( const std::pmr::memory_resource & other ) const noexcept
+  {
+    return this == &other;
+  } // CInvTickArena::COverflow::do_is_equal
+
+  //----------------------------------------------------------------------------------------------
+
+  uint64_t GetGlobalNewCount()
+  {
+#ifdef _DEBUG
+    return lGlobalNewCount.load( std::memory_order_relaxed );
+#else
+    return 0u;
+#endif
+  } // GetGlobalNewCount
+
+} // namespace Inv
@@ -0,0 +1,101 @@
+//****************************************************************************************************
+//! \file CInvTickArena.h
+//! Module declares class CInvTickArena, monotonic memory arena for transient data of single tick.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvTickArena
+#define H_CInvTickArena
+
+#include <memory_resource>
+#include <optional>
+
+#include <InvGlobals.h>
+
+namespace Inv
+{
+
+  /*! \brief Class represents memory arena for working sets processors build and throw away during
+      single tick (sorted sprites, collided pairs, entities to be parked). Such data are held in
+      std::pmr containers allocated from the arena; allocation only moves pointer in retained
+      block of memory, deallocation does nothing and whole memory is released at once by Reset()
+      at the end of the tick.
+
+      If the block does not suffice, the arena takes more memory from the global heap. Such tick
+      is counted and Reset() grows the block, so that next ticks of similar size fit into it.
+      Containers allocated from the arena must not outlive the tick. Arena is not thread safe, it
+      must be used from the simulation thread only, or from processors running exclusively. */
+  class CInvTickArena
+  {
+  public:
+
+    CInvTickArena( size_t initialSize = mDefaultSize );
+
+    CInvTickArena( const CInvTickArena & ) = delete;
+    CInvTickArena & operator=( const CInvTickArena & ) = delete;
+    ~CInvTickArena();
+
+    std::pmr::memory_resource * GetResource() { return &*mResource; }
+    /*!< \brief Returns memory resource for std::pmr containers, valid for the whole life of the
+         arena (memory allocated from it is valid only until next Reset()) */
+
+    void Reset();
+    /*!< \brief Releases all memory allocated since previous Reset(). If the block overflowed,
+         it is enlarged. */
+
+    size_t GetCapacity() const { return mSize; }
+    /*!< \brief Returns size of retained block in bytes */
+
+    uint64_t GetOverflowCount() const { return mStatOverflows; }
+    /*!< \brief Returns number of ticks in which the block did not suffice (since start) */
+
+    static constexpr size_t mDefaultSize = 64 * 1024;
+    //!< Initial size of the block in bytes, enough for usual scene
+
+  private:
+
+    /*! \brief Upstream resource of the arena, takes memory from the global heap and counts it */
+    class COverflow: public std::pmr::memory_resource
+    {
+    public:
+
+      size_t mBytes = 0;
+      //!< Number of bytes taken since last Reset() of the arena
+
+    protected:
+
+      void * do_allocate( size_t bytes, size_t alignment ) override;
+      void do_deallocate( void * p, size_t bytes, size_t alignment ) override;
+      bool do_is_equal( const std::pmr::memory_resource & other ) const noexcept override;
+
+    }; // class COverflow
+
+    std::unique_ptr<std::byte[]> mBlock;
+    //!< Retained block of memory, served first
+
+    size_t mSize;
+    //!< Size of mBlock in bytes
+
+    COverflow mOverflow;
+    //!< Source of memory when mBlock is exhausted
+
+    std::optional<std::pmr::monotonic_buffer_resource> mResource;
+    //!< Resource serving allocations, rebuilt when the block is enlarged
+
+    uint64_t mStatOverflows;
+    //!< Number of ticks in which mOverflow was used (since start)
+
+  }; // class CInvTickArena
+
+  uint64_t GetGlobalNewCount();
+  /*!< \brief Returns number of calls of global operator new since the program started. Calls are
+       counted in debug build only (global operator new is replaced), release build returns zero.
+       Comparing the count before and after the tick shows whether the tick allocated anything
+       from the heap. */
+
+} // namespace Inv
+
+#endif
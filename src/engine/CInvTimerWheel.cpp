@@ -0,0 +1,263 @@
+//****************************************************************************************************
+//! \file CInvTimerWheel.cpp
+//! Module defines class CInvTimerWheel, hierarchical timer wheel firing callbacks at given tick.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <engine/CInvTimerWheel.h>
+
+
+namespace Inv
+{
+  CInvTimerWheel::CInvTimerWheel():
+    mNow( 0u ),
+    mNodes(),
+    mFreeNodes( mNoNode )
+  {
+    for( uint32_t list = 0; list <= mFiringList; ++list )
+    {
+      mHeads[list] = mNoNode;
+      mTails[list] = mNoNode;
+    } // for
+  } // CInvTimerWheel::CInvTimerWheel
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvTimerWheel::~CInvTimerWheel() = default;
+
+  //----------------------------------------------------------------------------------------------
+
+  TimerHandle_t CInvTimerWheel::Schedule( uint64_t delayTicks, FnTimer_t callback )
+  {
+    uint32_t node = mFreeNodes;
+    if( mNoNode != node )
+      mFreeNodes = mNodes[node].next;
+    else
+    {                   // Pool grows only when more timers are pending than ever before
+      node = (uint32_t)mNodes.size();
+      mNodes.push_back( { mNoNode, mNoNode, mNoNode, 1u, 0u, nullptr } );
+    } // else
+
+    Node_t & timer = mNodes[node];
+    timer.due = mNow + max( delayTicks, (uint64_t)1u ) - 1u;
+    timer.callback = std::move( callback );
+    Insert( node );
+
+    return ( (TimerHandle_t)timer.generation << 32 ) | node;
+
+  } // CInvTimerWheel::Schedule
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvTimerWheel::Cancel( TimerHandle_t handle )
+  {
+    uint32_t node = NodeOf( handle );
+    if( mNoNode == node )
+      return false;
+
+    Unlink( node );
+    Release( node );
+    return true;
+
+  } // CInvTimerWheel::Cancel
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvTimerWheel::IsPending( TimerHandle_t handle ) const
+  {
+    return mNoNode != NodeOf( handle );
+  } // CInvTimerWheel::IsPending
+
+  //----------------------------------------------------------------------------------------------
+
+  uint64_t CInvTimerWheel::GetTicksLeft( TimerHandle_t handle ) const
+  {
+    uint32_t node = NodeOf( handle );
+    if( mNoNode == node )
+      return 0u;
+
+    return mNodes[node].due - mNow + 1u;
+
+  } // CInvTimerWheel::GetTicksLeft
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvTimerWheel::Advance()
+  {
+    uint32_t slot = (uint32_t)( mNow & ( mLevelSize - 1u ) );
+    if( 0u == slot )
+    {                   // Lowest level wrapped around, timers of higher levels come nearer
+      for( uint32_t level = 1; level < mLevels; ++level )
+        if( !Cascade( level ) )
+          break;
+    } // if
+
+    while( mNoNode != mHeads[slot] )
+    {                   // Timers due in actual tick are moved aside, callbacks may schedule new
+                        // timers to the same list (due in the tick after the next wrap)
+      uint32_t node = mHeads[slot];
+      Unlink( node );
+      Link( node, mFiringList );
+    } // while
+
+    ++mNow;
+                        // Timers scheduled by callbacks are relative to the next tick
+
+    while( mNoNode != mHeads[mFiringList] )
+    {                   // Callback may cancel other timer being fired, so the list is consumed
+                        // node by node
+      uint32_t node = mHeads[mFiringList];
+      Unlink( node );
+
+      TimerHandle_t handle = ( (TimerHandle_t)mNodes[node].generation << 32 ) | node;
+      FnTimer_t callback = std::move( mNodes[node].callback );
+      Release( node );
+                        // Node may be reused by the callback, handle of fired timer is invalid
+
+      if( callback )
+        callback( handle );
+    } // while
+
+  } // CInvTimerWheel::Advance
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvTimerWheel::Clear()
+  {
+    for( uint32_t node = 0; node < (uint32_t)mNodes.size(); ++node )
+      if( mNoNode != mNodes[node].list )
+        Release( node );
+
+    for( uint32_t list = 0; list <= mFiringList; ++list )
+    {
+      mHeads[list] = mNoNode;
+      mTails[list] = mNoNode;
+    } // for
+
+  } // CInvTimerWheel::Clear
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvTimerWheel::Insert( uint32_t node )
+  {
+    uint64_t due = mNodes[node].due;
+    uint64_t delta = due - mNow;
+
+    for( uint32_t level = 0; level < mLevels; ++level )
+    {
+      uint32_t shift = level * mLevelBits;
+      if( delta < ( (uint64_t)1u << ( shift + mLevelBits ) ) )
+      {
+        Link( node, level * mLevelSize + (uint32_t)( ( due >> shift ) & ( mLevelSize - 1u ) ) );
+        return;
+      } // if
+    } // for
+
+    uint32_t shift = ( mLevels - 1u ) * mLevelBits;
+    uint64_t farthest = mNow + ( (uint64_t)1u << ( mLevels * mLevelBits ) ) - 1u;
+    Link( node, ( mLevels - 1u ) * mLevelSize + (uint32_t)( ( farthest >> shift ) & ( mLevelSize - 1u ) ) );
+                        // Timer beyond range of the wheel waits in the farthest list, it is
+                        // distributed again when the list is cascaded
+
+  } // CInvTimerWheel::Insert
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvTimerWheel::Link( uint32_t node, uint32_t list )
+  {
+    Node_t & timer = mNodes[node];
+    timer.list = list;
+    timer.next = mNoNode;
+    timer.prev = mTails[list];
+
+    if( mNoNode != mTails[list] )
+      mNodes[mTails[list]].next = node;
+    else
+      mHeads[list] = node;
+    mTails[list] = node;
+
+  } // CInvTimerWheel::Link
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvTimerWheel::Unlink( uint32_t node )
+  {
+    Node_t & timer = mNodes[node];
+
+    if( mNoNode != timer.prev )
+      mNodes[timer.prev].next = timer.next;
+    else
+      mHeads[timer.list] = timer.next;
+
+    if( mNoNode != timer.next )
+      mNodes[timer.next].prev = timer.prev;
+    else
+      mTails[timer.list] = timer.prev;
+
+    timer.prev = mNoNode;
+    timer.next = mNoNode;
+
+  } // CInvTimerWheel::Unlink
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvTimerWheel::Release( uint32_t node )
+  {
+    Node_t & timer = mNodes[node];
+    timer.list = mNoNode;
+    timer.callback = nullptr;
+    if( 0u == ++timer.generation )
+      timer.generation = 1u;
+                        // Zero generation is reserved, gNoTimer must never match any node
+
+    timer.next = mFreeNodes;
+    mFreeNodes = node;
+
+  } // CInvTimerWheel::Release
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvTimerWheel::Cascade( uint32_t level )
+  {
+    uint32_t slot = (uint32_t)( ( mNow >> ( level * mLevelBits ) ) & ( mLevelSize - 1u ) );
+    uint32_t list = level * mLevelSize + slot;
+
+    uint32_t node = mHeads[list];
+    mHeads[list] = mNoNode;
+    mTails[list] = mNoNode;
+                        // List is detached first, timers beyond range of the wheel may return
+                        // to the same level
+
+    while( mNoNode != node )
+    {
+      uint32_t next = mNodes[node].next;
+      Insert( node );
+      node = next;
+    } // while
+
+    return 0u == slot;
+
+  } // CInvTimerWheel::Cascade
+
+  //----------------------------------------------------------------------------------------------
+
+  uint32_t CInvTimerWheel::NodeOf( TimerHandle_t handle ) const
+  {
+    uint32_t node = (uint32_t)( handle & 0xFFFFFFFFu );
+    uint32_t generation = (uint32_t)( handle >> 32 );
+
+    if( mNodes.size() <= node )
+      return mNoNode;
+
+    const Node_t & timer = mNodes[node];
+    if( timer.generation != generation || mNoNode == timer.list )
+      return mNoNode;
+
+    return node;
+
+  } // CInvTimerWheel::NodeOf
+
+} // namespace Inv
@@ -0,0 +1,150 @@
+//****************************************************************************************************
+//! \file CInvTimerWheel.h
+//! Module declares class CInvTimerWheel, hierarchical timer wheel firing callbacks at given tick.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvTimerWheel
+#define H_CInvTimerWheel
+
+#include <InvGlobals.h>
+
+namespace Inv
+{
+
+  using TimerHandle_t = uint64_t;
+  //!< \brief Identifier of scheduled timer, composed of index of timer slot and its generation, so
+  //!  that handle of fired or cancelled timer never matches timer scheduled later in the same slot.
+
+  constexpr TimerHandle_t gNoTimer = 0u;
+  //!< Handle never returned by CInvTimerWheel::Schedule()
+
+  /*! \brief Class represents hierarchical timer wheel counting simulation ticks. Instead of
+      decrementing every countdown in every tick, owner of the countdown schedules a callback fired
+      when the countdown expires; the wheel then does constant work per tick regardless of number
+      of pending timers.
+
+      Timers due in next 64 ticks are kept in the lowest level, one list per tick. Each higher level
+      has 64 lists as well, but every list covers 64 times longer interval; when the lower level
+      wraps around, timers of the actual list of the higher level are redistributed to the lower
+      levels (cascade). Four levels cover more than 16 millions ticks, farther timers wait in the
+      last list of the highest level and are redistributed again. Scheduling and cancelling are
+      O(1), timers are kept in single pool and linked by indices.
+
+      Timers due in the same tick are fired in order they reached the lowest level, which depends
+      only on order of scheduling, so the simulation stays deterministic. Callbacks may schedule
+      and cancel timers (including timers due in the same tick). Wheel is not thread safe, it must
+      be used from the simulation thread only, or from processors running exclusively. */
+  class CInvTimerWheel
+  {
+  public:
+
+    using FnTimer_t = std::function<void( TimerHandle_t )>;
+    //!< \brief Type of callback fired when timer expires, handle of the timer is passed to it
+
+    CInvTimerWheel();
+
+    CInvTimerWheel( const CInvTimerWheel & ) = delete;
+    CInvTimerWheel & operator=( const CInvTimerWheel & ) = delete;
+    ~CInvTimerWheel();
+
+    TimerHandle_t Schedule( uint64_t delayTicks, FnTimer_t callback );
+    /*!< \brief Schedules callback to be fired after given number of ticks.
+
+         \param[in] delayTicks  Callback is fired during \e delayTicks-th following call of Advance(),
+                                zero is handled as one (timer never fires during the call that
+                                schedules it)
+         \param[in] callback    Function called when the timer expires
+         \return Handle of the timer, valid until it is fired or cancelled */
+
+    bool Cancel( TimerHandle_t handle );
+    /*!< \brief Cancels pending timer, its callback is never fired.
+
+         \param[in] handle  Handle of the timer, fired or cancelled timers and gNoTimer are ignored
+         \return True if the timer was pending and is cancelled now */
+
+    bool IsPending( TimerHandle_t handle ) const;
+    /*!< \brief Returns true if the timer was scheduled and neither fired nor cancelled yet */
+
+    uint64_t GetTicksLeft( TimerHandle_t handle ) const;
+    /*!< \brief Returns number of calls of Advance() needed to fire the timer, zero if the timer
+         is not pending */
+
+    void Advance();
+    /*!< \brief Moves the wheel by one tick and fires all timers due in it. */
+
+    void Clear();
+    /*!< \brief Cancels all pending timers, callbacks are not fired. Memory is not released. */
+
+    uint64_t GetTick() const { return mNow; }
+    /*!< \brief Returns number of tick which will be processed by next call of Advance() */
+
+  private:
+
+    static constexpr uint32_t mLevelBits = 6;
+    //!< Every level has 2^mLevelBits lists
+
+    static constexpr uint32_t mLevelSize = 1u << mLevelBits;
+    //!< Number of lists in each level
+
+    static constexpr uint32_t mLevels = 4;
+    //!< Number of levels of the wheel
+
+    static constexpr uint32_t mFiringList = mLevels * mLevelSize;
+    //!< Index of list holding timers being fired in actual tick
+
+    static constexpr uint32_t mNoNode = UINT32_MAX;
+    //!< Index terminating linked lists
+
+    struct Node_t
+    {
+      uint32_t prev;        //!< Previous node in the list, mNoNode for the first one
+      uint32_t next;        //!< Next node in the list (or in the free list), mNoNode for the last one
+      uint32_t list;        //!< Index of list the node is linked in, mNoNode if the node is free
+      uint32_t generation;  //!< Incremented whenever the node is released
+      uint64_t due;         //!< Tick in which the timer fires
+      FnTimer_t callback;   //!< Function called when the timer fires
+    };
+
+    void Insert( uint32_t node );
+    /*!< \brief Links node to the list given by its due tick and actual tick of the wheel */
+
+    void Link( uint32_t node, uint32_t list );
+    /*!< \brief Appends node to the end of given list */
+
+    void Unlink( uint32_t node );
+    /*!< \brief Removes node from the list it is linked in */
+
+    void Release( uint32_t node );
+    /*!< \brief Returns node to the free list, handles of the node become invalid */
+
+    bool Cascade( uint32_t level );
+    /*!< \brief Redistributes timers of actual list of given level to lower levels.
+         \return True if the level wrapped around, so the next level must be cascaded as well */
+
+    uint32_t NodeOf( TimerHandle_t handle ) const;
+    /*!< \brief Returns index of node of pending timer, mNoNode if the handle is not valid */
+
+    uint64_t mNow;
+    //!< Tick processed by next call of Advance()
+
+    std::vector<Node_t> mNodes;
+    //!< Pool of timers, nodes are reused through free list
+
+    uint32_t mFreeNodes;
+    //!< First node of the free list
+
+    uint32_t mHeads[mFiringList + 1];
+    //!< First node of every list (all levels and the list being fired)
+
+    uint32_t mTails[mFiringList + 1];
+    //!< Last node of every list, new timers are appended to keep firing order
+
+  }; // class CInvTimerWheel
+
+} // namespace Inv
+
+#endif
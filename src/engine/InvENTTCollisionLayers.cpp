@@ -0,0 +1,99 @@
+//****************************************************************************************************
+//! \file InvENTTCollisionLayers.cpp
+//! Module contains functions maintaining collision layer and mask components (see cpCollisionLayer
+//! and cpCollisionMask) and deactivation tag (see cpPendingDestroy) of EnTT entities.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <engine/InvENTTCollisionLayers.h>
+
+namespace Inv
+{
+
+  void UpdateCollisionLayers( entt::registry & reg, entt::entity entity )
+  {
+    if( ! reg.valid( entity ) )
+      return;
+
+    auto [ id, gph ] = reg.try_get<cpId, cpGraphics>( entity );
+    bool canCollide =
+      nullptr != id && id->active && nullptr != gph && ! gph->isHidden && gph->standardSprite.IsValid();
+                        // Inactive (to be pruned) or hidden entity does not interact at all
+
+    auto [ bAlien, sAlien, sBossAlien ] = reg.try_get<cpAlienBehave, cpAlienStatus, cpAlienBossStatus>( entity );
+    auto [ bPlayer, sPlayer ] = reg.try_get<cpPlayBehave, cpPlayStatus>( entity );
+
+    uint32_t layer = clNone;
+    bool inFormation = false;
+    cpFormationSlot slot{ 0, 0 };
+
+    if( canCollide && reg.all_of<cpHealth>( entity ) )
+    {
+      if( nullptr != bAlien && nullptr != sAlien && ! sAlien->isDying )
+      {
+        layer |= clAlien;
+
+        auto slotAlien = reg.try_get<cpFormationSlot>( entity );
+        if( nullptr != slotAlien && ! sAlien->isInRaid && ! sAlien->isReturningToFormation )
+        {               // Alien stays in formation, it can be found in formation lattice
+          inFormation = true;
+          slot = *slotAlien;
+        } // if
+      } // if
+
+      if( nullptr != bAlien && nullptr != sBossAlien && ! sBossAlien->isDying )
+        layer |= clAlien;
+
+      if( nullptr != bPlayer && nullptr != sPlayer && ! sPlayer->isDying && ! sPlayer->isInvulnerable )
+        layer |= clPlayer;
+    } // if
+
+    if( clNone == layer )
+      reg.remove<cpCollisionLayer>( entity );
+    else
+      reg.emplace_or_replace<cpCollisionLayer>( entity, layer, inFormation, slot );
+
+    uint32_t mask = clNone;
+    auto dmg = reg.try_get<cpDamage>( entity );
+    if( canCollide && nullptr != dmg && reg.all_of<cpVelocity>( entity ) )
+    {
+      if( dmg->dangerToAliens )
+        mask |= clAlien;
+      if( dmg->dangerToPlayer )
+        mask |= clPlayer;
+    } // if
+
+    if( clNone == mask )
+      reg.remove<cpCollisionMask>( entity );
+    else
+      reg.emplace_or_replace<cpCollisionMask>( entity, mask, dmg->removeOnHit, nullptr == bAlien );
+                        // Projectiles (not aliens, those are slow and their real motion is given
+                        // by formation) are tested along the whole path travelled in last tick.
+
+    if( ( clNone != layer || clNone != mask ) && ! reg.all_of<cpCollisionMotion>( entity ) )
+      reg.emplace<cpCollisionMotion>( entity, cpCollisionMotion{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0 } );
+                        // Collision detector reads motion from its groups together with layer or
+                        // mask. Motion is kept when the entity stops colliding for a while, gap in
+                        // observation starts new epoch anyway.
+
+  } // UpdateCollisionLayers
+
+  //----------------------------------------------------------------------------------------------
+
+  void DeactivateEntity( entt::registry & reg, entt::entity entity )
+  {
+    auto id = reg.valid( entity ) ? reg.try_get<cpId>( entity ) : nullptr;
+    if( nullptr == id || reg.all_of<cpParked>( entity ) )
+      return;           // Parked entity is already pruned, it must not be parked again
+
+    id->active = false;
+    reg.emplace_or_replace<cpPendingDestroy>( entity );
+                        // Entity is removed from registry by garbage collector later
+    UpdateCollisionLayers( reg, entity );
+
+  } // DeactivateEntity
+
+} // namespace Inv
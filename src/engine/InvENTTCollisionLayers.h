@@ -0,0 +1,43 @@
+//****************************************************************************************************
+//! \file InvENTTCollisionLayers.h
+//! Module contains functions maintaining collision layer and mask components (see cpCollisionLayer
+//! and cpCollisionMask) and deactivation tag (see cpPendingDestroy) of EnTT entities.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_InvENTTCollisionLayers
+#define H_InvENTTCollisionLayers
+
+#include <entity/registry.hpp>
+
+#include <InvGlobals.h>
+#include <engine/InvENTTComponents.h>
+
+namespace Inv
+{
+
+  void UpdateCollisionLayers( entt::registry & reg, entt::entity entity );
+  /*!< \brief Sets or removes collision layer and mask components of given entity according to its
+       actual state (cpId::active, cpGraphics::isHidden, dying and invulnerability flags, raid state
+       of aliens). Entity with layer or mask gets cpCollisionMotion as well. Must be called whenever
+       any of these states changes and after the entity is created, as the collision detector
+       relies on these components only. Invalid entities are ignored. Must not be called while the collision detector iterates over these components.
+
+       \param[in,out] reg     Registry containing the entity
+       \param[in]     entity  Entity to be updated */
+
+  void DeactivateEntity( entt::registry & reg, entt::entity entity );
+  /*!< \brief Marks entity as inactive (cpId::active), tags it by cpPendingDestroy for garbage
+       collector and updates its collision layers. All deactivations must go through here, the
+       collector does not search for inactive entities itself. Invalid entities, parked
+       entities (see cpParked) and entities without cpId are ignored.
+
+       \param[in,out] reg     Registry containing the entity
+       \param[in]     entity  Entity to be deactivated */
+
+} // namespace Inv
+
+#endif
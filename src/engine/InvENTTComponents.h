@@ -10,11 +10,20 @@
 #ifndef H_InvENTTComponents
 #define H_InvENTTComponents
 
+#include <entity/fwd.hpp>
+
 #include <InvGlobals.h>
+#include <engine/CInvTimerWheel.h>
+#include <graphics/CInvSprite.h>
 
 namespace Inv
 {
 
+  using FnEventCallbackEithEntityId_t = std::function<void( entt::entity, uint32_t )>;
+  //!< Type definition for event callback with entity id
+
+  class CInvEntityPool;
+
   //****** component: entity full identifier *********************************************************
 
   struct cpId
@@ -28,7 +37,8 @@ namespace Inv
 
     bool active;
     //!< \b true if the entity is active. Inactive entity is not processed nor
-    //!  displayed in game loop and it will be pruned in nearest possiblev time.
+    //!  displayed in game loop and it will be pruned in nearest possiblev time. Must be cleared
+    //!  by DeactivateEntity() only, so that garbage collector finds the entity.
 
     bool noticeOnPruning;
     //!< \b true if the entity should send notification when it is pruned
@@ -86,9 +96,11 @@ namespace Inv
     //!< Probability of shooting while in raid mode in each game tick
 
     float startingX;
-    //<! Starting X position in formation (of centre of alien object) [px]
+    //<! Starting X position in formation (of centre of alien object) [px]. Actual position in
+    //!  formation is this plus displacement of the formation (see CInvFormationIndex).
     float startingY;
-    //<! Starting Y position in formation (of centre of alien object) [px]
+    //<! Starting Y position in formation (of centre of alien object) [px]. Actual position in
+    //!  formation is this plus displacement of the formation (see CInvFormationIndex).
 
     uint32_t scoreToAdd;
     //!< Score added to player when this alien is destroyed
@@ -119,14 +131,40 @@ namespace Inv
     //!< \b true if the alien is returning to formation after raid,
     //!<  false otherwise.
 
-    uint32_t raidTicksLeft;
-    //!< Number of ticks left in raid mode. When it reaches zero,
-    //!< alien returns to formation.
+    bool isRaidStarting;
+    //!< \b true if the alien entered raid mode and its movement was not initiated yet.
+
+    bool isRaidTimeOver;
+    //!< \b true if maximal time of the raid elapsed, alien returns to formation.
 
-    float formationX;
-    //!< X position in formation (of centre of alien object) [px]
-    float formationY;
-    //!< Y position in formation (of centre of alien object) [px]
+    TimerHandle_t raidTimer;
+    //!< Timer setting isRaidTimeOver (see procAlienRaidDriver), gNoTimer if there is none.
+
+    uint32_t scheduleStamp;
+    //!< Incremented when the alien leaves formation, events scheduled for it before
+    //!< (see procActorStateSelector) are no longer valid.
+  };
+
+  //****** component: alien in formation *************************************************************
+
+  /*! \brief Tag component of alien staying in its place in formation (neither raiding nor returning).
+      Such alien does not move by itself, whole formation moves rigidly by displacement kept in
+      CInvFormationIndex. Its cpPosition is therefore not maintained, actual position is derived
+      from starting position (cpAlienBehave) and displacement where needed. Tag is removed when
+      the alien starts raid, position is set at that moment, and emplaced again when it returns. */
+  struct cpInFormation {};
+
+  //****** component: alien formation slot ***********************************************************
+
+  /*! \brief This component determines the slot of the alien in formation lattice (see
+      CInvFormationIndex). Only aliens placed in formation when the scene is generated have it. */
+  struct cpFormationSlot
+  {
+    uint32_t row;
+    //!< Row of the formation lattice
+
+    uint32_t column;
+    //!< Column of the formation lattice
   };
 
   //****** component: alien boss status ***************************************************************
@@ -205,32 +243,99 @@ namespace Inv
     //!  true (some form of piercing ammo)
   };
 
-  //****** component: entity graphics *****************************************************************
+  //****** component: collision layer ****************************************************************
 
-  class CInvSprite;
-  class CInvEffect;
+  enum CollisionLayer_t : uint32_t
+  {
+    clNone   = 0x00,    //!< Entity does not belong to any layer
+    clAlien  = 0x01,    //!< Aliens (including alien boss)
+    clPlayer = 0x02     //!< Player ship
+  };
+  //!< \brief Collision layers, used as bits of cpCollisionLayer and cpCollisionMask
+
+  /*! \brief This component determines that the entity can be hit right now, i.e. it has health,
+      it is active, visible and neither dying nor invulnerable. It is not set directly, but by
+      function UpdateCollisionLayers() which must be called whenever any of these states changes.
+      Collision detector iterates over this component only (owning group), so it does not need to
+      look up status components of every entity. */
+  struct cpCollisionLayer
+  {
+    uint32_t layer;
+    //!< Collision layers the entity belongs to (combination of CollisionLayer_t bits)
+
+    bool inFormation;
+    //!< \b true if the entity is alien staying in its formation slot (not in raid)
+
+    cpFormationSlot slot;
+    //!< Copy of formation slot of alien, valid only if inFormation is set
+  };
+
+  //****** component: collision mask *****************************************************************
+
+  /*! \brief This component determines that the entity can deal damage right now, i.e. it has damage
+      component and it is active and visible. It is maintained by function UpdateCollisionLayers()
+      in the same way as cpCollisionLayer. */
+  struct cpCollisionMask
+  {
+    uint32_t mask;
+    //!< Collision layers the entity can hit (combination of CollisionLayer_t bits)
+
+    bool removeOnHit;
+    //!< Copy of cpDamage::removeOnHit
+
+    bool isSwept;
+    //!< \b true if the entity is projectile tested along the path travelled in last tick
+  };
+
+  //****** component: collision motion ***************************************************************
+
+  /*! \brief This component is maintained by collision detector (see procCollisionDetector) for
+      every entity taking part in collisions. It holds motion of the entity observed in last ticks,
+      so the detector can predict when two entities could touch at the earliest. It is emplaced by
+      function UpdateCollisionLayers() together with cpCollisionLayer or cpCollisionMask, so the
+      detector reads it from its groups. */
+  struct cpCollisionMotion
+  {
+    float centreX;
+    //!< X coordinate of centre of bounding box in last tick [px]
+
+    float centreY;
+    //!< Y coordinate of centre of bounding box in last tick [px]
+
+    float vX;
+    //!< Observed X velocity [px/tick], valid since the epoch was set
+
+    float vY;
+    //!< Observed Y velocity [px/tick], valid since the epoch was set
+
+    float width;
+    //!< Width of bounding box [px], valid since the epoch was set
+
+    float height;
+    //!< Height of bounding box [px], valid since the epoch was set
+
+    uint32_t epoch;
+    //!< Unique number changed whenever the velocity or the size of the entity changes. Cached
+    //!  predictions made for the entity are valid only while the epoch remains the same.
+
+    uint64_t lastTick;
+    //!< Collision tick in which the motion was last updated
+  };
+
+  //****** component: entity graphics *****************************************************************
 
   /*! \brief */
   struct cpGraphics
   {
-    std::shared_ptr<CInvSprite> standardSprite;
-    //!< Pointer to sprite object used to render the entity in standard
-    //!  way on screen. Remark: should contein copy of CInvSprite from CInvSpriteStorage,
-    //!  not a reference, as the sprite may have unique set of effect applied for
-    //!  each entity.
+    CInvSprite standardSprite;
+    //!< Sprite instance used to render the entity in standard way on screen. It is held by value,
+    //!  images are shared with all other instances of the same sprite (see CInvSpriteFrames), so
+    //!  the instance holds only vertices, actual image index and level. Effects of the entity are
+    //!  not held by the sprite, they are separate components (cpFxAnimation, cpFxBlink...).
 
     uint32_t staticStandardImageIndex;
     //!< Index of image in standard sprite to be used when no animation
 
-    std::shared_ptr<CInvEffect> standardAnimationEffect;
-    //!< Pointer to animation effect applied to standard sprite
-
-    std::shared_ptr<CInvEffect> specificAnimationEffect;
-    //!< Pointer to special animation effect applied, as firing invader sprite or similar
-
-    std::shared_ptr<CInvEffect> dyingAnimationEffect;
-    //!< Pointer to special animation effect applied,of entity is dying.
-
     LARGE_INTEGER diffTick;
     //!< Animation driver
 
@@ -239,6 +344,159 @@ namespace Inv
 
   };
 
+  //****** component: sprite animation effect ********************************************************
+
+  /*! \brief State of single animation sequence, changes image of the sprite in given pace. Plain
+      data counterpart of CInvEffectSpriteAnimation, applied by procActorAnimator. */
+  struct FxAnimationTrack_t
+  {
+    uint32_t pace;
+    //!< Number of ticks between changing to next image
+
+    uint32_t firstImage;
+    //!< Index of first image of the sequence
+
+    uint32_t lastImage;
+    //!< Index of last image of the sequence, UINT32_MAX means the last image of the sprite
+
+    bool isSuspended;
+    //!< Sequence is not applied until restored (see RestoreEffect())
+
+    bool isContinuous;
+    //!< Sequence loops, otherwise it suspends itself when the last image is reached
+
+    bool isFinalReported;
+    //!< Final callback was already called, reset when the sequence is restored
+
+    bool isEventReported;
+    //!< Event callback was already called, reset when the last image is reached
+
+    uint32_t eventImage;
+    //!< Image on which eventCallback is called, UINT32_MAX if there is none
+
+    FnEventCallbackEithEntityId_t eventCallback;
+    //!< Called when the sequence reaches eventImage
+
+    FnEventCallbackEithEntityId_t finalCallback;
+    //!< Called when non-continuous sequence reaches its last image
+  };
+
+  /*! \brief Animation of entity sprite. Entity may have two sequences, specific one (firing alien,
+      for example) is applied after the standard one. Effect of priority 1. */
+  struct cpFxAnimation
+  {
+    FxAnimationTrack_t standard;
+    //!< Standard animation sequence
+
+    FxAnimationTrack_t specific;
+    //!< Special animation sequence (firing invader), pace 0 if the entity has none
+  };
+
+  //****** component: sprite blinking effect *********************************************************
+
+  /*! \brief Sprite of the entity blinks (is not drawn every other pace), plain data counterpart of
+      CInvEffectSpriteBlink. Effect of priority 1, applied after animation. */
+  struct cpFxBlink
+  {
+    uint32_t pace;
+    //!< Number of ticks between showing and hiding the sprite
+
+    uint32_t ticksSpan;
+    //!< Number of ticks in which non-continuous effect is active
+
+    uint32_t ticksLeft;
+    //!< Number of ticks left to effect autosuspend
+
+    bool isSuspended;
+    //!< Effect is not applied until restored (see RestoreEffect())
+
+    bool isContinuous;
+    //!< Effect runs until suspended, otherwise it suspends itself after ticksSpan ticks
+
+    FnEventCallbackEithEntityId_t finalCallback;
+    //!< Called when non-continuous effect ends
+  };
+
+  //****** component: sprite shrinking effect ********************************************************
+
+  /*! \brief Sprite of the entity shrinks (dying entities), plain data counterpart of
+      CInvEffectSpriteShrink. Effect of priority 11. */
+  struct cpFxShrink
+  {
+    uint32_t pace;
+    //!< Number of ticks in which final size is reached
+
+    float finalRatio;
+    //!< Final ratio of size to original size, in range (0 - 1)
+
+    uint32_t ticksLeft;
+    //!< Number of ticks left to effect autosuspend (or reset, if continuous)
+
+    bool isSuspended;
+    //!< Effect is not applied until restored (see RestoreEffect())
+
+    bool isContinuous;
+    //!< Effect repeats, otherwise it suspends itself when final size is reached
+
+    FnEventCallbackEithEntityId_t finalCallback;
+    //!< Called when non-continuous effect ends
+  };
+
+  //****** component: sprite mirroring effect ********************************************************
+
+  /*! \brief Tag component, sprite of the entity is mirrored along vertical axis. Counterpart of
+      CInvEffectSpriteMirror, effect of priority 50. */
+  struct cpFxMirror {};
+
+  //****** component: pooled entity *********************************************************************
+
+  /*! \brief Entity belongs to a pool of entities of the same type (see CInvEntityPool). When it is
+      pruned, garbage collector parks it in the pool instead of destroying it, its sprite and effects
+      are kept and reused by the next entity of the type. */
+  struct cpPooled
+  {
+    CInvEntityPool * pool;
+    //!< Pool the entity is returned to
+  };
+
+  //****** component: parked entity *********************************************************************
+
+  /*! \brief Tag component of pooled entity waiting in its pool for reuse. Parked entity has no
+      position nor collision layers, so no processor moving, drawing or colliding entities sees it. */
+  struct cpParked {};
+
+  //****** component: entity pending destruction ********************************************************
+
+  /*! \brief Tag component of deactivated entity (cpId::active is false) waiting for garbage collector,
+      emplaced by DeactivateEntity(). The collector iterates storage of this tag only, so its cost
+      depends on number of pruned entities, not on number of living ones. */
+  struct cpPendingDestroy {};
+
+  //****** resources: tags of shared state accessed by processors ************************************
+
+  /*! \brief Tag types below are not components, they represent shared state other than components
+      in the declarations of resources accessed by processors (see CInvProcessorScheduler). Processor
+      declaring the tag as non-const writes the state, const tag means the state is only read. */
+
+  struct rsEntities {};
+  //!< Structure of the registry: entities are created or destroyed, components emplaced or removed
+  //!  (including calls of UpdateCollisionLayers()), entity factory and callbacks to the scene used.
+  //!  Every processor reads it, so processor writing it runs alone.
+
+  struct rsRandom {};
+  //!< Random number generator (CInvRandom), its sequence must not depend on thread timing
+
+  struct rsPlayerPosition {};
+  //!< Actual position of player ship kept by the scene
+
+  struct rsDangerArea {};
+  //!< Flag of player being in dangerous area (above alien formation)
+
+  struct rsAlienGroup {};
+  //!< Velocity and motion state of alien formation as a whole
+
+  struct rsOutOfScene {};
+  //!< List of entities found out of scene by procActorMover, consumed by procActorOutOfSceneCheck
 
 } // namespace Inv
 
@@ -0,0 +1,158 @@
+//****************************************************************************************************
+//! \file InvENTTEffects.cpp
+//! Module contains functions applying sprite effect components (see cpFxAnimation, cpFxBlink,
+//! cpFxShrink and cpFxMirror) of EnTT entities.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <engine/InvENTTEffects.h>
+
+namespace Inv
+{
+
+  static bool lIsPlaced( const cpGraphics & gph )
+  {
+    return !gph.isHidden && 0 < gph.standardSprite.GetNumberOfImages();
+  } // lIsPlaced
+
+  //----------------------------------------------------------------------------------------------
+
+  static void lApplyAnimation( entt::entity entity, cpGraphics & gph, FxAnimationTrack_t & track )
+  {
+    if( track.isSuspended )
+      return;
+
+    auto nrOfImages = (uint32_t)gph.standardSprite.GetNumberOfImages();
+
+    auto lastImage = track.lastImage;
+    if( nrOfImages <= lastImage )
+      lastImage = nrOfImages - 1;
+
+    auto rng = lastImage - track.firstImage + 1;
+
+    LONGLONG idx = gph.diffTick.QuadPart;
+    if( idx < 0 ) idx = 0;
+    idx %= ( track.pace * rng );
+    auto imageIndex = (uint32_t)( track.firstImage + idx / track.pace );
+    gph.standardSprite.SetResultingImage( imageIndex );
+
+    if( imageIndex == track.eventImage && !track.isEventReported )
+    {                   // Animation reached an important image with registered callback
+      if( nullptr != track.eventCallback )
+        track.eventCallback( entity, imageIndex );
+      track.isEventReported = true;
+    } // if
+
+    if( lastImage <= imageIndex )
+    {
+      track.isEventReported = false;
+                        // On final image, event callback is made callable again
+
+      if( !track.isContinuous )
+      {                 // Non-continuous animation reached its end - it suspends itself and calls
+                        // final callback
+        if( nullptr != track.finalCallback && !track.isFinalReported )
+        {
+          track.finalCallback( entity, imageIndex );
+          track.isFinalReported = true;
+        } // if
+        track.isSuspended = true;
+      } // if
+    } // if
+
+  } // lApplyAnimation
+
+  //----------------------------------------------------------------------------------------------
+
+  void ApplySpriteEffects( entt::registry & reg )
+  {
+    auto viewA = reg.view<cpGraphics, cpFxAnimation>( entt::exclude<cpParked> );
+    viewA.each( []( entt::entity entity, cpGraphics & gph, cpFxAnimation & anim )
+    {                   // Priority 1: animations, specific sequence overrides the standard one
+      if( !lIsPlaced( gph ) )
+        return;
+      lApplyAnimation( entity, gph, anim.standard );
+      lApplyAnimation( entity, gph, anim.specific );
+    } );
+
+    auto viewB = reg.view<cpGraphics, cpFxBlink>( entt::exclude<cpParked> );
+    viewB.each( []( entt::entity entity, cpGraphics & gph, cpFxBlink & blink )
+    {                   // Priority 1: blinking
+      if( !lIsPlaced( gph ) || blink.isSuspended )
+        return;
+
+      if( 1 == ( ( gph.diffTick.QuadPart / blink.pace ) % 2 ) )
+        gph.standardSprite.CancelDrawing();
+
+      if( blink.isContinuous )
+        return;
+
+      if( 0 < blink.ticksLeft )
+        --blink.ticksLeft;
+      else
+      {
+        if( nullptr != blink.finalCallback )
+          blink.finalCallback( entity, 0 );
+        blink.isSuspended = true;
+      } // else
+    } );
+
+    auto viewS = reg.view<cpGraphics, cpFxShrink>( entt::exclude<cpParked> );
+    viewS.each( []( entt::entity entity, cpGraphics & gph, cpFxShrink & shrink )
+    {                   // Priority 11: shrinking of dying entities
+      if( !lIsPlaced( gph ) || shrink.isSuspended )
+        return;
+
+      float actRatio = 1.0f - ( 1.0f - (float)shrink.ticksLeft / (float)shrink.pace ) * ( 1.0f - shrink.finalRatio );
+      gph.standardSprite.Scale( actRatio );
+
+      if( 0 < shrink.ticksLeft )
+        --shrink.ticksLeft;
+      else if( shrink.isContinuous )
+        shrink.ticksLeft = shrink.pace;
+      else
+      {
+        if( nullptr != shrink.finalCallback )
+          shrink.finalCallback( entity, 0 );
+        shrink.isSuspended = true;
+      } // else
+    } );
+
+    auto viewM = reg.view<cpGraphics, const cpFxMirror>( entt::exclude<cpParked> );
+    viewM.each( []( cpGraphics & gph )
+    {                   // Priority 50: mirroring
+      if( lIsPlaced( gph ) )
+        gph.standardSprite.Mirror();
+    } );
+
+  } // ApplySpriteEffects
+
+  //----------------------------------------------------------------------------------------------
+
+  void RestoreEffect( FxAnimationTrack_t & track )
+  {
+    track.isFinalReported = false;
+    track.isEventReported = false;
+    track.isSuspended = false;
+  } // RestoreEffect
+
+  //----------------------------------------------------------------------------------------------
+
+  void RestoreEffect( cpFxBlink & blink )
+  {
+    blink.ticksLeft = blink.ticksSpan;
+    blink.isSuspended = false;
+  } // RestoreEffect
+
+  //----------------------------------------------------------------------------------------------
+
+  void RestoreEffect( cpFxShrink & shrink )
+  {
+    shrink.ticksLeft = shrink.pace;
+    shrink.isSuspended = false;
+  } // RestoreEffect
+
+} // namespace Inv
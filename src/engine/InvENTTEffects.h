@@ -0,0 +1,43 @@
+//****************************************************************************************************
+//! \file InvENTTEffects.h
+//! Module contains functions applying sprite effect components (see cpFxAnimation, cpFxBlink,
+//! cpFxShrink and cpFxMirror) of EnTT entities.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_InvENTTEffects
+#define H_InvENTTEffects
+
+#include <entity/registry.hpp>
+
+#include <InvGlobals.h>
+#include <engine/InvENTTComponents.h>
+
+namespace Inv
+{
+
+  void ApplySpriteEffects( entt::registry & reg );
+  /*!< \brief Applies effect components on sprites of all entities, which were placed by
+       CInvSprite::Place() in actual tick. Each type of effect is processed in its own loop over
+       packed storage of the component, in order of effect priorities (animation, blinking,
+       shrinking, mirroring), so no virtual call is made and no effect object is shared. Event
+       callbacks of the effects are called with the entity, they must not emplace or remove effect
+       components nor cpGraphics. Hidden and parked entities are skipped.
+
+       \param[in,out] reg  Registry containing the entities */
+
+  void RestoreEffect( FxAnimationTrack_t & track );
+  /*!< \brief Starts animation sequence from the beginning, event flags are reset */
+
+  void RestoreEffect( cpFxBlink & blink );
+  /*!< \brief Starts blinking effect, its duration is counted again */
+
+  void RestoreEffect( cpFxShrink & shrink );
+  /*!< \brief Starts shrinking effect from full size */
+
+} // namespace Inv
+
+#endif
@@ -9,12 +9,15 @@
 
 #include <engine/InvENTTProcessors.h>
 #include <engine/InvENTTComponents.h>
+#include <engine/InvENTTCollisionLayers.h>
+#include <engine/InvENTTEffects.h>
 
 #include <graphics/CInvSprite.h>
 #include <graphics/CInvCollisionTest.h>
 #include <engine/CInvEntityFactory.h>
 #include <CInvSettings.h>
 #include <CInvSettingsRuntime.h>
+#include <CInvLogger.h>
 
 namespace Inv
 {
@@ -29,7 +32,10 @@ namespace Inv
     mSettings( settings ),
     mSettingsRuntime( settingsRuntime ),
     mRefTick( refTick ),
-    mIsSuspended( false )
+    mIsSuspended( false ),
+    mCommands(),
+    mScheduler( nullptr ),
+    mArena( nullptr )
   {}
 
   //--------------------------------------------------------------------------------------------------
@@ -74,10 +80,10 @@ namespace Inv
         if( stat.isDying || ! stat.isShootRequested )
           return;       // Alien did not request to shoot in this tick (or is dead and cannot shoot)
 
-        gph.standardSprite->GetResultingPosition(
+        gph.standardSprite.GetResultingPosition(
           xTopLeft, yTopLeft, xBottomRight, yBottomRight, xSize, ySize, imageIndex );
 
-        mEntityFactory.AddMissileEntity(
+        mEntityFactory.AddMissileEntity( mCommands,
           "SPIT", false,
           0.5f * ( xTopLeft + xBottomRight ),
           yBottomRight - 0.15f * ySize,
@@ -87,6 +93,8 @@ namespace Inv
         stat.isShootRequested = false;
                         // Shoot request is processed
     } );
+                        // Missiles are only recorded, they are created when the owner of the
+                        // processor applies mCommands (registry must not change during iteration)
 
   } // procEntitySpawner::update
 
@@ -191,10 +199,10 @@ namespace Inv
             if( stat.isDying )
               return;     // Player is dying, cannot shoot
 
-            gph.standardSprite->GetResultingPosition(
+            gph.standardSprite.GetResultingPosition(
               xTopLeft, yTopLeft, xBottomRight, yBottomRight, xSize, ySize, imageIndex );
 
-            mEntityFactory.AddMissileEntity(
+            mEntityFactory.AddMissileEntity( mCommands,
               "ROCKET", true,
               0.5f * ( xTopLeft + xBottomRight ),
               yBottomRight - 0.75f * ySize,
@@ -292,13 +300,109 @@ namespace Inv
     const CInvSettings & settings,
     CInvSettingsRuntime & settingsRuntime,
     float & vXGroup,
-    float & vYGroup ):
+    float & vYGroup,
+    CInvFormationIndex & formationIndex,
+    std::vector<entt::entity> & outOfScene,
+    float sceneTopLeftX,
+    float sceneTopLeftY,
+    float sceneBottomRightX,
+    float sceneBottomRightY ):
 
     procEnTTBase( refTick, settings, settingsRuntime ),
     mVXGroup( vXGroup ),
     mVYGroup( vYGroup ),
-    mFormationFreeze( false )
-  {}
+    mFormationIndex( formationIndex ),
+    mFormationFreeze( false ),
+    mRaiders(),
+    mFreeMovers(),
+    mIntegrateCull( nullptr ),
+    mBounds{ sceneTopLeftX, sceneTopLeftY, sceneBottomRightX, sceneBottomRightY },
+    mOutOfScene( outOfScene )
+  {
+    const char * kernelName = nullptr;
+    mIntegrateCull = SelectIntegrateCullKernel( &kernelName );
+    LOG << "Motion kernel selected: " << kernelName;
+  } // procActorMover::procActorMover
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procActorMover::reset(
+    LARGE_INTEGER refTick,
+    float sceneTopLeftX,
+    float sceneTopLeftY,
+    float sceneBottomRightX,
+    float sceneBottomRightY )
+  {
+    procEnTTBase::reset( refTick );
+    mBounds = { sceneTopLeftX, sceneTopLeftY, sceneBottomRightX, sceneBottomRightY };
+  } // procActorMover::reset
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procActorMover::MotionStream_t::clear()
+  {
+    positions.clear();
+    entities.clear();
+    x.clear();
+    y.clear();
+    vX.clear();
+    vY.clear();
+    halfW.clear();
+    halfH.clear();
+  } // procActorMover::MotionStream_t::clear
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procActorMover::MotionStream_t::push(
+    entt::entity entity, cpPosition & pos, const cpVelocity & vel, const cpGeometry & geo )
+  {
+    positions.push_back( &pos );
+    entities.push_back( entity );
+    x.push_back( pos.X );
+    y.push_back( pos.Y );
+    vX.push_back( vel.vX );
+    vY.push_back( vel.vY );
+    halfW.push_back( 0.5f * geo.width );
+    halfH.push_back( 0.5f * geo.height );
+  } // procActorMover::MotionStream_t::push
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procActorMover::integrate( MotionStream_t & stream, float scale )
+  {
+    size_t count = stream.x.size();
+    if( 0 == count )
+      return;
+
+    size_t words = ( count + gMotionBlock - 1 ) / gMotionBlock;
+    stream.outside.resize( words );
+
+    auto chunkFn = [&]( size_t chunk, size_t begin, size_t end )
+    {                   // Chunk consists of whole words of the mask, so chunks never write the same word
+      size_t first = begin * gMotionBlock;
+      size_t last = min( count, end * gMotionBlock );
+      mIntegrateCull(
+        stream.x.data() + first, stream.y.data() + first,
+        stream.vX.data() + first, stream.vY.data() + first,
+        stream.halfW.data() + first, stream.halfH.data() + first,
+        last - first, scale, mBounds, stream.outside.data() + begin );
+    };
+
+    size_t chunks = ( nullptr == mScheduler ) ? 1 : min( words, mScheduler->GetChunkCount( count, mParallelMinChunk ) );
+    if( chunks <= 1 )
+      chunkFn( 0, 0, words );
+    else
+      mScheduler->ParallelFor( words, chunks, chunkFn );
+
+    for( size_t index = 0; index < count; ++index )
+    {                   // New positions are written back, culled entities are collected in order
+      stream.positions[index]->X = stream.x[index];
+      stream.positions[index]->Y = stream.y[index];
+      if( 0 != ( stream.outside[index / gMotionBlock] & ( 1ull << ( index % gMotionBlock ) ) ) )
+        mOutOfScene.push_back( stream.entities[index] );
+    } // for
+
+  } // procActorMover::integrate
 
   //--------------------------------------------------------------------------------------------------
 
@@ -307,37 +411,34 @@ namespace Inv
     if( mIsSuspended )
       return;           // Processor is suspended, no action is performed
 
-    auto view = reg.view<cpPosition, const cpVelocity>();
-    view.each( [&]( entt::entity entity, cpPosition & pos, const cpVelocity & vel )
+    if( !mFormationFreeze )
+      mFormationIndex.Translate(
+        mVXGroup * mSettingsRuntime.mAlienSpeedupFactor,
+        mVYGroup * mSettingsRuntime.mAlienSpeedupFactor );
+                        // Whole formation (including places of raiding aliens) moves by group velocity
+                        // at once, aliens staying in formation are not touched at all.
+
+    mRaiders.clear();
+    mFreeMovers.clear();
+    mOutOfScene.clear();
+
+    auto viewR = reg.view<cpPosition, const cpVelocity, const cpGeometry, const cpAlienStatus>(
+      entt::exclude<cpInFormation> );
+    viewR.each( [&]( entt::entity entity, cpPosition & pos, const cpVelocity & vel, const cpGeometry & geo, const cpAlienStatus & )
+    {                   // Aliens in raid or returning to formation move by their own velocity
+        mRaiders.push( entity, pos, vel, geo );
+    } );
+
+    auto viewM = reg.view<cpPosition, const cpVelocity, const cpGeometry>(
+      entt::exclude<cpInFormation, cpAlienStatus> );
+    viewM.each( [&]( entt::entity entity, cpPosition & pos, const cpVelocity & vel, const cpGeometry & geo )
     {
-        auto [ aBehave, aStat ] = reg.try_get<cpAlienBehave, cpAlienStatus>( entity );
-        if( nullptr != aBehave && nullptr != aStat )
-        {               // Alien entity
-
-          if( !mFormationFreeze )
-          {             // Position in formation where alien belongs is updated by group velocity.
-            aStat->formationX += mVXGroup * mSettingsRuntime.mAlienSpeedupFactor;
-            aStat->formationY += mVYGroup * mSettingsRuntime.mAlienSpeedupFactor;
-          } // if
-
-          if( aStat->isInRaid || aStat->isReturningToFormation )
-          {             // Alien is in raid or returning to formation, moves by its own velocity
-            pos.X += vel.vX * mSettingsRuntime.mAlienSpeedupFactor;
-            pos.Y += vel.vY * mSettingsRuntime.mAlienSpeedupFactor;
-          } // if
-          else if( ! mFormationFreeze )
-          {             // Alien is in formation, moves by group velocity
-            pos.X += mVXGroup * mSettingsRuntime.mAlienSpeedupFactor;
-            pos.Y += mVYGroup * mSettingsRuntime.mAlienSpeedupFactor;
-          } // else
-        } // if
-        else
-        {
-          pos.X += vel.vX;
-          pos.Y += vel.vY;
-        } // else
+        mFreeMovers.push( entity, pos, vel, geo );
     } );
 
+    integrate( mRaiders, mSettingsRuntime.mAlienSpeedupFactor );
+    integrate( mFreeMovers, 1.0f );
+
   } // procActorMover::update
 
 
@@ -347,18 +448,272 @@ namespace Inv
     LARGE_INTEGER refTick,
     const CInvSettings & settings,
     CInvSettingsRuntime & settingsRuntime,
-    CInvCollisionTest & cTest ):
+    CInvCollisionTest & cTest,
+    CInvFormationIndex & formationIndex ):
 
     procEnTTBase( refTick, settings, settingsRuntime ),
-    mCTest( cTest )
+    mCTest( cTest ),
+    mFormationIndex( formationIndex ),
+    mNarrowphaseChunks(),
+    mStatCandidatesTested( 0 ),
+    mStatPairsHit( 0 ),
+    mPairCache(),
+    mCollisionTick( 0 ),
+    mMotionEpoch( 0 ),
+    mStatCacheLookups( 0 ),
+    mStatCacheHits( 0 )
   {}
 
   //--------------------------------------------------------------------------------------------------
 
-  void procCollisionDetector::update( entt::registry & reg, LARGE_INTEGER actTick, LARGE_INTEGER diffTick )
+  void procCollisionDetector::reset( LARGE_INTEGER refTick )
+  {
+    procEnTTBase::reset( refTick );
+
+    size_t chunks = ( nullptr == mScheduler ) ? 1 : mScheduler->GetMaxChunkCount();
+    if( mNarrowphaseChunks.size() < chunks )
+      mNarrowphaseChunks.resize( chunks, NarrowphaseChunk_t{ {}, {}, {}, {}, {}, 0, 0, 0, 0 } );
+
+    for( auto & chunk : mNarrowphaseChunks )
+    {                   // Capacity is kept between ticks, it grows only in exceptionally busy tick
+      chunk.candidates.reserve( mNarrowphaseReserve );
+      chunk.hits.reserve( mNarrowphaseReserve );
+      chunk.collidedPairs.reserve( mNarrowphaseReserve );
+      chunk.cacheStores.reserve( mNarrowphaseReserve );
+      chunk.cacheErases.reserve( mNarrowphaseReserve );
+    } // for
+
+  } // procCollisionDetector::reset
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procCollisionDetector::collectCollider(
+    std::vector<ColliderInfo_t> & colliders,
+    entt::entity entity,
+    const cpGraphics & gph,
+    cpCollisionMotion & motion,
+    const cpFormationSlot * slot,
+    const cpVelocity * sweep,
+    const cpCollisionMask * mask )
+  {
+    if( !gph.standardSprite.IsValid() )
+      return;
+
+    float xMin, xMax, yMin, yMax;
+    gph.standardSprite.GetResultingBoundingBox( xMin, xMax, yMin, yMax );
+
+    if( motion.lastTick != mCollisionTick )
+    {                   // Entity may be both dangerous and vulnerable, motion is updated only once
+      float centreX = 0.5f * ( xMin + xMax );
+      float centreY = 0.5f * ( yMin + yMax );
+      float vX = centreX - motion.centreX;
+      float vY = centreY - motion.centreY;
+
+      if( 0 == motion.epoch || motion.lastTick + 1 != mCollisionTick ||
+          mVelocityTolerance < fabsf( vX - motion.vX ) || mVelocityTolerance < fabsf( vY - motion.vY ) ||
+          mVelocityTolerance < fabsf( xMax - xMin - motion.width ) ||
+          mVelocityTolerance < fabsf( yMax - yMin - motion.height ) )
+      {                 // Motion changed (or entity was not seen in last tick), all predictions
+                        // made for the entity are invalidated by new epoch
+        motion.vX = vX;
+        motion.vY = vY;
+        motion.width = xMax - xMin;
+        motion.height = yMax - yMin;
+        motion.epoch = ( 0 == ++mMotionEpoch ) ? ++mMotionEpoch : mMotionEpoch;
+      } // if
+
+      motion.centreX = centreX;
+      motion.centreY = centreY;
+      motion.lastTick = mCollisionTick;
+    } // if
+
+    float sweepX = ( nullptr != sweep ) ? sweep->vX : 0.0f;
+    float sweepY = ( nullptr != sweep ) ? sweep->vY : 0.0f;
+
+    colliders.push_back( { entity, &gph.standardSprite, mCTest.GetScaledMask( gph.standardSprite ), slot,
+      floorf( min( xMin, xMin - sweepX ) ), ceilf( max( xMax, xMax - sweepX ) ),
+      floorf( min( yMin, yMin - sweepY ) ), ceilf( max( yMax, yMax - sweepY ) ),
+      sweepX, sweepY, motion.vX, motion.vY, motion.epoch,
+      ( nullptr != mask ) ? mask->mask : (uint32_t)clNone,
+      ( nullptr != mask ) && mask->removeOnHit } );
+                        // Box is rounded same way as in narrowphase test, so no pair
+                        // overlapping there can be missed by the grid. Box of moving entity
+                        // covers whole path travelled during the last tick.
+
+  } // procCollisionDetector::collectCollider
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procCollisionDetector::fillGrid(
+    CInvSpatialHash & grid,
+    const std::vector<ColliderInfo_t> & colliders,
+    CInvFormationIndex * formationIndex )
+  {
+    float cellSize = 1.0f;
+    for( const auto & col : colliders )
+      cellSize = max( cellSize, max( col.xMax - col.xMin, col.yMax - col.yMin ) );
+
+    grid.Clear( cellSize );
+    if( nullptr != formationIndex )
+      formationIndex->ClearOccupancy();
+
+    for( uint32_t index = 0; index < (uint32_t)colliders.size(); ++index )
+    {
+      const auto & col = colliders[index];
+      if( nullptr != formationIndex && nullptr != col.slot )
+        formationIndex->SetOccupied( col.slot->row, col.slot->column, index );
+      else
+        grid.Insert( index, col.xMin, col.xMax, col.yMin, col.yMax );
+    } // for
+
+    grid.Build();
+
+  } // procCollisionDetector::fillGrid
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procCollisionDetector::testCandidates(
+    NarrowphaseChunk_t & chunk,
+    const ColliderInfo_t & danger,
+    const CInvSpatialHash & grid,
+    const std::vector<ColliderInfo_t> & vulnerables,
+    bool firstHitOnly,
+    const CInvFormationIndex * formationIndex ) const
+  {
+    auto & candidates = chunk.candidates;
+    auto & hits = chunk.hits;
+
+    grid.QueryShared( danger.xMin, danger.xMax, danger.yMin, danger.yMax, candidates );
+
+    if( nullptr != formationIndex && !formationIndex->IsEmpty() )
+    {                   // Aliens in formation are looked up directly in the lattice columns
+                        // covered by the dangerous entity
+      auto gridCandidates = candidates.size();
+      formationIndex->Query( danger.xMin, danger.xMax, danger.yMin, danger.yMax, candidates );
+      if( gridCandidates != candidates.size() )
+        std::sort( candidates.begin(), candidates.end() );
+    } // if
+
+    hits.clear();
+    for( auto index : candidates )
+    {
+      const auto & vulner = vulnerables[index];
+      if( danger.entity == vulner.entity )
+        continue;
+
+      uint64_t key =
+        ( (uint64_t)entt::to_integral( danger.entity ) << 32 ) | (uint64_t)entt::to_integral( vulner.entity );
+
+      ++chunk.statCacheLookups;
+      auto cached = mPairCache.Find( key );
+      if( nullptr != cached && mCollisionTick < cached->readyTick &&
+          danger.epoch == cached->epochDanger && vulner.epoch == cached->epochVulner )
+      {                 // Pair is still too far apart to touch and neither entity changed its motion
+        ++chunk.statCacheHits;
+        continue;
+      } // if
+
+      ++chunk.statCandidatesTested;
+
+      float contactTime;
+      if( mCTest.AreInCollisionSwept( *danger.sprite, danger.scaled, danger.sweepX, danger.sweepY,
+                                      *vulner.sprite, vulner.scaled, &contactTime ) )
+      {
+        hits.push_back( { contactTime, vulner.entity } );
+        continue;
+      } // if
+
+      uint64_t freeTicks = ticksToContact( danger, vulner );
+      if( 1 < freeTicks )
+        chunk.cacheStores.push_back( { key, { danger.epoch, vulner.epoch, mCollisionTick + freeTicks } } );
+      else if( nullptr != cached )
+        chunk.cacheErases.push_back( key );
+                        // Key contains the dangerous entity, so no other chunk can touch the
+                        // same entry, deferred change gives the same result as immediate one
+    } // for
+
+    if( hits.empty() )
+      return;
+
+    float firstContact = hits.front().first;
+    for( const auto & hit : hits )
+      firstContact = min( firstContact, hit.first );
+
+    for( const auto & hit : hits )
+    {                   // Projectile removed on hit cannot fly through its first target and hit
+                        // another one further on its path
+      if( firstHitOnly && firstContact < hit.first )
+        continue;
+      chunk.collidedPairs.push_back( { danger.entity, hit.second } );
+      ++chunk.statPairsHit;
+    } // for
+
+  } // procCollisionDetector::testCandidates
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procCollisionDetector::mergeChunk( NarrowphaseChunk_t & chunk, CollidedPairs_t & collidedPairs )
+  {
+    collidedPairs.insert( collidedPairs.end(), chunk.collidedPairs.begin(), chunk.collidedPairs.end() );
+
+    for( const auto & store : chunk.cacheStores )
+      mPairCache.Store( store.first, store.second );
+                        // Pair refused by full cache is simply tested again in next tick
+    for( auto key : chunk.cacheErases )
+      mPairCache.Erase( key );
+
+    mStatCandidatesTested += chunk.statCandidatesTested;
+    mStatPairsHit += chunk.statPairsHit;
+    mStatCacheLookups += chunk.statCacheLookups;
+    mStatCacheHits += chunk.statCacheHits;
+
+    chunk.collidedPairs.clear();
+    chunk.cacheStores.clear();
+    chunk.cacheErases.clear();
+    chunk.statCandidatesTested = 0;
+    chunk.statPairsHit = 0;
+    chunk.statCacheLookups = 0;
+    chunk.statCacheHits = 0;
+
+  } // procCollisionDetector::mergeChunk
+
+  //--------------------------------------------------------------------------------------------------
+
+  uint64_t procCollisionDetector::ticksToContact( const ColliderInfo_t & danger, const ColliderInfo_t & vulner ) const
+  {
+    float relVX = danger.vX - vulner.vX;
+    float relVY = danger.vY - vulner.vY;
+                        // Motion of dangerous entity relative to the vulnerable one
+
+    auto axisTime = [&]( float min1, float max1, float min2, float max2, float relV ) -> float
+    {                   // Time for which boxes stay separated along one axis
+      if( max1 + mPairCacheMargin < min2 )
+        return ( mVelocityTolerance < relV ) ? ( min2 - max1 - mPairCacheMargin ) / relV : (float)mMaxSkipTicks;
+      if( max2 + mPairCacheMargin < min1 )
+        return ( relV < -mVelocityTolerance ) ? ( min1 - max2 - mPairCacheMargin ) / -relV : (float)mMaxSkipTicks;
+      return 0.0f;
+    };
+
+    float freeTime = max(
+      axisTime( danger.xMin, danger.xMax, vulner.xMin, vulner.xMax, relVX ),
+      axisTime( danger.yMin, danger.yMax, vulner.yMin, vulner.yMax, relVY ) );
+                        // Boxes can touch only when they overlap along both axes at once
+
+    if( (float)mMaxSkipTicks <= freeTime )
+      return mMaxSkipTicks;
+    return (uint64_t)freeTime;
+
+  } // procCollisionDetector::ticksToContact
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procCollisionDetector::update(
+    entt::registry & reg,
+    LARGE_INTEGER actTick,
+    LARGE_INTEGER diffTick,
+    CollidedPairs_t & collidedPairs )
   {
 
-    mCollidedPairs.clear();
     mCanDamage.clear();
     mCanBeDamagedAlien.clear();
     mCanBeDamagedPlayer.clear();
@@ -366,73 +721,70 @@ namespace Inv
     if( mIsSuspended )
       return;           // Processor is suspended, no action is performed
 
-    auto viewDmg = reg.view<cpId, cpDamage, cpGraphics>();
-    viewDmg.each( [&]( entt::entity entity, const auto & id, const auto & dmg, const auto & gph )
-    {
-        if( ! id.active || gph.isHidden)
-          return;       // Hidden or inactive entity does not deal damage
-        mCanDamage.insert( entity );
-    } );
+    ++mCollisionTick;
+    mCTest.StartScaledMaskUse();
+    if( 0 == ( mCollisionTick % mMaxSkipTicks ) )
+      mPairCache.EraseExpired( mCollisionTick );
+                        // Expired entries (including those of destroyed entities) are pruned
+
+    auto groupDmg = reg.group<cpCollisionMask>( entt::get<cpGraphics, cpVelocity, cpCollisionMotion> );
+    for( auto [ entity, mask, gph, vel, motion ] : groupDmg.each() )
+      collectCollider( mCanDamage, entity, gph, motion, nullptr, mask.isSwept ? &vel : nullptr, &mask );
+                        // Dangerous entities are iterated in packed order of their collision masks,
+                        // state of entities was evaluated already when the masks were set.
 
-    auto viewHealth = reg.view<cpId, cpHealth, cpGraphics>();
-    viewHealth.each( [&]( entt::entity entity, const auto & id, const auto & hlt, const auto & gph)
+    auto groupLayer = reg.group<cpCollisionLayer>( entt::get<cpGraphics, cpCollisionMotion> );
+    for( auto [ entity, layer, gph, motion ] : groupLayer.each() )
     {
-        if( ! id.active || gph.isHidden )
-          return;       // Hidden entity cannot be hit
+      if( 0 != ( layer.layer & clAlien ) )
+      {                 // Displacement of lattice is maintained by procActorMover
+        collectCollider( mCanBeDamagedAlien, entity, gph, motion, layer.inFormation ? &layer.slot : nullptr );
+      } // if
 
-      auto [ bAlien, sAlien ] = reg.try_get<cpAlienBehave, cpAlienStatus>( entity );
-      if( nullptr != bAlien && nullptr != sAlien && ! sAlien->isDying )
-        mCanBeDamagedAlien.insert( entity );
+      if( 0 != ( layer.layer & clPlayer ) )
+        collectCollider( mCanBeDamagedPlayer, entity, gph, motion );
+    } // for
 
-      auto [bBossAlien, sBossAlien] = reg.try_get<cpAlienBehave, cpAlienBossStatus>( entity );
-      if( nullptr != bBossAlien && nullptr != sBossAlien && !sBossAlien->isDying )
-        mCanBeDamagedAlien.insert( entity );
+    auto byEntity = []( const ColliderInfo_t & a, const ColliderInfo_t & b ) { return a.entity < b.entity; };
+    std::sort( mCanDamage.begin(), mCanDamage.end(), byEntity );
+    std::sort( mCanBeDamagedAlien.begin(), mCanBeDamagedAlien.end(), byEntity );
+    std::sort( mCanBeDamagedPlayer.begin(), mCanBeDamagedPlayer.end(), byEntity );
+                        // Entities are processed in order of their identifiers, so the order of
+                        // collided pairs does not depend on storage order in registry.
 
-      auto [ bPlayer, sPlayer ] = reg.try_get<cpPlayBehave, cpPlayStatus>( entity );
-      if( nullptr != bPlayer && nullptr != sPlayer && ! sPlayer->isDying && ! sPlayer->isInvulnerable )
-        mCanBeDamagedPlayer.insert( entity );
-    } );
+    fillGrid( mGridAlien, mCanBeDamagedAlien, &mFormationIndex );
+    fillGrid( mGridPlayer, mCanBeDamagedPlayer );
+                        // Broadphase - vulnerable entities are binned in uniform grid (or formation
+                        // lattice), only those near to dangerous entity are tested in narrowphase.
 
-    for( auto dangerousEntity : mCanDamage )
+    size_t chunks = ( nullptr == mScheduler ) ? 1 : mScheduler->GetChunkCount( mCanDamage.size(), mParallelMinChunk );
+    if( mNarrowphaseChunks.size() < chunks )
+      mNarrowphaseChunks.resize( chunks, NarrowphaseChunk_t{ {}, {}, {}, {}, {}, 0, 0, 0, 0 } );
+                        // Chunks are prepared by reset(), this happens only if it was not called
+
+    auto testChunk = [&]( size_t chunk, size_t begin, size_t end )
     {
-      auto [dmgDanger, gphDanger] = reg.try_get<cpDamage, cpGraphics>( dangerousEntity );
+      for( size_t i = begin; i < end; ++i )
+      {
+        const auto & danger = mCanDamage[i];
+        if( 0 != ( danger.mask & clAlien ) )
+          testCandidates( mNarrowphaseChunks[chunk], danger, mGridAlien, mCanBeDamagedAlien, danger.removeOnHit, &mFormationIndex );
 
-      if( nullptr == dmgDanger || nullptr == gphDanger )
-        continue;
+        if( 0 != ( danger.mask & clPlayer ) )
+          testCandidates( mNarrowphaseChunks[chunk], danger, mGridPlayer, mCanBeDamagedPlayer, danger.removeOnHit );
+      } // for
+    };
 
-      if( dmgDanger->dangerToAliens )
-      {
-        for( auto vulnerableEntity : mCanBeDamagedAlien )
-        {
-          if( dangerousEntity == vulnerableEntity )
-            continue;
-          auto [hltVulner, gphVulner] = reg.try_get<cpHealth, cpGraphics>( vulnerableEntity );
-          if( nullptr == hltVulner || nullptr == gphVulner )
-            continue;
-          if( nullptr == gphDanger->standardSprite || nullptr == gphVulner->standardSprite )
-            continue;
-          if( mCTest.AreInCollision( *(gphDanger->standardSprite), *(gphVulner->standardSprite) ) )
-            mCollidedPairs.push_back( { dangerousEntity, vulnerableEntity } );
-        } // for
-      }
-
-      if( dmgDanger->dangerToPlayer )
-      {
-        for( auto vulnerableEntity : mCanBeDamagedPlayer )
-        {
-          if( dangerousEntity == vulnerableEntity )
-            continue;
-          auto [hltVulner, gphVulner] = reg.try_get<cpHealth, cpGraphics>( vulnerableEntity );
-          if( nullptr == hltVulner || nullptr == gphVulner )
-            continue;
-          if( nullptr == gphDanger->standardSprite || nullptr == gphVulner->standardSprite )
-            continue;
-          if( mCTest.AreInCollision( *( gphDanger->standardSprite ), *( gphVulner->standardSprite ) ) )
-            mCollidedPairs.push_back( { dangerousEntity, vulnerableEntity } );
-        } // for
-      } // if
+    if( 1 < chunks )
+      mScheduler->ParallelFor( mCanDamage.size(), chunks, testChunk );
+    else
+      testChunk( 0, 0, mCanDamage.size() );
+                        // Narrowphase - dangerous entities are split into chunks tested concurrently,
+                        // grids, formation index and pair cache are only read meanwhile.
 
-    } // for
+    for( size_t chunk = 0; chunk < chunks; ++chunk )
+      mergeChunk( mNarrowphaseChunks[chunk], collidedPairs );
+                        // Chunks keep their own vectors, the arena is not thread safe
 
   } // procCollisionDetector::update
 
@@ -444,32 +796,18 @@ namespace Inv
     LARGE_INTEGER refTick,
     const CInvSettings & settings,
     CInvSettingsRuntime & settingsRuntime,
-    float sceneTopLeftX,
-    float sceneTopLeftY,
-    float sceneBottomRightX,
-    float sceneBottomRightY ):
+    std::vector<entt::entity> & outOfScene ):
 
     procEnTTBase( refTick, settings, settingsRuntime ),
-    mSceneTopLeftX( sceneTopLeftX ),
-    mSceneTopLeftY( sceneTopLeftY ),
-    mSceneBottomRightX( sceneBottomRightX ),
-    mSceneBottomRightY( sceneBottomRightY )
+    mOutOfScene( outOfScene )
   {}
 
   //--------------------------------------------------------------------------------------------------
 
-  void procActorOutOfSceneCheck::reset(
-    LARGE_INTEGER refTick,
-    float sceneTopLeftX,
-    float sceneTopLeftY,
-    float sceneBottomRightX,
-    float sceneBottomRightY )
+  void procActorOutOfSceneCheck::reset( LARGE_INTEGER refTick )
   {
     procEnTTBase::reset( refTick );
-    mSceneTopLeftX = sceneTopLeftX;
-    mSceneTopLeftY = sceneTopLeftY;
-    mSceneBottomRightX = sceneBottomRightX;
-    mSceneBottomRightY = sceneBottomRightY;
+    mOutOfScene.clear();
   } // procActorOutOfSceneCheck::reset
 
   //--------------------------------------------------------------------------------------------------
@@ -479,19 +817,15 @@ namespace Inv
     if( mIsSuspended )
       return;           // Processor is suspended, no action is performed
 
-    auto view = reg.view<cpId, const cpPosition, const cpGeometry>();
-    view.each( [=]( cpId & id, const cpPosition & pos, const cpGeometry & geo )
-    {
-       if( ( pos.X + 0.5f * geo.width < mSceneTopLeftX )     ||
-           ( mSceneBottomRightX < pos.X - 0.5f * geo.width ) ||
-           ( pos.Y + 0.5f * geo.height < mSceneTopLeftY )    ||
-           ( mSceneBottomRightY < pos.Y - 0.5f * geo.height ) )
-       {
-         id.active = false;
+    for( auto entity : mOutOfScene )
+    {                   // Aliens staying in formation were not checked, formation is kept within
+                        // the scene by procAlienBoundsGuard
+      DeactivateEntity( reg, entity );
                         // Entity is out of scene, remove it from registry later
-       } // if
+    } // for
+
+    mOutOfScene.clear();
 
-    } );
   } // procActorOutOfSceneCheck::update
 
 
@@ -516,29 +850,106 @@ namespace Inv
     LARGE_INTEGER diffTick,
     bool allowCallbacks )
   {
-    mEntities.clear();
-
     /* No suspended state for garbage collector! */
 
-    auto view = reg.view<cpId>();
-    for( auto entity : view )
-    {
-      auto & entId = view.get<cpId>( entity );
-      if( !entId.active )
-      {                 // Entity is marked as inactive and it will be remove from registry.
+    const auto & pending = reg.storage<cpPendingDestroy>();
+    if( pending.empty() )
+      return;           // Usual case, no entity was deactivated and no living one is visited
+
+    std::pmr::vector<entt::entity> pruned( pending.data(), pending.data() + pending.size(), tickResource() );
+                        // Tagged entities are copied, prune callbacks may deactivate other entities
+                        // (they are pruned in next tick)
+
+    std::pmr::vector<entt::entity> destroyed( tickResource() );
+    std::pmr::vector<entt::entity> parking( tickResource() );
+    destroyed.reserve( pruned.size() );
+                        // Pruned entities are either destroyed or, if they belong to a pool, parked
+
+    for( auto entity : pruned )
+    {                   // Entity is marked as inactive and it will be remove from registry.
                         // If it should send notification on pruning, it is done now.
-        if( allowCallbacks && entId.noticeOnPruning && nullptr != mPruneCallback )
-          mPruneCallback( entity, (uint32_t)entId.id );
-        mEntities.push_back( entity );
-      } // if
+      auto entId = reg.try_get<cpId>( entity );
+      if( nullptr != entId && allowCallbacks && entId->noticeOnPruning && nullptr != mPruneCallback )
+        mPruneCallback( entity, (uint32_t)entId->id );
+      if( reg.all_of<cpPooled>( entity ) )
+        parking.push_back( entity );
+      else
+        destroyed.push_back( entity );
     }  // for
 
-    for( auto entity : mEntities )
-      reg.destroy( entity );
-                        // Remove all entities marked as inactive
+    reg.destroy( destroyed.begin(), destroyed.end() );
+                        // Remove all entities marked as inactive at once
+
+    for( auto entity : parking )
+      reg.get<cpPooled>( entity ).pool->Park( reg, entity );
+                        // Pooled entities wait for reuse
 
   } // procGarbageCollector::update
 
+  //****** processor: animation of actors ************************************************************
+
+  procActorAnimator::procActorAnimator(
+    LARGE_INTEGER refTick,
+    const CInvSettings & settings,
+    CInvSettingsRuntime & settingsRuntime,
+    const CInvFormationIndex & formationIndex ):
+
+    procEnTTBase( refTick, settings, settingsRuntime ),
+    mFormationIndex( formationIndex )
+  {}
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procActorAnimator::updateSprite(
+    cpGraphics & gph, float posX, float posY, const cpGeometry & geo, LARGE_INTEGER actTick )
+  {
+    if( gph.isHidden || !gph.standardSprite.IsValid() )
+      return;           // Entity is hidden, it is neither animated nor drawn
+
+    gph.diffTick.QuadPart++;
+                        // Sprite animations are driven by tick count stored in cpGraphics component.
+                        // It must not be dependent on global tick counter, because each entity starts
+                        // its animations independently at random time.
+
+    gph.standardSprite.Place( posX, posY, geo.width, geo.height, gph.staticStandardImageIndex );
+
+  } // procActorAnimator::updateSprite
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procActorAnimator::update(
+    entt::registry & reg, LARGE_INTEGER actTick, LARGE_INTEGER diffTick )
+  {
+    if( mIsSuspended )
+      return;           // Processor is suspended, no action is performed
+
+    float dX = mFormationIndex.GetDisplacementX();
+    float dY = mFormationIndex.GetDisplacementY();
+    auto viewF = reg.view<cpGraphics, const cpAlienBehave, const cpGeometry, const cpInFormation>();
+    viewF.each( [&]( cpGraphics & gph, const cpAlienBehave & behave, const cpGeometry & geo )
+    {                   // Aliens in formation, position is derived from displacement of formation
+        updateSprite( gph, behave.startingX + dX, behave.startingY + dY, geo, actTick );
+    } );
+
+    auto view = reg.view<cpGraphics, const cpPosition, const cpGeometry>( entt::exclude<cpInFormation> );
+    view.each( [&]( cpGraphics & gph, const cpPosition & pos, const cpGeometry & geo )
+    {
+        updateSprite( gph, pos.X, pos.Y, geo, actTick );
+    } );
+
+    ApplySpriteEffects( reg );
+                        // Effects are applied on all placed sprites at once, type by type
+
+    auto viewG = reg.view<cpGraphics>( entt::exclude<cpParked> );
+    viewG.each( []( cpGraphics & gph )
+    {
+      if( !gph.isHidden && gph.standardSprite.IsValid() )
+        gph.standardSprite.FinishUpdate();
+    } );
+
+  } // procActorAnimator::update
+
+
   //****** processor: rendering of actors ************************************************************
 
   procActorRender::procActorRender(
@@ -554,36 +965,26 @@ namespace Inv
   void procActorRender::update(
     entt::registry & reg, LARGE_INTEGER actTick, LARGE_INTEGER diffTick )
   {
-    for( auto & item : mZAxisSorting )
-      item.second.clear();
-                        // Clear sorting structure before use (possibly without deleting the memory structures
-                        // from previous usage)
-
     if( mIsSuspended )
       return;           // Processor is suspended, no action is performed
 
-    auto view = reg.view< cpGraphics, const cpPosition, const cpGeometry>();
-    view.each( [=]( cpGraphics & gph, const cpPosition & pos, const cpGeometry & geo )
+    std::pmr::map<float, std::pmr::vector<const CInvSprite *>> zAxisSorting( tickResource() );
+                        // Sprites sorted according to Z axis level, nodes and lists are allocated from
+                        // the tick arena (lists get the same resource from the map)
+
+    auto view = reg.view<const cpGraphics, const cpPosition, const cpGeometry>();
+    view.each( [&]( const cpGraphics & gph, const cpPosition & pos, const cpGeometry & geo )
     {
-        if( gph.isHidden )
+        if( gph.isHidden || !gph.standardSprite.IsValid() )
           return;       // Entity is hidden, do not draw it
 
-        mZAxisSorting[gph.standardSprite->GetLevel()].emplace_back( gph.standardSprite, gph, pos, geo );
-        gph.diffTick.QuadPart++;
-    } );                // Sprite animations are driven by tick count stored in cpGraphics component.
-                        // It must not be dependent on global tick counter, because each entity starts
-                        // its animations independently at random time.
+        zAxisSorting[gph.standardSprite.GetLevel()].push_back( &gph.standardSprite );
+    } );
 
-    for( auto & item : mZAxisSorting )
+    for( auto & item : zAxisSorting )
     {
-      for( auto & item2 : item.second )
-      {
-        item2.sprite->Draw(
-          item2.pos.X, item2.pos.Y,
-          item2.geo.width, item2.geo.height,
-          actTick, actTick, item2.gph.diffTick,
-          item2.gph.staticStandardImageIndex );
-      } // for
+      for( auto sprite : item.second )
+        sprite->Render();
     } // for
 
   } // procActorRender::update
@@ -595,10 +996,12 @@ namespace Inv
     LARGE_INTEGER refTick,
     const CInvSettings & settings,
     CInvSettingsRuntime & settingsRuntime,
-    bool & isInDangerousArea ):
+    bool & isInDangerousArea,
+    const CInvFormationIndex & formationIndex ):
 
     procEnTTBase( refTick, settings, settingsRuntime ),
-    mIsInDangerousArea( isInDangerousArea )
+    mIsInDangerousArea( isInDangerousArea ),
+    mFormationIndex( formationIndex )
   {}
 
 
@@ -610,17 +1013,9 @@ namespace Inv
     LARGE_INTEGER diffTick )
   {
     float minAlienY = 1e25f;
-
-    auto viewA = reg.view<const cpAlienBehave, cpAlienStatus, cpPosition>();
-    viewA.each( [&]( const cpAlienBehave & behave, cpAlienStatus & status, cpPosition & pos )
-    {                   // Searching for highest alien position
-
-      if( status.isDying )
-        return;         // Alien is dying, does not count
-
-      if( pos.Y < minAlienY )
-        minAlienY = pos.Y;
-    } );
+    mFormationIndex.GetStayingTop( minAlienY );
+                        // Highest living alien staying in formation, maintained by the lattice as
+                        // aliens die or leave the formation. Raiders do not count, they come back.
 
     mIsInDangerousArea = false;
     auto viewP = reg.view<const cpPlayBehave, cpPlayStatus, cpPosition>();
@@ -10,11 +10,20 @@
 #ifndef H_InvENTTProcessors
 #define H_InvENTTProcessors
 
+#include <unordered_map>
+
 #include <entity/registry.hpp>
 
 #include <InvGlobals.h>
 #include <CInvSoundsStorage.h>
 #include <engine/InvENTTComponents.h>
+#include <engine/CInvSpatialHash.h>
+#include <engine/CInvFormationIndex.h>
+#include <engine/CInvPairCache.h>
+#include <engine/CInvProcessorScheduler.h>
+#include <engine/CInvCommandBuffer.h>
+#include <engine/CInvTickArena.h>
+#include <engine/InvMotionKernels.h>
 
 namespace Inv
 {
@@ -22,9 +31,6 @@ namespace Inv
   using FnEventCallback_t = std::function<void( uint32_t )>;
   //!< Type definition for event callback without entity id
 
-  using FnEventCallbackEithEntityId_t = std::function<void( entt::entity, uint32_t )>;
-  //!< Type definition for event callback with entity id
-
 #define BIND_MEMBER_EVENT_CALLBACK( ref, fnName )  std::bind( &fnName, (ref), std::placeholders::_1, std::placeholders::_2 )
   //!< Macro to simplify binding of member function as event callback
 
@@ -58,6 +64,64 @@ namespace Inv
     bool mIsSuspended;
     //!< \brief If true, the processor does not perform any action in update() method.
 
+    CInvCommandBuffer mCommands;
+    //!< \brief Structural changes of registry requested by the processor (new entities and so on),
+    //!  applied at the sync point by the owner of the processor or by the processor itself
+
+    CInvProcessorScheduler * mScheduler;
+    //!< \brief Scheduler whose thread pool processes chunks of large loops, if nullptr, all loops
+    //!  are run on the calling thread.
+
+    CInvTickArena * mArena;
+    //!< \brief Arena of actual tick, transient working sets of the processor are allocated from it.
+    //!  If nullptr, they are allocated from the heap.
+
+    std::pmr::memory_resource * tickResource() const
+    { return ( nullptr == mArena ) ? std::pmr::get_default_resource() : mArena->GetResource(); }
+    /*!< \brief Returns memory resource for containers which live only during update() */
+
+    static constexpr size_t mParallelMinChunk = 256;
+    //!< \brief Minimal number of entities in one chunk of loop, views smaller than two chunks are
+    //!  processed on the calling thread without any synchronization
+
+    template<typename View>
+    size_t chunkCount( const View & view ) const
+    {
+      auto handle = view.handle();
+      if( nullptr == mScheduler || nullptr == handle )
+        return 1;
+      return mScheduler->GetChunkCount( handle->size(), mParallelMinChunk );
+    } // chunkCount
+    /*!< \brief Returns number of chunks eachChunked() splits the view into, so that the processor
+         can prepare per-chunk partial results. */
+
+    template<typename View, typename Fn>
+    void eachChunked( const View & view, size_t chunks, Fn && fn )
+    {
+      auto handle = view.handle();
+      if( nullptr == handle || handle->empty() )
+        return;
+
+      auto chunkFn = [&]( size_t chunk, size_t begin, size_t end )
+      {
+        for( size_t pos = begin; pos < end; ++pos )
+        {
+          entt::entity entity = ( *handle )[pos];
+          if( view.contains( entity ) )
+            fn( chunk, entity );
+        } // for
+      };
+
+      if( nullptr == mScheduler || chunks <= 1 )
+        chunkFn( 0, 0, handle->size() );
+      else
+        mScheduler->ParallelFor( handle->size(), chunks, chunkFn );
+    } // eachChunked
+    /*!< \brief Calls \e fn( chunk, entity ) for every entity of the view. Leading storage of the view
+         is split into given number of chunks (see chunkCount()), which are processed concurrently.
+         Function must not change structure of the registry and must write only components of
+         given entity and per-chunk data. */
+
   };
 
 
@@ -196,19 +260,77 @@ namespace Inv
       const CInvSettings & settings,
       CInvSettingsRuntime & settingsRuntime,
       float & vXGroup,
-      float & vYGroup );
+      float & vYGroup,
+      CInvFormationIndex & formationIndex,
+      std::vector<entt::entity> & outOfScene,
+      float sceneTopLeftX,
+      float sceneTopLeftY,
+      float sceneBottomRightX,
+      float sceneBottomRightY );
+
+    void reset(
+      LARGE_INTEGER refTick,
+      float sceneTopLeftX,
+      float sceneTopLeftY,
+      float sceneBottomRightX,
+      float sceneBottomRightY );
 
     void update( entt::registry & reg, LARGE_INTEGER actTick, LARGE_INTEGER diffTick );
+    /*!< \brief Formation of aliens is moved by single translation of its displacement, only entities
+         not staying in formation are moved one by one. They are gathered into two streams of arrays,
+         raiding aliens (moved with speedup of aliens) and free movers (missiles, bosses, explosions,
+         player), so the kernel has no branches. Entities which left the scene are found in the same
+         sweep and handed over to procActorOutOfSceneCheck. */
 
     float & mVXGroup;
     //!< \brief Reference to current velocity of alien formation in X axis
     float & mVYGroup;
     //!< \brief Reference to current velocity of alien formation in Y axis
 
+    CInvFormationIndex & mFormationIndex;
+    //<! \brief Reference to lattice of alien formation, which holds displacement of the formation
+
     bool mFormationFreeze;
     //!< \brief If true, aliens in formation do not move. It is used when player is respawned.
     //!  Aliens on raid, however, returns to its position in formation freely.
 
+    struct MotionStream_t
+    {
+      std::vector<cpPosition *> positions;
+      std::vector<entt::entity> entities;
+      std::vector<float> x;
+      std::vector<float> y;
+      std::vector<float> vX;
+      std::vector<float> vY;
+      std::vector<float> halfW;
+      std::vector<float> halfH;
+      std::vector<uint64_t> outside;
+
+      void clear();
+      void push( entt::entity entity, cpPosition & pos, const cpVelocity & vel, const cpGeometry & geo );
+    };
+    //<! \brief Entities moved by the same velocity scale, structure of arrays. Vectors keep their
+    //!  capacity between ticks.
+
+    void integrate( MotionStream_t & stream, float scale );
+    //<! \brief Moves the stream by the kernel (chunks of whole mask words run concurrently), writes
+    //!  positions back and collects entities out of scene
+
+    MotionStream_t mRaiders;
+    //<! \brief Aliens in raid or returning to formation, working variable
+
+    MotionStream_t mFreeMovers;
+    //<! \brief Entities other than aliens, working variable
+
+    FnIntegrateCull_t mIntegrateCull;
+    //<! \brief Kernel selected for the CPU the game runs on
+
+    MotionBounds_t mBounds;
+    //<! \brief Scene rectangle, entities entirely outside of it are culled
+
+    std::vector<entt::entity> & mOutOfScene;
+    //<! \brief Reference to list of entities found out of scene in actual tick
+
   }; // procActorMover
 
 
@@ -223,24 +345,168 @@ namespace Inv
       LARGE_INTEGER refTick,
       const CInvSettings & settings,
       CInvSettingsRuntime & settingsRuntime,
-      CInvCollisionTest & cTest );
+      CInvCollisionTest & cTest,
+      CInvFormationIndex & formationIndex );
 
-    void update( entt::registry & reg, LARGE_INTEGER actTick, LARGE_INTEGER diffTick );
+    using CollidedPairs_t = std::pmr::vector<std::pair<entt::entity, entt::entity>>;
+    //!< List of pairs of entities that collided. First is dangerous entity, second is entity that
+    //!  can be damaged.
+
+    void reset( LARGE_INTEGER refTick );
+    /*!< \brief Besides the base reset, prepares working data of narrowphase chunks for the largest
+         number of chunks the scheduler can split the work to, so the tick does not allocate them. */
+
+    void update(
+      entt::registry & reg,
+      LARGE_INTEGER actTick,
+      LARGE_INTEGER diffTick,
+      CollidedPairs_t & collidedPairs );
+    /*!< \brief Pairs of entities collided in actual tick are appended to \e collidedPairs, which
+         is usually allocated from the tick arena by the caller and processed before the arena is
+         reset. */
 
     CInvCollisionTest & mCTest;
     //<! \brief Reference to collision test object, used to detect collisions between sprites
 
-    std::set<entt::entity> mCanDamage;
-    //!< List of entities that can deal damage, working variable|
+    CInvFormationIndex & mFormationIndex;
+    //<! \brief Reference to lattice of alien formation, aliens staying in formation are searched
+    //!  there instead of in the broadphase grid
 
-    std::set<entt::entity> mCanBeDamagedAlien;
-    //!< List of alien entities that can be , working variable|
-    std::set<entt::entity> mCanBeDamagedPlayer;
-    //!< List of player entities that can be damaged, working variable|
+    using ColliderInfo_t = struct
+    {
+      entt::entity entity;
+      const CInvSprite * sprite;
+      const CInvCollisionMask * scaled;
+      const cpFormationSlot * slot;
+      float xMin;
+      float xMax;
+      float yMin;
+      float yMax;
+      float sweepX;
+      float sweepY;
+      float vX;
+      float vY;
+      uint32_t epoch;
+      uint32_t mask;
+      bool removeOnHit;
+    };
 
-    std::vector<std::pair<entt::entity, entt::entity>> mCollidedPairs;
-    //!< List of pairs of entities that collided in the last update. First is dangerous
-    //!  entity, second is entity that can be damaged.
+    using NarrowphaseChunk_t = struct
+    {
+      std::vector<uint32_t> candidates;
+      std::vector<std::pair<float, entt::entity>> hits;
+      std::vector<std::pair<entt::entity, entt::entity>> collidedPairs;
+      std::vector<std::pair<uint64_t, CInvPairCache::Entry_t>> cacheStores;
+      std::vector<uint64_t> cacheErases;
+      uint64_t statCandidatesTested;
+      uint64_t statPairsHit;
+      uint64_t statCacheLookups;
+      uint64_t statCacheHits;
+    };
+    //!< \brief Working data of one chunk of dangerous entities tested in narrowphase. Results are
+    //!  merged into members of the detector in order of chunks when all chunks are finished, so the
+    //!  pair cache is only read during the test.
+
+    void collectCollider(
+      std::vector<ColliderInfo_t> & colliders,
+      entt::entity entity,
+      const cpGraphics & gph,
+      cpCollisionMotion & motion,
+      const cpFormationSlot * slot = nullptr,
+      const cpVelocity * sweep = nullptr,
+      const cpCollisionMask * mask = nullptr );
+    /*!< \brief Adds entity to given list of colliders, with bounding box of its sprite as it was
+         actually drawn (i.e. the same area that is examined by narrowphase test). If the slot
+         is given, the entity is alien staying in formation. If the velocity is given, the entity
+         is projectile and its bounding box is swept back along the path travelled in last tick.
+         If the mask is given, the entity is dangerous one. Observed motion of the entity
+         (cpCollisionMotion, read from the group together with graphics) is updated as well. Scaled collision mask of the sprite is obtained
+         here, narrowphase running on more threads then only reads it. */
+
+    void fillGrid(
+      CInvSpatialHash & grid,
+      const std::vector<ColliderInfo_t> & colliders,
+      CInvFormationIndex * formationIndex = nullptr );
+    /*!< \brief Clears grid and bins all given colliders in it. The size of cells is set to the
+         size of the largest collider, so each collider occupies at most 2x2 cells. If formation
+         index is given, colliders staying in formation are marked in it instead of the grid. */
+
+    void testCandidates(
+      NarrowphaseChunk_t & chunk,
+      const ColliderInfo_t & danger,
+      const CInvSpatialHash & grid,
+      const std::vector<ColliderInfo_t> & vulnerables,
+      bool firstHitOnly,
+      const CInvFormationIndex * formationIndex = nullptr ) const;
+    /*!< \brief Queries the grid (and formation index, if given) for entities near to dangerous
+         entity and runs narrowphase (swept, if the dangerous entity moves) test on them. Collided
+         pairs are stored in the chunk. If \e firstHitOnly is set, only entities hit at the
+         earliest time of contact along the path are reported (projectile disappears on hit).
+         Pairs which cannot touch before the tick predicted in mPairCache are skipped, new
+         predictions are stored in the chunk as well. Method may run on more threads at once. */
+
+    void mergeChunk( NarrowphaseChunk_t & chunk, CollidedPairs_t & collidedPairs );
+    /*!< \brief Moves results of narrowphase chunk to \e collidedPairs, mPairCache and statistics */
+
+    uint64_t ticksToContact( const ColliderInfo_t & danger, const ColliderInfo_t & vulner ) const;
+    /*!< \brief Returns number of ticks during which given pair surely cannot collide, provided both
+         entities keep their actual velocities (zero if the pair must be tested every tick). */
+
+    static constexpr float mPairCacheMargin = 2.0f;
+    //!< Distance of bounding boxes [px] kept as reserve when contact tick is predicted (boxes are
+    //!  rounded to whole pixels in narrowphase)
+
+    static constexpr float mVelocityTolerance = 1e-3f;
+    //!< Change of observed velocity [px/tick] which is not yet considered as change of motion
+
+    static constexpr uint64_t mMaxSkipTicks = 64;
+    //!< Maximal number of ticks for which the pair may be skipped, so that entries of destroyed
+    //!  entities expire soon
+
+    static constexpr size_t mNarrowphaseReserve = 256;
+    //!< Initial capacity of vectors of narrowphase chunk, enough for usual scene
+
+    std::vector<ColliderInfo_t> mCanDamage;
+    //!< List of entities that can deal damage, working variable
+
+    std::vector<ColliderInfo_t> mCanBeDamagedAlien;
+    //!< List of alien entities that can be damaged, working variable
+
+    std::vector<ColliderInfo_t> mCanBeDamagedPlayer;
+    //!< List of player entities that can be damaged, working variable
+
+    CInvSpatialHash mGridAlien;
+    //!< Broadphase grid containing alien entities that can be damaged
+
+    CInvSpatialHash mGridPlayer;
+    //!< Broadphase grid containing player entities that can be damaged
+
+    std::vector<NarrowphaseChunk_t> mNarrowphaseChunks;
+    //!< Working data of chunks of dangerous entities tested in narrowphase, prepared by reset()
+    //!  and kept between ticks. Chunks are filled concurrently, so their vectors cannot come from
+    //!  the tick arena; they are reserved in advance instead and keep their capacity.
+
+    uint64_t mStatCandidatesTested;
+    //!< Number of candidate pairs passed from broadphase to narrowphase test (since start)
+
+    uint64_t mStatPairsHit;
+    //!< Number of candidate pairs which were actually in collision (since start)
+
+    CInvPairCache mPairCache;
+    //!< Pairs of entities (dangerous entity in upper 32 bits of key, vulnerable in lower) which
+    //!  were near but not in contact, with the tick in which they could touch at the earliest
+
+    uint64_t mCollisionTick;
+    //!< Number of updates performed (not suspended), time base of mPairCache
+
+    uint32_t mMotionEpoch;
+    //!< Last epoch assigned to motion of some entity (see cpCollisionMotion)
+
+    uint64_t mStatCacheLookups;
+    //!< Number of candidate pairs looked up in mPairCache (since start)
+
+    uint64_t mStatCacheHits;
+    //!< Number of candidate pairs skipped thanks to mPairCache (since start)
 
   }; // procCollisionDetector
 
@@ -254,28 +520,16 @@ namespace Inv
       LARGE_INTEGER refTick,
       const CInvSettings & settings,
       CInvSettingsRuntime & settingsRuntime,
-      float sceneTopLeftX,
-      float sceneTopLeftY,
-      float sceneBottomRightX,
-      float sceneBottomRightY );
+      std::vector<entt::entity> & outOfScene );
 
-    void reset(
-      LARGE_INTEGER refTick,
-      float sceneTopLeftX,
-      float sceneTopLeftY,
-      float sceneBottomRightX,
-      float sceneBottomRightY );
+    void reset( LARGE_INTEGER refTick );
 
     void update( entt::registry & reg, LARGE_INTEGER actTick, LARGE_INTEGER diffTick );
+    /*!< \brief Entities found out of scene by procActorMover are marked as inactive, the test itself
+         is done by the mover in the same sweep as the movement. */
 
-    float mSceneTopLeftX;
-    //<! \brief X coordinate of top left corner of the game scene in pixels.
-    float mSceneTopLeftY;
-    //<! \brief Y coordinate of top left corner of the game scene in pixels.
-    float mSceneBottomRightX;
-    //<! \brief X coordinate of bottom right corner of the game scene in pixels.
-    float mSceneBottomRightY;
-    //<! \brief Y coordinate of bottom right corner of the game scene in pixels.
+    std::vector<entt::entity> & mOutOfScene;
+    //<! \brief Reference to list of entities found out of scene in actual tick
 
   }; // procActorOutOfSceneCheck
 
@@ -296,16 +550,44 @@ namespace Inv
       LARGE_INTEGER actTick,
       LARGE_INTEGER diffTick,
       bool allowCallbacks = true );
+    /*!< \brief Entities tagged by cpPendingDestroy are pruned, living entities are not visited.
+         Pruned entities are destroyed at once in single batch, those belonging to pools (see
+         cpPooled) are parked instead. Lists of both are allocated from the tick arena. */
 
     FnEventCallbackEithEntityId_t mPruneCallback;
     //<! \brief Callback called when entity is pruned
 
-    std::vector<entt::entity> mEntities;
-    //<! \brief Working vector containing entities to be removed from registry, working variable
-
   }; // procGarbageCollector
 
 
+  //****** processor: animation of actors ***********************************************************
+
+
+  struct procActorAnimator: public procEnTTBase
+  {
+    procActorAnimator(
+      LARGE_INTEGER refTick,
+      const CInvSettings & settings,
+      CInvSettingsRuntime & settingsRuntime,
+      const CInvFormationIndex & formationIndex );
+
+    void update( entt::registry & reg, LARGE_INTEGER actTick, LARGE_INTEGER diffTick );
+    /*!< \brief Sprites of all visible entities are placed according to their position and geometry
+         and all effects are applied on them (animations advance, effect callbacks are fired). The
+         resulting image and vertices of the sprites are then used both by collision detector and
+         by procActorRender, which only draws them. The game therefore does not depend on whether
+         the frame is actually rendered. Sprites of aliens staying in formation are placed at their
+         starting position shifted by displacement of the formation. */
+
+    void updateSprite( cpGraphics & gph, float posX, float posY, const cpGeometry & geo, LARGE_INTEGER actTick );
+    //<! \brief Places sprite of single entity, effects are applied later (see ApplySpriteEffects())
+
+    const CInvFormationIndex & mFormationIndex;
+    //<! \brief Reference to lattice of alien formation, which holds displacement of the formation
+
+  }; // procActorAnimator
+
+
   //****** processor: rendering of actors ************************************************************
 
 
@@ -317,17 +599,9 @@ namespace Inv
       CInvSettingsRuntime & settingsRuntime );
 
     void update( entt::registry & reg, LARGE_INTEGER actTick, LARGE_INTEGER diffTick );
-
-    using SpriteInfo_t = struct
-    {
-      std::shared_ptr<CInvSprite> sprite;
-      cpGraphics & gph;
-      const cpPosition & pos;
-      const cpGeometry & geo;
-    };
-
-    std::map<float, std::vector<SpriteInfo_t>> mZAxisSorting;
-    //<! \brief Working structure for sorting sprites according to Z axis level
+    /*!< \brief Sprites of all visible entities are drawn as they were computed by procActorAnimator
+         in this tick. Has no side effects on the game state, so it may be skipped. Sprites are
+         sorted according to Z axis level in map allocated from the tick arena. */
 
   }; // procActorRender
 
@@ -340,7 +614,8 @@ namespace Inv
       LARGE_INTEGER refTick,
       const CInvSettings & settings,
       CInvSettingsRuntime & settingsRuntime,
-      bool & isInDangerousArea );
+      bool & isInDangerousArea,
+      const CInvFormationIndex & formationIndex );
 
     void update(
       entt::registry & reg,
@@ -350,6 +625,10 @@ namespace Inv
     bool & mIsInDangerousArea;
     //<! \brief Reference to variable indicating whether the player is in dangerous area
 
+    const CInvFormationIndex & mFormationIndex;
+    //<! \brief Reference to lattice of alien formation, which maintains the danger line (row of
+    //!  topmost alien staying in formation)
+
   }; // procPlayerSpeedUpdater
 
 } // namespace Inv
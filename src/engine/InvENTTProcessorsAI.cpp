@@ -8,8 +8,13 @@
 // 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
 //****************************************************************************************************
 
+#include <algorithm>
+
 #include <engine/InvENTTProcessorsAI.h>
 #include <engine/InvENTTComponents.h>
+#include <engine/InvENTTCollisionLayers.h>
+
+#include <engine/InvENTTEffects.h>
 
 #include <graphics/CInvSprite.h>
 #include <CInvRandom.h>
@@ -96,14 +101,110 @@ namespace Inv
     LARGE_INTEGER refTick,
     const CInvSettings & settings,
     CInvSettingsRuntime & settingsRuntime,
-    bool & isInDangerousArea ):
+    bool & isInDangerousArea,
+    const CInvFormationIndex & formationIndex ):
 
     procEnTTBase( refTick, settings, settingsRuntime ),
-    mIsInDangerousArea( isInDangerousArea )
+    mIsInDangerousArea( isInDangerousArea ),
+    mFormationIndex( formationIndex ),
+    mQueue(),
+    mJoined(),
+    mFinished(),
+    mRaiders(),
+    mTick( 0 ),
+    mRaidFactor( 0.0f )
   {}
 
   //--------------------------------------------------------------------------------------------------
 
+  void procActorStateSelector::reset( LARGE_INTEGER refTick )
+  {
+    procEnTTBase::reset( refTick );
+    mQueue.clear();
+    mFinished.clear();
+    mTick = 0;
+                        // Aliens of new scene already joined the formation (scene is generated
+                        // before processors are reset), so they are kept. Those of previous scene
+                        // are no longer valid and are skipped.
+  } // procActorStateSelector::reset
+
+  //--------------------------------------------------------------------------------------------------
+
+  static void lStartAnimation( cpAlienStatus & status, cpGraphics & gph, cpFxAnimation & anim )
+  {
+    status.isAnimating = true;
+    gph.diffTick.QuadPart = 0ul;
+    RestoreEffect( anim.standard );
+                        // Animation is started on random event. Effect is restored, runs once (as it is not
+                        // continuous) and then suspends itself, sending event message by appropriate callback,
+                        // which sets isAnimating flag to false again.
+  } // lStartAnimation
+
+  //--------------------------------------------------------------------------------------------------
+
+  static void lStartFiring( cpAlienStatus & status, cpGraphics & gph, cpFxAnimation & anim )
+  {
+    status.isFiring = true;
+    gph.diffTick.QuadPart = 0ul;
+    RestoreEffect( anim.specific );
+                        // Fire animation is started on random event. Effect is restored, runs once (as it is not
+                        // continuous) and then suspends itself, sending event message by appropriate callback,
+                        // which sets isFiring flag to false again.
+  } // lStartFiring
+
+  //--------------------------------------------------------------------------------------------------
+
+  uint64_t procActorStateSelector::drawWaitingTicks( float probability ) const
+  {
+    if( 1.0f <= probability )
+      return 0;
+    if( probability <= 0.0f )
+      return UINT64_MAX;
+
+    double ticks = floor( log( CInvRandom::GetInstance().Rndm() ) / log1p( -(double)probability ) );
+                        // Inverse of distribution function of geometric distribution, uniform number
+                        // is from open interval (0,1)
+    return ( 1e12 < ticks ) ? UINT64_MAX : (uint64_t)ticks;
+
+  } // procActorStateSelector::drawWaitingTicks
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procActorStateSelector::scheduleAction(
+    const cpAlienBehave & behave, const cpAlienStatus & status, entt::entity entity )
+  {
+    float probability =
+      1.0f - ( 1.0f - behave.animationProbability ) * ( 1.0f - behave.shootProbability );
+                        // Alien either starts animation or (if not) tries to fire, any of both counts
+
+    uint64_t waiting = drawWaitingTicks( probability );
+    if( UINT64_MAX == waiting )
+      return;
+
+    mQueue.push_back( { mTick + waiting, entity, status.scheduleStamp, false } );
+    std::push_heap( mQueue.begin(), mQueue.end(), std::greater<>() );
+
+  } // procActorStateSelector::scheduleAction
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procActorStateSelector::scheduleRaid(
+    const cpAlienBehave & behave, const cpAlienStatus & status, entt::entity entity )
+  {
+    if( mRaidFactor < 0.0f )
+      return;           // Sudden death, all aliens are sent to raid without scheduling
+
+    uint64_t waiting = drawWaitingTicks( behave.raidProbability * mRaidFactor );
+    if( UINT64_MAX == waiting )
+      return;
+
+    mQueue.push_back( { mTick + waiting, entity, status.scheduleStamp, true } );
+    std::push_heap( mQueue.begin(), mQueue.end(), std::greater<>() );
+
+  } // procActorStateSelector::scheduleRaid
+
+  //--------------------------------------------------------------------------------------------------
+
   void procActorStateSelector::update(
     entt::registry & reg,
     LARGE_INTEGER actTick,
@@ -113,62 +214,143 @@ namespace Inv
     if( mIsSuspended )
       return;           // Processor is suspended, no action is performed
 
-    auto view = reg.view<const cpAlienBehave, cpAlienStatus, cpGraphics>();
-    view.each( [&]( const cpAlienBehave & behave, cpAlienStatus & status, cpGraphics & gph )
-    {                   // Updating status for alien actors
+    auto viewR = reg.view<const cpAlienBehave, cpAlienStatus, cpGraphics, cpFxAnimation>( entt::exclude<cpInFormation> );
+    viewR.each( [&]( const cpAlienBehave & behave, cpAlienStatus & status, cpGraphics & gph, cpFxAnimation & anim )
+    {                   // Raiding and returning aliens are rolled every tick
+      if( status.isDying || status.isAnimating || status.isFiring )
+        return;         // Previous status must be resolved before any other is set
 
-      if( status.isDying )
-        return;         // Alien is dying, no other status is possible
+      if( InvRnd() < behave.animationProbability )
+        lStartAnimation( status, gph, anim );
+      else if( InvRnd() < ( status.isInRaid ? behave.raidShootProbability : behave.shootProbability ) )
+        lStartFiring( status, gph, anim );
+    } );
 
-      if( !( status.isAnimating || status.isFiring ) )
-      {                 // Previous status must be resolved before any other is set
+    float raidFactor = -1.0f;
+    if( 0u != quickDeathTicksLeft )
+    {
+      raidFactor = 2.0f * mSettingsRuntime.mAlienSpeedupFactor;
+      if( mIsInDangerousArea )
+        raidFactor *= mSettingsRuntime.mDangerAreaThreatCoefficient;
+                        // Invaders are more probable to enter raid if player is in dangerous area
+                        // (above the alien formation). On quick death mode all aliens are raiding.
+    } // if
 
-        if( InvRnd() < behave.animationProbability )
-        {
-          status.isAnimating = true;
-          gph.diffTick.QuadPart = 0ul;
-          gph.standardAnimationEffect->Restore();
-                        // Animation is started on random event. Effect is restored, runs once (as it is not
-                        // continuous) and then suspends itself, sending event message by appropriate callback,
-                        // which sets isAnimating flag to false again.
-        } // if
-        else
-        {
-          if( InvRnd() < ( status.isInRaid ? behave.raidShootProbability : behave.shootProbability ) )
-          {
-            status.isFiring = true;
-            gph.diffTick.QuadPart = 0ul;
-            gph.specificAnimationEffect->Restore();
-                        // Fire animation is started on random event. Effect is restored, runs once (as it is not
-                        // continuous) and then suspends itself, sending event message by appropriate callback,
-                        // which sets isFiring flag to false again.
-          } // if
-        } // else
-      } // if
+    bool raidFactorChanged = ( raidFactor != mRaidFactor );
+    if( raidFactorChanged )
+    {                   // Waiting for raid is memoryless, so it can be drawn anew with new probability
+      mRaidFactor = raidFactor;
+      std::erase_if( mQueue, [&]( const ScheduledEvent_t & event )
+        { return event.isRaid || !reg.valid( event.entity ); } );
+      std::make_heap( mQueue.begin(), mQueue.end(), std::greater<>() );
 
-      if( !( status.isInRaid || status.isReturningToFormation ) )
+      auto viewF = reg.view<const cpAlienBehave, const cpAlienStatus, const cpInFormation>();
+      viewF.each( [&]( entt::entity entity, const cpAlienBehave & behave, const cpAlienStatus & status )
       {
-        float prob = behave.raidProbability * 2.0f * mSettingsRuntime.mAlienSpeedupFactor;
-        if( mIsInDangerousArea )
-          prob *= mSettingsRuntime.mDangerAreaThreatCoefficient;
-                        // Invaders are more probable to enter raid if player is in dangerous area
-                        // (above the alien formation).
+        if( !status.isDying )
+          scheduleRaid( behave, status, entity );
+      } );
+    } // if
 
-        float probRoll;
-        if( 0u == quickDeathTicksLeft )
-          probRoll = 0.0f;
+    for( auto entity : mFinished )
+    {                   // Aliens in formation which finished their action wait for next one
+      if( !reg.valid( entity ) || !reg.all_of<cpInFormation, cpAlienBehave, cpAlienStatus>( entity ) )
+        continue;
+      auto [ behave, status ] = reg.get<const cpAlienBehave, const cpAlienStatus>( entity );
+      if( !( status.isDying || status.isAnimating || status.isFiring ) )
+        scheduleAction( behave, status, entity );
+    } // for
+
+    for( auto entity : mJoined )
+    {                   // Aliens which (re)joined formation since last tick
+      if( !reg.valid( entity ) || !reg.all_of<cpInFormation, cpAlienBehave, cpAlienStatus>( entity ) )
+        continue;
+      auto [ behave, status ] = reg.get<const cpAlienBehave, const cpAlienStatus>( entity );
+      if( status.isDying )
+        continue;
+
+      if( !( status.isAnimating || status.isFiring ) &&
+          std::find( mFinished.begin(), mFinished.end(), entity ) == mFinished.end() )
+        scheduleAction( behave, status, entity );
+                        // Busy alien gets its action scheduled when the actual one finishes
+
+      if( !raidFactorChanged )
+        scheduleRaid( behave, status, entity );
+                        // Otherwise it was already drawn for all aliens in formation
+    } // for
+
+    mFinished.clear();
+    mJoined.clear();
+
+    auto startRaid = [&]( entt::entity entity, const cpAlienBehave & behave, cpAlienStatus & status )
+    {                   // Alien enters raid mode
+      status.isInRaid = true;
+      status.isRaidStarting = true;
+      status.isRaidTimeOver = false;
+      ++status.scheduleStamp;
+                        // Events scheduled for the alien in formation are no longer valid
+
+      auto & pos = reg.get<cpPosition>( entity );
+      pos.X = behave.startingX + mFormationIndex.GetDisplacementX();
+      pos.Y = behave.startingY + mFormationIndex.GetDisplacementY();
+      reg.remove<cpInFormation>( entity );
+                        // Position was not maintained while in formation, alien starts from its
+                        // place there and moves by its own from now on.
+
+      UpdateCollisionLayers( reg, entity );
+                        // Alien left its formation slot
+    };
+
+    while( !mQueue.empty() && mQueue.front().tick <= mTick )
+    {                   // Events due in this tick, in order given by the queue
+      std::pop_heap( mQueue.begin(), mQueue.end(), std::greater<>() );
+      ScheduledEvent_t event = mQueue.back();
+      mQueue.pop_back();
+
+      if( !reg.valid( event.entity ) || !reg.all_of<cpInFormation>( event.entity ) )
+        continue;
+      auto [ behave, status, gph, anim ] =
+        reg.try_get<cpAlienBehave, cpAlienStatus, cpGraphics, cpFxAnimation>( event.entity );
+      if( nullptr == behave || nullptr == status || nullptr == gph || nullptr == anim ||
+          status->scheduleStamp != event.stamp || status->isDying )
+        continue;       // Event of alien which left the formation meanwhile, or is dying
+
+      if( event.isRaid )
+      {
+        if( !( status->isInRaid || status->isReturningToFormation ) )
+          startRaid( event.entity, *behave, *status );
+      } // if
+      else if( !( status->isAnimating || status->isFiring ) )
+      {                 // Action happens, it is animation with conditional probability given by
+                        // per-tick probabilities of animation and (if there is no animation) firing
+        float probability =
+          1.0f - ( 1.0f - behave->animationProbability ) * ( 1.0f - behave->shootProbability );
+        if( InvRnd() * probability < behave->animationProbability )
+          lStartAnimation( *status, *gph, *anim );
         else
-          probRoll = InvRnd();
-                        // On quick deat mode all aliens are raiding
+          lStartFiring( *status, *gph, *anim );
+      } // else if
+    } // while
+
+    if( mRaidFactor < 0.0f )
+    {                   // On quick death mode all aliens in formation are raiding
+      mRaiders.clear();
+      auto viewF = reg.view<const cpAlienBehave, const cpAlienStatus, const cpInFormation>();
+      viewF.each( [&]( entt::entity entity, const cpAlienBehave & behave, const cpAlienStatus & status )
+      {
+        if( !( status.isDying || status.isInRaid || status.isReturningToFormation ) &&
+            0.0f < behave.raidProbability )
+          mRaiders.push_back( entity );
+      } );
 
-        if( probRoll < prob )
-        {             // Alien enters raid mode on random event.
-          status.isInRaid = true;
-          status.raidTicksLeft = UINT32_MAX;
-        } // if
-      } // if
+      for( auto entity : mRaiders )
+      {
+        auto [ behave, status ] = reg.get<const cpAlienBehave, cpAlienStatus>( entity );
+        startRaid( entity, behave, status );
+      } // for
+    } // if
 
-    } );
+    ++mTick;
 
   } // procActorStateSelector::update
 
@@ -179,6 +361,7 @@ namespace Inv
     LARGE_INTEGER refTick,
     const CInvSettings & settings,
     CInvSettingsRuntime & settingsRuntime,
+    const CInvFormationIndex & formationIndex,
     float & vXGroup,
     float & vYGroup,
     float sceneTopLeftX,
@@ -195,7 +378,8 @@ namespace Inv
     mSceneTopLeftX( sceneTopLeftX ),
     mSceneTopLeftY( sceneTopLeftY ),
     mSceneBottomRightX( sceneBottomRightX ),
-    mSceneBottomRightY( sceneBottomRightY )
+    mSceneBottomRightY( sceneBottomRightY ),
+    mFormationIndex( formationIndex )
   {}
 
   //--------------------------------------------------------------------------------------------------
@@ -227,27 +411,21 @@ namespace Inv
 
     bool xChangeNeeded = false;
     bool yAtTheBottom = false;
-
-    auto view = reg.view<cpAlienBehave, cpAlienStatus, cpPosition, cpGeometry>();
-    view.each( [&]( cpAlienBehave & pBehave, cpAlienStatus & pStat, cpPosition & pPos, cpGeometry & pGeo )
-    {
-      if( pStat.isDying )
-        return;         // Alien is dying, no group bounds guard possible or necessary
-
-      float xPosNext = pStat.formationX + mVXGroup * mSettingsRuntime.mAlienSpeedupFactor;
-      xChangeNeeded |=
-        ( xPosNext - 0.5 * pGeo.width < mSceneTopLeftX ) ||
-        ( mSceneBottomRightX < xPosNext + 0.5 * pGeo.width );
-
-      float yPosNext = pStat.formationY + mVYGroup * mSettingsRuntime.mAlienSpeedupFactor;
-      yAtTheBottom |=
-        ( yPosNext - 0.5 * pGeo.height < mSceneTopLeftY ) ||
-        ( mSceneBottomRightY - bottomGuardedArea < yPosNext + 0.5 * pGeo.height );
-                        // Coo-eee, do not check pos.X and pos.Y there, use formation positions!!! While
-                        // the lowest alien is on raid, rest of the formation could drop too low and after
-                        // the return of the raider there would be not enough space for player ship at the
+    if( mFormationIndex.HasMembers() )
+    {                   // Extents cover places of all living aliens in formation, including those
+                        // on raid. Coo-eee, do not check actual positions of raiders! While the lowest
+                        // alien is on raid, rest of the formation could drop too low and after the
+                        // return of the raider there would be not enough space for player ship at the
                         // bottom of the screen!
-    } );
+      float left, right, top, bottom;
+      mFormationIndex.GetExtents( left, right, top, bottom );
+
+      float dX = mVXGroup * mSettingsRuntime.mAlienSpeedupFactor;
+      xChangeNeeded = ( left + dX < mSceneTopLeftX ) || ( mSceneBottomRightX < right + dX );
+
+      float dY = mVYGroup * mSettingsRuntime.mAlienSpeedupFactor;
+      yAtTheBottom = ( top + dY < mSceneTopLeftY ) || ( mSceneBottomRightY - bottomGuardedArea < bottom + dY );
+    } // if
 
     if( !IsZero( mVXGroup ) )
       mNextVXGroup = -mVXGroup;
@@ -290,10 +468,46 @@ namespace Inv
   procAlienRaidDriver::procAlienRaidDriver(
     LARGE_INTEGER refTick,
     const CInvSettings & settings,
-    CInvSettingsRuntime & settingsRuntime ):
+    CInvSettingsRuntime & settingsRuntime,
+    const CInvFormationIndex & formationIndex,
+    CInvTimerWheel & timers ):
 
-    procEnTTBase( refTick, settings, settingsRuntime )
-  {}
+    procEnTTBase( refTick, settings, settingsRuntime ),
+    mFormationIndex( formationIndex ),
+    mTimers( timers ),
+    mChunkRaidStarted(),
+    mChunkReturned(),
+    mChunkSteering(),
+    mSteerClamp( nullptr ),
+    mFlowToPlayer(),
+    mFlowToFormation()
+  {
+    const char * kernelName = nullptr;
+    mSteerClamp = SelectSteerClampKernel( &kernelName );
+    LOG << "Steering kernel selected: " << kernelName;
+  } // procAlienRaidDriver::procAlienRaidDriver
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procAlienRaidDriver::SteerStream_t::clear()
+  {
+    velocities.clear();
+    vX.clear();
+    vY.clear();
+    dX.clear();
+    dY.clear();
+  } // procAlienRaidDriver::SteerStream_t::clear
+
+  //--------------------------------------------------------------------------------------------------
+
+  void procAlienRaidDriver::SteerStream_t::push( cpVelocity & vel, float deltaX, float deltaY )
+  {
+    velocities.push_back( &vel );
+    vX.push_back( vel.vX );
+    vY.push_back( vel.vY );
+    dX.push_back( deltaX );
+    dY.push_back( deltaY );
+  } // procAlienRaidDriver::SteerStream_t::push
 
   //--------------------------------------------------------------------------------------------------
 
@@ -313,6 +527,10 @@ namespace Inv
 
     float maxAlienTurningAngle =
       mSettingsRuntime.mAlienRaidMaxAnglePerSec / mSettings.GetTickPerSecond();
+    float cosMaxAngle = ( (float)gPI <= maxAlienTurningAngle ) ? -2.0f : cosf( maxAlienTurningAngle );
+    float sinMaxAngle = ( (float)gPI <= maxAlienTurningAngle ) ? 0.0f : sinf( maxAlienTurningAngle );
+                        // Only trigonometric functions of the tick; when alien may turn around at once,
+                        // its velocity is always aligned with the target
 
     auto viewP = reg.view<cpPlayBehave, cpPlayStatus, cpPosition, cpGraphics>();
     viewP.each( [&]( cpPlayBehave & pBehave, cpPlayStatus & pStat, cpPosition & pPos, cpGraphics & pGph )
@@ -322,9 +540,42 @@ namespace Inv
         actPlayerY = pPos.Y;
     } );
 
-    auto viewA = reg.view<cpAlienBehave, cpAlienStatus, cpPosition, cpVelocity, cpGeometry>();
-    viewA.each( [&]( cpAlienBehave & pBehave, cpAlienStatus & pStat, cpPosition & pPos, cpVelocity &pVel, cpGeometry & pGeo )
-    {
+    float formationDX = mFormationIndex.GetDisplacementX();
+    float formationDY = mFormationIndex.GetDisplacementY();
+
+    uint32_t flowCell = mSettings.GetRaidFlowFieldCell();
+    if( 0u < flowCell )
+    {                   // Fields are built once per tick, aliens far from their targets only sample them
+      float nearDistance = max( mSettingsRuntime.mRaidTgtDistance, mSettingsRuntime.mReturnTgtDistance );
+      float width = (float)mSettings.GetWidth();
+      float height = (float)mSettings.GetHeight();
+
+      mFlowToPlayer.Build( (float)flowCell, nearDistance, width, height,
+                           actPlayerX, actPlayerY, actPlayerX, actPlayerY );
+
+      if( mFormationIndex.HasMembers() )
+      {                 // Returning aliens head for the formation, their own slot is used near to it
+        float left, right, top, bottom;
+        mFormationIndex.GetExtents( left, right, top, bottom );
+        mFlowToFormation.Build( (float)flowCell, nearDistance, width, height, left, top, right, bottom );
+      } // if
+      else
+        mFlowToFormation.Invalidate();
+    } // if
+
+    auto viewA = reg.view<const cpAlienBehave, cpAlienStatus, cpPosition, cpVelocity>( entt::exclude<cpInFormation> );
+    size_t chunks = chunkCount( viewA );
+    if( mChunkRaidStarted.size() < chunks )
+      mChunkRaidStarted.resize( chunks );
+    if( mChunkReturned.size() < chunks )
+      mChunkReturned.resize( chunks );
+    if( mChunkSteering.size() < chunks )
+      mChunkSteering.resize( chunks );
+
+    eachChunked( viewA, chunks, [&]( size_t chunk, entt::entity entity )
+    {                   // Every alien writes only its own components, chunks run concurrently
+        auto [ pBehave, pStat, pPos, pVel ] = viewA.get<const cpAlienBehave, cpAlienStatus, cpPosition, cpVelocity>( entity );
+
         if( !( pStat.isInRaid || pStat.isReturningToFormation ) || pStat.isDying )
           return;       // Alien is not in raid or is dying, it does not concern this processor
 
@@ -332,43 +583,60 @@ namespace Inv
         {               // Player is dead => alien returns to formation
           pStat.isInRaid = false;
           pStat.isReturningToFormation = true;
-          pStat.raidTicksLeft = 0u;
+          pStat.isRaidStarting = false;
         } // if
 
-        float xTgt = pStat.isReturningToFormation ? pStat.formationX : actPlayerX;
-        float yTgt = pStat.isReturningToFormation ? pStat.formationY : actPlayerY;
+        float formationX = pBehave.startingX + formationDX;
+        float formationY = pBehave.startingY + formationDY;
+        float xTgt = pStat.isReturningToFormation ? formationX : actPlayerX;
+        float yTgt = pStat.isReturningToFormation ? formationY : actPlayerY;
                         // Target position is either player position (in raid) or formation
                         // position (returning to formation)
 
-        float deltaX = xTgt - pPos.X;
-        float deltaY = yTgt - pPos.Y;
-                        // Vector from actual alien position to target position, basis
+        float deltaX = 0.0f;
+        float deltaY = 0.0f;
+        float distanceToTarget = 0.0f;
+        const CInvFlowField & flow = pStat.isReturningToFormation ? mFlowToFormation : mFlowToPlayer;
+        bool isNearTarget =
+          pStat.isRaidStarting || !flow.Sample( pPos.X, pPos.Y, deltaX, deltaY );
+                        // Far from the target, direction is taken from flow field (if used) and
+                        // the distance is not measured, alien cannot reach the target in this tick
+
+        if( isNearTarget )
+        {               // Vector from actual alien position to target position, basis
                         // for the pursuit curve.
-
-        float distanceToTarget = sqrt( deltaX * deltaX + deltaY * deltaY );
+          deltaX = xTgt - pPos.X;
+          deltaY = yTgt - pPos.Y;
+          distanceToTarget = sqrt( deltaX * deltaX + deltaY * deltaY );
+        } // if
 
         if( 0u < quickDeathTicksLeft )
         {               // On sudden death mode all aliens gone for raid and never returns to formation
                         // until player ship is destroyed (which is addressed in the beginning of this lambda)
           if( pStat.isInRaid &&
-            ( distanceToTarget < mSettingsRuntime.mRaidTgtDistance || 0u == pStat.raidTicksLeft ) )
+            ( ( isNearTarget && distanceToTarget < mSettingsRuntime.mRaidTgtDistance ) ||
+              pStat.isRaidTimeOver ) )
           {             // Alien reached target distance in raid, returns to formation
             pStat.isInRaid = false;
             pStat.isReturningToFormation = true;
-            pStat.raidTicksLeft = 0u;
+            pStat.isRaidStarting = false;
           } // if
         } // if
 
-        if( pStat.isReturningToFormation && distanceToTarget < mSettingsRuntime.mReturnTgtDistance )
+        if( pStat.isReturningToFormation && isNearTarget &&
+            distanceToTarget < mSettingsRuntime.mReturnTgtDistance )
         {               // Alien reached target distance when returning, it is considered to be
                         // back in formation
           pStat.isInRaid = false;
           pStat.isReturningToFormation = false;
-          pStat.raidTicksLeft = 0u;
-          pPos.X = pStat.formationX;
-          pPos.Y = pStat.formationY;
+          pStat.isRaidStarting = false;
+          pPos.X = formationX;
+          pPos.Y = formationY;
           pVel.vX = 0.0f;
           pVel.vY = 0.0f;
+          mChunkReturned[chunk].push_back( entity );
+                        // Tag of formation and collision layers are updated after the loop, it
+                        // changes registry
           return;
         } // if
 
@@ -378,46 +646,85 @@ namespace Inv
                         // mSettingsRuntime.mAlienSpeedupFactor, it is done in procActorMover
                         // processor.
 
-        if( UINT32_MAX == pStat.raidTicksLeft )
+        if( pStat.isRaidStarting )
         {               // Raid just started, movement must be initiated
-          pStat.raidTicksLeft =
-            (uint32_t)( mSettingsRuntime.mAlienRaidMaxTime * mSettings.GetTickPerSecond() /
-                        mSettingsRuntime.mAlienSpeedupFactor );
-                        // When alien speed is increased, raid time is decreased accordingly so that
-                        // raid distance remains approximately the same.
+          pStat.isRaidStarting = false;
+          mChunkRaidStarted[chunk].push_back( entity );
+                        // Time of the raid is limited by timer scheduled after the loop
 
           pVel.vX = velocitySize * deltaX / distanceToTarget;
           pVel.vY = velocitySize * deltaY / distanceToTarget;
           return;
         } // if
 
-        float phi = atan2( pVel.vX * deltaY - pVel.vY * deltaX, pVel.vX * deltaX + pVel.vY * deltaY );
-                        // Oriented angle between current velocity vector and vector to target is
-                        // calculated according to definition of scalar and pseudoscalar product
-                        // of two vectors.
-
-        if( phi < -maxAlienTurningAngle )
-          phi = -maxAlienTurningAngle;
-        else if( maxAlienTurningAngle < phi )
-          phi = maxAlienTurningAngle;
-                        // Angle change is limited by maximum turning angle per tick
+        mChunkSteering[chunk].push( pVel, deltaX, deltaY );
+                        // Velocity is turned towards the target by at most maximum turning angle
+                        // per tick, all aliens of the chunk at once by the kernel below
 
-        float cosPhi = cos( phi );
-        float sinPhi = sin( phi );
-                        // Cosine and sine of limited angle change is calculated to be
-                        // used in rotation matrix
+    });
 
-        float newVX = cosPhi * pVel.vX - sinPhi * pVel.vY;
-        float newVY = sinPhi * pVel.vX + cosPhi * pVel.vY;
-        pVel.vX = newVX;
-        pVel.vY = newVY;// New velocity vector is calculated by rotation of old vector
-                        // by limited angle change (multiplication by rotation matrix)
+    auto steerFn = [&]( size_t, size_t begin, size_t end )
+    {                   // Every chunk steers its own aliens, velocities are written back right away
+      for( size_t chunk = begin; chunk < end; ++chunk )
+      {
+        SteerStream_t & stream = mChunkSteering[chunk];
+        mSteerClamp(
+          stream.vX.data(), stream.vY.data(), stream.dX.data(), stream.dY.data(),
+          stream.vX.size(), cosMaxAngle, sinMaxAngle );
 
-        if( 0u < pStat.raidTicksLeft )
-          --pStat.raidTicksLeft;
-                        // One tick in raid mode is consumed
+        for( size_t index = 0; index < stream.velocities.size(); ++index )
+        {
+          stream.velocities[index]->vX = stream.vX[index];
+          stream.velocities[index]->vY = stream.vY[index];
+        } // for
+        stream.clear();
+      } // for
+    };
+
+    if( nullptr == mScheduler || chunks <= 1 )
+      steerFn( 0, 0, chunks );
+    else
+      mScheduler->ParallelFor( chunks, chunks, steerFn );
+
+    uint64_t raidTicks =
+      (uint64_t)( mSettingsRuntime.mAlienRaidMaxTime * mSettings.GetTickPerSecond() /
+                  mSettingsRuntime.mAlienSpeedupFactor );
+                        // When alien speed is increased, raid time is decreased accordingly so that
+                        // raid distance remains approximately the same.
 
-    });
+    for( size_t chunk = 0; chunk < chunks; ++chunk )
+    {                   // Raids started in this tick, in order of chunks
+      for( auto entity : mChunkRaidStarted[chunk] )
+      {
+        auto & status = reg.get<cpAlienStatus>( entity );
+        mTimers.Cancel( status.raidTimer );
+        status.raidTimer = mTimers.Schedule( raidTicks + 1u, [&reg, entity]( TimerHandle_t handle )
+        {               // Fires at the end of the last tick of the raid, alien turns back in the next one
+          auto status = reg.valid( entity ) ? reg.try_get<cpAlienStatus>( entity ) : nullptr;
+          if( nullptr != status && handle == status->raidTimer )
+          {
+            status->isRaidTimeOver = true;
+            status->raidTimer = gNoTimer;
+          } // if
+        } );
+      } // for
+      mChunkRaidStarted[chunk].clear();
+    } // for
+
+    for( size_t chunk = 0; chunk < chunks; ++chunk )
+    {                   // Aliens back in formation, in order of chunks
+      for( auto entity : mChunkReturned[chunk] )
+      {
+        auto & status = reg.get<cpAlienStatus>( entity );
+        mTimers.Cancel( status.raidTimer );
+        status.raidTimer = gNoTimer;
+                        // Raid ended before its time elapsed
+
+        reg.emplace_or_replace<cpInFormation>( entity );
+        UpdateCollisionLayers( reg, entity );
+      } // for
+      mChunkReturned[chunk].clear();
+    } // for
 
   } // procAlienRaidDriver::update
 
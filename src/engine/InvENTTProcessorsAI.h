@@ -16,6 +16,8 @@
 #include <engine/InvENTTComponents.h>
 #include <engine/InvENTTProcessors.h>
 #include <engine/CInvEntityFactory.h>
+#include <engine/CInvFlowField.h>
+#include <engine/CInvTimerWheel.h>
 
 namespace Inv
 {
@@ -64,14 +66,26 @@ namespace Inv
   //****** processor: setting of actors to specific states *******************************************
 
   /*! \brief This processor sets states of computer-controlled actors, like aliens, based on
-      probabilities defined in their behavior component (firing, raiding and so on). */
+      probabilities defined in their behavior component (firing, raiding and so on).
+
+      Aliens staying in formation are not polled every tick. Each of them has the tick of its next
+      action (animation or firing) and of its next raid scheduled in a queue, the waiting time is
+      drawn from geometric distribution (number of ticks until the first success of per-tick
+      probability), so the behaviour is statistically the same as if the probability was rolled
+      every tick. Waiting is memoryless, so it is drawn anew whenever the probability changes
+      (raids after speedup, danger area or sudden death change, action after the previous one
+      finished). Raiding and returning aliens are rolled every tick, they are visited by the raid
+      driver anyway. */
   struct procActorStateSelector: public procEnTTBase
   {
     procActorStateSelector(
       LARGE_INTEGER refTick,
       const CInvSettings & settings,
       CInvSettingsRuntime & settingsRuntime,
-      bool & isInDangerousArea);
+      bool & isInDangerousArea,
+      const CInvFormationIndex & formationIndex );
+
+    void reset( LARGE_INTEGER refTick );
 
     void update(
       entt::registry & reg,
@@ -79,21 +93,84 @@ namespace Inv
       LARGE_INTEGER diffTick,
       uint32_t quickDeathTicksLeft );
 
+    void formationJoined( entt::registry & reg, entt::entity entity ) { mJoined.push_back( entity ); }
+    //<! \brief Registry signal (construction of cpInFormation), alien gets its events scheduled in
+    //!  next update. No random number is drawn here, signals come from various processors.
+
+    void actionFinished( entt::entity entity ) { mFinished.push_back( entity ); }
+    //<! \brief Called when animation or firing of the alien finished, its next action is scheduled
+    //!  in next update
+
     bool & mIsInDangerousArea;
     //<! \brief Reference to variable indicating whether the player is in dangerous area
 
+    const CInvFormationIndex & mFormationIndex;
+    //<! \brief Reference to lattice of alien formation, alien leaving the formation for raid
+    //!  starts at its place there
+
+    struct ScheduledEvent_t
+    {
+      uint64_t tick;
+      entt::entity entity;
+      uint32_t stamp;
+      bool isRaid;
+
+      bool operator>( const ScheduledEvent_t & other ) const
+      {
+        if( tick != other.tick )
+          return other.tick < tick;
+        if( entity != other.entity )
+          return entt::to_integral( other.entity ) < entt::to_integral( entity );
+        return other.isRaid < isRaid;
+      } // operator>
+    };
+    //<! \brief Event of alien in formation due in given tick. Events of the same tick are ordered
+    //!  by entity, so random numbers are drawn in the same order in every run. Event is valid
+    //!  only if its stamp equals to cpAlienStatus::scheduleStamp of the alien.
+
+    void scheduleAction( const cpAlienBehave & behave, const cpAlienStatus & status, entt::entity entity );
+    //<! \brief Draws waiting time for next animation or firing of idle alien in formation
+
+    void scheduleRaid( const cpAlienBehave & behave, const cpAlienStatus & status, entt::entity entity );
+    //<! \brief Draws waiting time for next raid of alien in formation, using actual raid factor
+
+    uint64_t drawWaitingTicks( float probability ) const;
+    //<! \brief Returns number of ticks (counting from actual one) until the first success of given
+    //!  per-tick probability, UINT64_MAX if the event never happens
+
+    std::vector<ScheduledEvent_t> mQueue;
+    //<! \brief Scheduled events, binary heap with the earliest event on top
+
+    std::vector<entt::entity> mJoined;
+    //<! \brief Aliens which joined formation since last update
+
+    std::vector<entt::entity> mFinished;
+    //<! \brief Aliens which finished their action since last update
+
+    std::vector<entt::entity> mRaiders;
+    //<! \brief Aliens sent to raid at once in sudden death mode, working variable
+
+    uint64_t mTick;
+    //<! \brief Number of updates of the processor (ticks it was not suspended)
+
+    float mRaidFactor;
+    //<! \brief Factor of raid probability raid events in queue were drawn with, negative in
+    //!  sudden death mode (raid events are not scheduled, all aliens raid)
+
   }; // procActorStateSelector
 
   //****** processor: bounds guard - aliens ************************************************
 
   /*! \brief Processor that guards the group of aliens against crossing the scene bounds. Also it is
-      responsible for moving aliens when in formation. */
+      responsible for moving aliens when in formation. Extents of the formation are taken from
+      formation lattice, which maintains them as aliens die, no alien is visited. */
   struct procAlienBoundsGuard: public procEnTTBase
   {
     procAlienBoundsGuard(
       LARGE_INTEGER refTick,
       const CInvSettings & settings,
       CInvSettingsRuntime & settingsRuntime,
+      const CInvFormationIndex & formationIndex,
       float & vXGroup,
       float & vYGroup,
       float sceneTopLeftX,
@@ -136,6 +213,9 @@ namespace Inv
     float mSceneBottomRightY;
     //!< \brief Y coordinate of bottom right corner of the game scene in pixels.
 
+    const CInvFormationIndex & mFormationIndex;
+    //!< \brief Reference to lattice of alien formation, source of formation extents
+
   }; // procAlienBoundsGuard
 
   //****** processor: setting of actors to specific states *******************************************
@@ -147,7 +227,9 @@ namespace Inv
     procAlienRaidDriver(
       LARGE_INTEGER refTick,
       const CInvSettings & settings,
-      CInvSettingsRuntime & settingsRuntime );
+      CInvSettingsRuntime & settingsRuntime,
+      const CInvFormationIndex & formationIndex,
+      CInvTimerWheel & timers );
 
     void update(
       entt::registry & reg,
@@ -155,6 +237,48 @@ namespace Inv
       LARGE_INTEGER diffTick,
       uint32_t quickDeathTicksLeft );
 
+    const CInvFormationIndex & mFormationIndex;
+    //!< \brief Reference to lattice of alien formation, returning aliens head for their place there
+
+    CInvTimerWheel & mTimers;
+    //!< \brief Reference to timers of the scene, raid of every alien is limited by a timer
+
+    std::vector<std::vector<entt::entity>> mChunkRaidStarted;
+    //!< \brief Aliens of every chunk which started raid in actual tick, their timers are scheduled
+    //!  when all chunks are finished (in order of chunks, the wheel is not thread safe)
+
+    std::vector<std::vector<entt::entity>> mChunkReturned;
+    //!< \brief Aliens of every chunk which returned to formation in actual tick, their collision
+    //!  layers are updated when all chunks are finished (it changes structure of registry)
+
+    struct SteerStream_t
+    {
+      std::vector<cpVelocity *> velocities;
+      std::vector<float> vX;
+      std::vector<float> vY;
+      std::vector<float> dX;
+      std::vector<float> dY;
+
+      void clear();
+      void push( cpVelocity & vel, float deltaX, float deltaY );
+    };
+    //!< \brief Raiding aliens to be steered towards their targets, structure of arrays. Vectors keep
+    //!  their capacity between ticks.
+
+    std::vector<SteerStream_t> mChunkSteering;
+    //!< \brief Aliens of every chunk to be steered in actual tick, the kernel processes each chunk
+    //!  as soon as all chunks are collected
+
+    FnSteerClamp_t mSteerClamp;
+    //!< \brief Steering kernel selected for the CPU the game runs on
+
+    CInvFlowField mFlowToPlayer;
+    //!< \brief Directions towards the player, built every tick if flow field is enabled (see
+    //!  CInvSettings::GetRaidFlowFieldCell())
+
+    CInvFlowField mFlowToFormation;
+    //!< \brief Directions towards the formation for returning aliens, built every tick if flow field
+    //!  is enabled
 
   }; // procAlienRaidDriver
 
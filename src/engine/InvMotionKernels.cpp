@@ -0,0 +1,506 @@
+//****************************************************************************************************
+//! \file InvMotionKernels.cpp
+//! Module contains kernels moving entities stored as structure of arrays and culling those which
+//! left the scene, kernels steering raiding aliens, selection of the best kernel for the CPU the
+//! game runs on and their benchmark.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <chrono>
+
+#include <engine/InvMotionKernels.h>
+
+#include <CInvLogger.h>
+
+#ifdef INV_X86
+#include <immintrin.h>
+#endif
+
+static const std::string lModLogId( "MOTION" );
+
+namespace Inv
+{
+
+  static inline uint64_t lIntegrateCullOne(
+    float * x, float * y, const float * vX, const float * vY,
+    const float * halfW, const float * halfH,
+    size_t index, float scale, const MotionBounds_t & bounds )
+  {
+    float newX = x[index] + vX[index] * scale;
+    float newY = y[index] + vY[index] * scale;
+    x[index] = newX;
+    y[index] = newY;
+
+    bool out =
+      ( newX + halfW[index] < bounds.left ) || ( bounds.right < newX - halfW[index] ) ||
+      ( newY + halfH[index] < bounds.top ) || ( bounds.bottom < newY - halfH[index] );
+    return out ? 1ull : 0ull;
+
+  } // lIntegrateCullOne
+  //!< Moves single entity and returns its culling bit, used by all kernels for the tail
+
+  //----------------------------------------------------------------------------------------------
+
+  void IntegrateCullScalar(
+    float * x, float * y, const float * vX, const float * vY,
+    const float * halfW, const float * halfH,
+    size_t count, float scale, const MotionBounds_t & bounds, uint64_t * outside )
+  {
+    for( size_t base = 0; base < count; base += gMotionBlock )
+    {
+      size_t blockEnd = min( count, base + gMotionBlock );
+      uint64_t bits = 0ull;
+      for( size_t index = base; index < blockEnd; ++index )
+        bits |= lIntegrateCullOne( x, y, vX, vY, halfW, halfH, index, scale, bounds ) << ( index - base );
+      outside[base / gMotionBlock] = bits;
+    } // for
+
+  } // IntegrateCullScalar
+
+#ifdef INV_X86
+
+  //----------------------------------------------------------------------------------------------
+
+  void IntegrateCullSse2(
+    float * x, float * y, const float * vX, const float * vY,
+    const float * halfW, const float * halfH,
+    size_t count, float scale, const MotionBounds_t & bounds, uint64_t * outside )
+  {
+    const __m128 vScale = _mm_set1_ps( scale );
+    const __m128 vLeft = _mm_set1_ps( bounds.left );
+    const __m128 vTop = _mm_set1_ps( bounds.top );
+    const __m128 vRight = _mm_set1_ps( bounds.right );
+    const __m128 vBottom = _mm_set1_ps( bounds.bottom );
+
+    for( size_t base = 0; base < count; base += gMotionBlock )
+    {
+      size_t blockEnd = min( count, base + gMotionBlock );
+      uint64_t bits = 0ull;
+      size_t index = base;
+      for( ; index + 4 <= blockEnd; index += 4 )
+      {                 // Multiplication and addition are separate, as in scalar kernel
+        __m128 pX = _mm_add_ps( _mm_loadu_ps( x + index ), _mm_mul_ps( _mm_loadu_ps( vX + index ), vScale ) );
+        __m128 pY = _mm_add_ps( _mm_loadu_ps( y + index ), _mm_mul_ps( _mm_loadu_ps( vY + index ), vScale ) );
+        _mm_storeu_ps( x + index, pX );
+        _mm_storeu_ps( y + index, pY );
+
+        __m128 hW = _mm_loadu_ps( halfW + index );
+        __m128 hH = _mm_loadu_ps( halfH + index );
+        __m128 out = _mm_or_ps(
+          _mm_or_ps( _mm_cmplt_ps( _mm_add_ps( pX, hW ), vLeft ), _mm_cmplt_ps( vRight, _mm_sub_ps( pX, hW ) ) ),
+          _mm_or_ps( _mm_cmplt_ps( _mm_add_ps( pY, hH ), vTop ), _mm_cmplt_ps( vBottom, _mm_sub_ps( pY, hH ) ) ) );
+
+        bits |= (uint64_t)_mm_movemask_ps( out ) << ( index - base );
+      } // for
+
+      for( ; index < blockEnd; ++index )
+        bits |= lIntegrateCullOne( x, y, vX, vY, halfW, halfH, index, scale, bounds ) << ( index - base );
+      outside[base / gMotionBlock] = bits;
+    } // for
+
+  } // IntegrateCullSse2
+
+  //----------------------------------------------------------------------------------------------
+
+  INV_TARGET_AVX2 void IntegrateCullAvx2(
+    float * x, float * y, const float * vX, const float * vY,
+    const float * halfW, const float * halfH,
+    size_t count, float scale, const MotionBounds_t & bounds, uint64_t * outside )
+  {
+    const __m256 vScale = _mm256_set1_ps( scale );
+    const __m256 vLeft = _mm256_set1_ps( bounds.left );
+    const __m256 vTop = _mm256_set1_ps( bounds.top );
+    const __m256 vRight = _mm256_set1_ps( bounds.right );
+    const __m256 vBottom = _mm256_set1_ps( bounds.bottom );
+
+    for( size_t base = 0; base < count; base += gMotionBlock )
+    {
+      size_t blockEnd = min( count, base + gMotionBlock );
+      uint64_t bits = 0ull;
+      size_t index = base;
+      for( ; index + 8 <= blockEnd; index += 8 )
+      {                 // No FMA, fused operation would round differently than other kernels
+        __m256 pX = _mm256_add_ps( _mm256_loadu_ps( x + index ), _mm256_mul_ps( _mm256_loadu_ps( vX + index ), vScale ) );
+        __m256 pY = _mm256_add_ps( _mm256_loadu_ps( y + index ), _mm256_mul_ps( _mm256_loadu_ps( vY + index ), vScale ) );
+        _mm256_storeu_ps( x + index, pX );
+        _mm256_storeu_ps( y + index, pY );
+
+        __m256 hW = _mm256_loadu_ps( halfW + index );
+        __m256 hH = _mm256_loadu_ps( halfH + index );
+        __m256 out = _mm256_or_ps(
+          _mm256_or_ps(
+            _mm256_cmp_ps( _mm256_add_ps( pX, hW ), vLeft, _CMP_LT_OQ ),
+            _mm256_cmp_ps( vRight, _mm256_sub_ps( pX, hW ), _CMP_LT_OQ ) ),
+          _mm256_or_ps(
+            _mm256_cmp_ps( _mm256_add_ps( pY, hH ), vTop, _CMP_LT_OQ ),
+            _mm256_cmp_ps( vBottom, _mm256_sub_ps( pY, hH ), _CMP_LT_OQ ) ) );
+
+        bits |= (uint64_t)_mm256_movemask_ps( out ) << ( index - base );
+      } // for
+
+      for( ; index < blockEnd; ++index )
+        bits |= lIntegrateCullOne( x, y, vX, vY, halfW, halfH, index, scale, bounds ) << ( index - base );
+      outside[base / gMotionBlock] = bits;
+    } // for
+
+  } // IntegrateCullAvx2
+
+#endif
+
+  //----------------------------------------------------------------------------------------------
+
+  FnIntegrateCull_t SelectIntegrateCullKernel( const char ** kernelName )
+  {
+    const char * name = "scalar";
+    FnIntegrateCull_t kernel = IntegrateCullScalar;
+
+#ifdef INV_X86
+    bool hasSse2 = false;
+    bool hasAvx2 = false;
+    GetSimdSupport( hasSse2, hasAvx2 );
+
+    if( hasAvx2 )
+    {
+      name = "AVX2";
+      kernel = IntegrateCullAvx2;
+    } // if
+    else if( hasSse2 )
+    {
+      name = "SSE2";
+      kernel = IntegrateCullSse2;
+    } // else if
+#endif
+
+    if( nullptr != kernelName )
+      *kernelName = name;
+
+    return kernel;
+
+  } // SelectIntegrateCullKernel
+
+  //----------------------------------------------------------------------------------------------
+
+  void BenchmarkIntegrateCullKernels()
+  {
+    std::vector<std::pair<const char *, FnIntegrateCull_t>> kernels;
+    kernels.push_back( { "scalar", IntegrateCullScalar } );
+
+#ifdef INV_X86
+    bool hasSse2 = false;
+    bool hasAvx2 = false;
+    GetSimdSupport( hasSse2, hasAvx2 );
+    if( hasSse2 )
+      kernels.push_back( { "SSE2", IntegrateCullSse2 } );
+    if( hasAvx2 )
+      kernels.push_back( { "AVX2", IntegrateCullAvx2 } );
+#endif
+
+    const MotionBounds_t bounds{ 0.0f, 0.0f, 800.0f, 600.0f };
+    const size_t updatesPerRun = 50000000;
+                        // Every size is moved so many times, that all runs take comparable time
+
+    for( size_t count : { (size_t)1000, (size_t)10000, (size_t)100000 } )
+    {
+      std::vector<float> vX( count ), vY( count ), halfW( count ), halfH( count );
+      std::vector<float> startX( count ), startY( count );
+      for( size_t index = 0; index < count; ++index )
+      {                 // Deterministic spread over area larger than the scene, so both culled and
+                        // visible entities are present
+        startX[index] = (float)( ( index * 7919 ) % 1200 ) - 200.0f;
+        startY[index] = (float)( ( index * 104729 ) % 1000 ) - 200.0f;
+        vX[index] = (float)( (int)( index % 11 ) - 5 ) * 0.25f;
+        vY[index] = (float)( (int)( index % 7 ) - 3 ) * 0.5f;
+        halfW[index] = 4.0f + (float)( index % 5 );
+        halfH[index] = 6.0f + (float)( index % 3 );
+      } // for
+
+      const size_t words = ( count + gMotionBlock - 1 ) / gMotionBlock;
+      const size_t repeats = max( (size_t)1, updatesPerRun / count );
+      std::vector<float> refX, refY;
+      std::vector<uint64_t> refOutside;
+
+      for( auto & kernel : kernels )
+      {
+        std::vector<float> x( startX ), y( startY );
+        std::vector<uint64_t> outside( words, 0ull );
+
+        auto timeStart = std::chrono::steady_clock::now();
+        for( size_t loop = 0; loop < repeats; ++loop )
+          kernel.second( x.data(), y.data(), vX.data(), vY.data(), halfW.data(), halfH.data(),
+                         count, ( loop & 1 ) ? -1.0f : 1.0f, bounds, outside.data() );
+                        // Entities move back and forth, so they stay in the same area
+        auto timeEnd = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>( timeEnd - timeStart ).count();
+        double nsPerEntity = 1e9 * seconds / (double)( repeats * count );
+
+        bool matches = true;
+        if( refX.empty() )
+        {
+          refX = x;
+          refY = y;
+          refOutside = outside;
+        } // if
+        else
+          matches = ( x == refX && y == refY && outside == refOutside );
+
+        LOG << "Motion kernel " << kernel.first << ", " << count << " entities: "
+            << nsPerEntity << " ns/entity, " << 1e-6 * (double)( repeats * count ) / seconds
+            << " M entities/s" << ( matches ? "" : ", RESULTS DIFFER FROM SCALAR KERNEL!" );
+      } // for kernel
+    } // for count
+
+  } // BenchmarkIntegrateCullKernels
+
+  //----------------------------------------------------------------------------------------------
+
+  static inline void lSteerClampOne(
+    float * vX, float * vY, const float * dX, const float * dY,
+    size_t index, float cosMax, float sinMax )
+  {
+    float vx = vX[index];
+    float vy = vY[index];
+    float dx = dX[index];
+    float dy = dY[index];
+
+    float vv = vx * vx + vy * vy;
+    float dd = dx * dx + dy * dy;
+    float dot = vx * dx + vy * dy;
+    float cross = vx * dy - vy * dx;
+    float product = vv * dd;
+    if( !( 0.0f < product ) )
+      return;           // Zero velocity or alien just at the target, no direction to turn to
+
+    float invLength = 1.0f / sqrtf( product );
+    if( cosMax <= dot * invLength )
+    {                   // Target is within the turning angle, velocity is aligned with it
+      float scale = vv * invLength;
+      vX[index] = dx * scale;
+      vY[index] = dy * scale;
+    } // if
+    else
+    {                   // Rotation by maximal angle towards the target
+      float sinPhi = ( cross < 0.0f ) ? -sinMax : sinMax;
+      vX[index] = cosMax * vx - sinPhi * vy;
+      vY[index] = sinPhi * vx + cosMax * vy;
+    } // else
+
+  } // lSteerClampOne
+  //!< Steers single entity, used by all kernels for the tail
+
+  //----------------------------------------------------------------------------------------------
+
+  void SteerClampScalar(
+    float * vX, float * vY, const float * dX, const float * dY,
+    size_t count, float cosMax, float sinMax )
+  {
+    for( size_t index = 0; index < count; ++index )
+      lSteerClampOne( vX, vY, dX, dY, index, cosMax, sinMax );
+
+  } // SteerClampScalar
+
+#ifdef INV_X86
+
+  //----------------------------------------------------------------------------------------------
+
+  static inline __m128 lSelectSse2( __m128 mask, __m128 ifSet, __m128 ifClear )
+  {
+    return _mm_or_ps( _mm_and_ps( mask, ifSet ), _mm_andnot_ps( mask, ifClear ) );
+
+  } // lSelectSse2
+
+  //----------------------------------------------------------------------------------------------
+
+  void SteerClampSse2(
+    float * vX, float * vY, const float * dX, const float * dY,
+    size_t count, float cosMax, float sinMax )
+  {
+    const __m128 vCosMax = _mm_set1_ps( cosMax );
+    const __m128 vSinMax = _mm_set1_ps( sinMax );
+    const __m128 vSinMin = _mm_set1_ps( -sinMax );
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vOne = _mm_set1_ps( 1.0f );
+
+    size_t index = 0;
+    for( ; index + 4 <= count; index += 4 )
+    {                   // Both branches of scalar kernel are evaluated, lanes pick their result
+      __m128 vx = _mm_loadu_ps( vX + index );
+      __m128 vy = _mm_loadu_ps( vY + index );
+      __m128 dx = _mm_loadu_ps( dX + index );
+      __m128 dy = _mm_loadu_ps( dY + index );
+
+      __m128 vv = _mm_add_ps( _mm_mul_ps( vx, vx ), _mm_mul_ps( vy, vy ) );
+      __m128 dd = _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) );
+      __m128 dot = _mm_add_ps( _mm_mul_ps( vx, dx ), _mm_mul_ps( vy, dy ) );
+      __m128 cross = _mm_sub_ps( _mm_mul_ps( vx, dy ), _mm_mul_ps( vy, dx ) );
+      __m128 product = _mm_mul_ps( vv, dd );
+      __m128 valid = _mm_cmplt_ps( vZero, product );
+
+      __m128 invLength = _mm_div_ps( vOne, _mm_sqrt_ps( product ) );
+      __m128 within = _mm_cmple_ps( vCosMax, _mm_mul_ps( dot, invLength ) );
+      __m128 scale = _mm_mul_ps( vv, invLength );
+
+      __m128 sinPhi = lSelectSse2( _mm_cmplt_ps( cross, vZero ), vSinMin, vSinMax );
+      __m128 rotX = _mm_sub_ps( _mm_mul_ps( vCosMax, vx ), _mm_mul_ps( sinPhi, vy ) );
+      __m128 rotY = _mm_add_ps( _mm_mul_ps( sinPhi, vx ), _mm_mul_ps( vCosMax, vy ) );
+
+      __m128 newX = lSelectSse2( within, _mm_mul_ps( dx, scale ), rotX );
+      __m128 newY = lSelectSse2( within, _mm_mul_ps( dy, scale ), rotY );
+      _mm_storeu_ps( vX + index, lSelectSse2( valid, newX, vx ) );
+      _mm_storeu_ps( vY + index, lSelectSse2( valid, newY, vy ) );
+    } // for
+
+    for( ; index < count; ++index )
+      lSteerClampOne( vX, vY, dX, dY, index, cosMax, sinMax );
+
+  } // SteerClampSse2
+
+  //----------------------------------------------------------------------------------------------
+
+  INV_TARGET_AVX2 void SteerClampAvx2(
+    float * vX, float * vY, const float * dX, const float * dY,
+    size_t count, float cosMax, float sinMax )
+  {
+    const __m256 vCosMax = _mm256_set1_ps( cosMax );
+    const __m256 vSinMax = _mm256_set1_ps( sinMax );
+    const __m256 vSinMin = _mm256_set1_ps( -sinMax );
+    const __m256 vZero = _mm256_setzero_ps();
+    const __m256 vOne = _mm256_set1_ps( 1.0f );
+
+    size_t index = 0;
+    for( ; index + 8 <= count; index += 8 )
+    {                   // No FMA and no approximate reciprocal square root, both would give results
+                        // different from other kernels
+      __m256 vx = _mm256_loadu_ps( vX + index );
+      __m256 vy = _mm256_loadu_ps( vY + index );
+      __m256 dx = _mm256_loadu_ps( dX + index );
+      __m256 dy = _mm256_loadu_ps( dY + index );
+
+      __m256 vv = _mm256_add_ps( _mm256_mul_ps( vx, vx ), _mm256_mul_ps( vy, vy ) );
+      __m256 dd = _mm256_add_ps( _mm256_mul_ps( dx, dx ), _mm256_mul_ps( dy, dy ) );
+      __m256 dot = _mm256_add_ps( _mm256_mul_ps( vx, dx ), _mm256_mul_ps( vy, dy ) );
+      __m256 cross = _mm256_sub_ps( _mm256_mul_ps( vx, dy ), _mm256_mul_ps( vy, dx ) );
+      __m256 product = _mm256_mul_ps( vv, dd );
+      __m256 valid = _mm256_cmp_ps( vZero, product, _CMP_LT_OQ );
+
+      __m256 invLength = _mm256_div_ps( vOne, _mm256_sqrt_ps( product ) );
+      __m256 within = _mm256_cmp_ps( vCosMax, _mm256_mul_ps( dot, invLength ), _CMP_LE_OQ );
+      __m256 scale = _mm256_mul_ps( vv, invLength );
+
+      __m256 sinPhi = _mm256_blendv_ps( vSinMax, vSinMin, _mm256_cmp_ps( cross, vZero, _CMP_LT_OQ ) );
+      __m256 rotX = _mm256_sub_ps( _mm256_mul_ps( vCosMax, vx ), _mm256_mul_ps( sinPhi, vy ) );
+      __m256 rotY = _mm256_add_ps( _mm256_mul_ps( sinPhi, vx ), _mm256_mul_ps( vCosMax, vy ) );
+
+      __m256 newX = _mm256_blendv_ps( rotX, _mm256_mul_ps( dx, scale ), within );
+      __m256 newY = _mm256_blendv_ps( rotY, _mm256_mul_ps( dy, scale ), within );
+      _mm256_storeu_ps( vX + index, _mm256_blendv_ps( vx, newX, valid ) );
+      _mm256_storeu_ps( vY + index, _mm256_blendv_ps( vy, newY, valid ) );
+    } // for
+
+    for( ; index < count; ++index )
+      lSteerClampOne( vX, vY, dX, dY, index, cosMax, sinMax );
+
+  } // SteerClampAvx2
+
+#endif
+
+  //----------------------------------------------------------------------------------------------
+
+  FnSteerClamp_t SelectSteerClampKernel( const char ** kernelName )
+  {
+    const char * name = "scalar";
+    FnSteerClamp_t kernel = SteerClampScalar;
+
+#ifdef INV_X86
+    bool hasSse2 = false;
+    bool hasAvx2 = false;
+    GetSimdSupport( hasSse2, hasAvx2 );
+
+    if( hasAvx2 )
+    {
+      name = "AVX2";
+      kernel = SteerClampAvx2;
+    } // if
+    else if( hasSse2 )
+    {
+      name = "SSE2";
+      kernel = SteerClampSse2;
+    } // else if
+#endif
+
+    if( nullptr != kernelName )
+      *kernelName = name;
+
+    return kernel;
+
+  } // SelectSteerClampKernel
+
+  //----------------------------------------------------------------------------------------------
+
+  void BenchmarkSteerClampKernels()
+  {
+    std::vector<std::pair<const char *, FnSteerClamp_t>> kernels;
+    kernels.push_back( { "scalar", SteerClampScalar } );
+
+#ifdef INV_X86
+    bool hasSse2 = false;
+    bool hasAvx2 = false;
+    GetSimdSupport( hasSse2, hasAvx2 );
+    if( hasSse2 )
+      kernels.push_back( { "SSE2", SteerClampSse2 } );
+    if( hasAvx2 )
+      kernels.push_back( { "AVX2", SteerClampAvx2 } );
+#endif
+
+    const float maxAngle = 0.05f;
+    const float cosMax = cosf( maxAngle );
+    const float sinMax = sinf( maxAngle );
+    const size_t updatesPerRun = 50000000;
+
+    for( size_t count : { (size_t)1000, (size_t)10000, (size_t)100000 } )
+    {
+      std::vector<float> dX( count ), dY( count ), startVX( count ), startVY( count );
+      for( size_t index = 0; index < count; ++index )
+      {                 // Deterministic mix of targets in all directions, some of them reached
+        dX[index] = ( 0 == index % 13 ) ? 0.0f : (float)( (int)( ( index * 7919 ) % 801 ) - 400 );
+        dY[index] = ( 0 == index % 13 ) ? 0.0f : (float)( (int)( ( index * 104729 ) % 601 ) - 300 );
+        startVX[index] = (float)( (int)( index % 11 ) - 5 ) * 0.25f;
+        startVY[index] = (float)( (int)( index % 7 ) - 3 ) * 0.5f;
+      } // for
+
+      const size_t repeats = max( (size_t)1, updatesPerRun / count );
+      std::vector<float> refVX, refVY;
+
+      for( auto & kernel : kernels )
+      {
+        std::vector<float> vX( startVX ), vY( startVY );
+
+        auto timeStart = std::chrono::steady_clock::now();
+        for( size_t loop = 0; loop < repeats; ++loop )
+          kernel.second( vX.data(), vY.data(), dX.data(), dY.data(), count, cosMax, sinMax );
+        auto timeEnd = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>( timeEnd - timeStart ).count();
+        double nsPerEntity = 1e9 * seconds / (double)( repeats * count );
+
+        bool matches = true;
+        if( refVX.empty() )
+        {
+          refVX = vX;
+          refVY = vY;
+        } // if
+        else
+          matches = ( vX == refVX && vY == refVY );
+
+        LOG << "Steering kernel " << kernel.first << ", " << count << " entities: "
+            << nsPerEntity << " ns/entity, " << 1e-6 * (double)( repeats * count ) / seconds
+            << " M entities/s" << ( matches ? "" : ", RESULTS DIFFER FROM SCALAR KERNEL!" );
+      } // for kernel
+    } // for count
+
+  } // BenchmarkSteerClampKernels
+
+} // namespace Inv
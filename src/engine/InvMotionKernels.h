@@ -0,0 +1,113 @@
+//****************************************************************************************************
+//! \file InvMotionKernels.h
+//! Module contains kernels moving entities stored as structure of arrays and culling those which
+//! left the scene, kernels steering raiding aliens, selection of the best kernel for the CPU the
+//! game runs on and their benchmark.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_InvMotionKernels
+#define H_InvMotionKernels
+
+#include <InvGlobals.h>
+#include <graphics/InvMaskOverlap.h>
+
+namespace Inv
+{
+
+  struct MotionBounds_t
+  {
+    float left;         //!< X coordinate of left edge of the scene
+    float top;          //!< Y coordinate of top edge of the scene
+    float right;        //!< X coordinate of right edge of the scene
+    float bottom;       //!< Y coordinate of bottom edge of the scene
+  };
+  //!< \brief Scene rectangle, entity whose bounding box lies entirely outside of it is culled
+
+  constexpr size_t gMotionBlock = 64;
+  //!< Number of entities whose culling bits form one word of the mask
+
+  using FnIntegrateCull_t = void( * )(
+    float * x, float * y, const float * vX, const float * vY,
+    const float * halfW, const float * halfH,
+    size_t count, float scale, const MotionBounds_t & bounds, uint64_t * outside );
+  //!< \brief Type of kernel moving \e count entities by their velocity multiplied by \e scale and
+  //!  testing their new bounding boxes (centre and half sizes) against the scene in the same sweep.
+  //!  Bit \e n of \e outside (word n / 64) is set if entity \e n lies entirely outside of the scene,
+  //!  all (count + 63) / 64 words are written. All kernels multiply and add in the same order, so
+  //!  their results are bitwise identical and the simulation does not depend on the CPU.
+
+  void IntegrateCullScalar(
+    float * x, float * y, const float * vX, const float * vY,
+    const float * halfW, const float * halfH,
+    size_t count, float scale, const MotionBounds_t & bounds, uint64_t * outside );
+  //!< \brief Portable implementation of FnIntegrateCull_t, one entity at a time.
+
+#ifdef INV_X86
+
+  void IntegrateCullSse2(
+    float * x, float * y, const float * vX, const float * vY,
+    const float * halfW, const float * halfH,
+    size_t count, float scale, const MotionBounds_t & bounds, uint64_t * outside );
+  //!< \brief SSE2 implementation of FnIntegrateCull_t, four entities are processed at once.
+
+  void IntegrateCullAvx2(
+    float * x, float * y, const float * vX, const float * vY,
+    const float * halfW, const float * halfH,
+    size_t count, float scale, const MotionBounds_t & bounds, uint64_t * outside );
+  //!< \brief AVX2 implementation of FnIntegrateCull_t, eight entities are processed at once. Must
+  //!  not be called if the CPU (or OS) does not support AVX2.
+#endif
+
+  FnIntegrateCull_t SelectIntegrateCullKernel( const char ** kernelName = nullptr );
+  //!< \brief Returns the fastest kernel supported by the CPU the game runs on (CPUID based
+  //!  runtime dispatch). If \e kernelName is given, it is set to static name of the kernel.
+
+  void BenchmarkIntegrateCullKernels();
+  //!< \brief Measures all kernels supported by the CPU on 1k, 10k and 100k entities and writes
+  //!  throughput to the log. Results of every kernel are compared with the scalar one.
+
+  using FnSteerClamp_t = void( * )(
+    float * vX, float * vY, const float * dX, const float * dY,
+    size_t count, float cosMax, float sinMax );
+  //!< \brief Type of kernel turning velocities of \e count entities towards their targets (\e dX,
+  //!  \e dY is vector from entity to target) by at most the angle whose cosine and sine are given.
+  //!  Oriented angle is not evaluated: if dot product of velocity and target vector (normalized)
+  //!  is at least \e cosMax, velocity is aligned with the target vector, otherwise it is rotated
+  //!  by the maximal angle to the side given by sign of their cross product. Size of velocity is
+  //!  kept, zero velocity or target vector leaves velocity unchanged. All kernels use correctly
+  //!  rounded square root and division in the same order, so their results are bitwise identical.
+
+  void SteerClampScalar(
+    float * vX, float * vY, const float * dX, const float * dY,
+    size_t count, float cosMax, float sinMax );
+  //!< \brief Portable implementation of FnSteerClamp_t, one entity at a time.
+
+#ifdef INV_X86
+
+  void SteerClampSse2(
+    float * vX, float * vY, const float * dX, const float * dY,
+    size_t count, float cosMax, float sinMax );
+  //!< \brief SSE2 implementation of FnSteerClamp_t, four entities are processed at once.
+
+  void SteerClampAvx2(
+    float * vX, float * vY, const float * dX, const float * dY,
+    size_t count, float cosMax, float sinMax );
+  //!< \brief AVX2 implementation of FnSteerClamp_t, eight entities are processed at once. Must
+  //!  not be called if the CPU (or OS) does not support AVX2.
+#endif
+
+  FnSteerClamp_t SelectSteerClampKernel( const char ** kernelName = nullptr );
+  //!< \brief Returns the fastest steering kernel supported by the CPU the game runs on, see
+  //!  SelectIntegrateCullKernel().
+
+  void BenchmarkSteerClampKernels();
+  //!< \brief Measures all steering kernels supported by the CPU on 1k, 10k and 100k entities and
+  //!  writes throughput to the log. Results of every kernel are compared with the scalar one.
+
+} // namespace Inv
+
+#endif
@@ -9,7 +9,7 @@
 
 #include <filesystem>
 
-#include <d3dx9.h>
+#include <graphics/InvD3D9.h>
 
 #include <graphics/CInvBackground.h>
 
@@ -26,6 +26,7 @@ namespace Inv
     mSettings( settings ),
     mPd3dDevice( pd3dDevice ),
     mTexture( nullptr ),
+    mStateBlock( nullptr ),
     mTextureSize{ 0u, 0u },
     mLvl( 0.1f ),
     mRollCoef( 0.33f ),
@@ -37,7 +38,11 @@ namespace Inv
 
   //----------------------------------------------------------------------------------------------
 
-  CInvBackground::~CInvBackground() = default;
+  CInvBackground::~CInvBackground()
+  {
+    if( nullptr != mStateBlock )
+      mStateBlock->Release();
+  } // CInvBackground::~CInvBackground
 
   //----------------------------------------------------------------------------------------------
 
@@ -80,6 +85,11 @@ namespace Inv
     mTxtrWidth = (float)mSettings.GetWidth() / (float)mTextureSize.first;
     mTxtrHeight = (float)mSettings.GetHeight() / (float)mTextureSize.second;
 
+    if( nullptr == mStateBlock )
+      mPd3dDevice->CreateStateBlock( D3DSBT_ALL, &mStateBlock );
+                        // State block is created once and captured in every Draw(), creating it
+                        // for every frame would allocate in every tick
+
   } // CInvBackground::AddBackgroundImage
 
   //----------------------------------------------------------------------------------------------
@@ -102,8 +112,8 @@ namespace Inv
     mTea2[2] = { 0.0f,      mVprHeight, mLvl, 1.0f, color, 0.0f,       t + mTxtrHeight };
     mTea2[3] = { mVprWidth, mVprHeight, mLvl, 1.0f, color, mTxtrWidth, t + mTxtrHeight };
 
-    IDirect3DStateBlock9 * stateBlock = nullptr;
-    mPd3dDevice->CreateStateBlock( D3DSBT_ALL, &stateBlock );
+    if( nullptr != mStateBlock )
+      mStateBlock->Capture();
 
     mPd3dDevice->SetTexture( 0, mTexture );
     mPd3dDevice->SetSamplerState( 0, D3DSAMP_ADDRESSU, D3DTADDRESS_CLAMP );
@@ -114,11 +124,8 @@ namespace Inv
 
     mPd3dDevice->DrawPrimitiveUP( D3DPT_TRIANGLESTRIP, 2, mTea2, sizeof( CUSTOMVERTEX ) );
 
-    if( nullptr != stateBlock )
-    {
-      stateBlock->Apply();
-      stateBlock->Release();
-    } // if
+    if( nullptr != mStateBlock )
+      mStateBlock->Apply();
 
   } // CInvBackground::Draw
 
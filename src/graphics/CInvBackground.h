@@ -10,7 +10,7 @@
 #ifndef H_CInvBackground
 #define H_CInvBackground
 
-#include <d3d9.h>
+#include <graphics/InvD3D9.h>
 
 #include <InvGlobals.h>
 #include <CInvSettings.h>
@@ -100,6 +100,9 @@ namespace Inv
     IDirect3DTexture9 * mTexture;
     //!< List of textures (images) that make up the Background
 
+    IDirect3DStateBlock9 * mStateBlock;
+    //!< Block saving all device states changed by Draw() and restoring them afterwards
+
     std::pair<size_t, size_t> mTextureSize;
     //!< Width an height of background image in pixels
 
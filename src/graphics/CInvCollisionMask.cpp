@@ -0,0 +1,161 @@
+//****************************************************************************************************
+//! \file CInvCollisionMask.cpp
+//! Module defines class CInvCollisionMask, a packed 1-bit alpha mask of single sprite image used
+//! for pixel-perfect collision detection.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <graphics/CInvCollisionMask.h>
+
+#include <CInvLogger.h>
+
+
+static const std::string lModLogId( "CollisionMask" );
+
+namespace Inv
+{
+  CInvCollisionMask::CInvCollisionMask( uint32_t width, uint32_t height ):
+    mWidth( width ),
+    mHeight( height ),
+    mWordsPerRow( ( ( width + 63 ) >> 6 ) + 1 ),
+    mBits( (size_t)( ( ( width + 63 ) >> 6 ) + 1 ) * height, 0ull ),
+    mScaledVariants()
+  {}
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvCollisionMask::~CInvCollisionMask() = default;
+
+  //----------------------------------------------------------------------------------------------
+
+  std::shared_ptr<CInvCollisionMask> CInvCollisionMask::CreateFromTexture( IDirect3DTexture9 * texture )
+  {
+    if( nullptr == texture )
+      return nullptr;
+
+    D3DSURFACE_DESC desc;
+    if( FAILED( texture->GetLevelDesc( 0, &desc ) ) || 0 == desc.Width || 0 == desc.Height )
+    {
+      LOG << "Cannot get texture description, collision mask is not created.";
+      return nullptr;
+    } // if
+
+    D3DLOCKED_RECT lockedRect;
+    if( FAILED( texture->LockRect( 0, &lockedRect, NULL, D3DLOCK_READONLY ) ) )
+    {                   // This is the only place where texture is locked, it happens once
+                        // when the image is loaded.
+      LOG << "Error locking texture, collision mask is not created.";
+      return nullptr;
+    } // if
+
+    auto mask = std::make_shared<CInvCollisionMask>( desc.Width, desc.Height );
+
+    for( uint32_t y = 0; y < desc.Height; ++y )
+    {
+      const D3DCOLOR * pRow = (const D3DCOLOR *)( (const BYTE *)lockedRect.pBits + y * lockedRect.Pitch );
+                        // We assume 32-bit (4 bytes) format, same as renderer does
+      for( uint32_t x = 0; x < desc.Width; ++x )
+      {
+        BYTE alpha = ( pRow[x] >> 24 ) & 0xFF;
+        if( alpha > mAlphaThreshold )
+          mask->SetSolid( x, y );
+      } // for x
+    } // for y
+
+    texture->UnlockRect( 0 );
+
+    return mask;
+
+  } // CInvCollisionMask::CreateFromTexture
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvCollisionMask::IsSolidUV( float u, float v ) const
+  {
+    int x = (int)( u * mWidth );
+    int y = (int)( v * mHeight );
+                        // Convert UV coordinates to pixel coordinates
+
+    x = max( 0, min( x, (int)mWidth - 1 ) );
+    y = max( 0, min( y, (int)mHeight - 1 ) );
+                        // Edge treatment (clamp)
+
+    return IsSolid( (uint32_t)x, (uint32_t)y );
+
+  } // CInvCollisionMask::IsSolidUV
+
+  //----------------------------------------------------------------------------------------------
+
+  const CInvCollisionMask * CInvCollisionMask::GetScaled( uint32_t width, uint32_t height, uint64_t useStamp ) const
+  {
+    if( 0 == width || 0 == height )
+      return nullptr;
+
+    if( nullptr == mScaledVariants[0].mask )
+    {                   // All slots are allocated at once when the image is drawn for the first
+                        // time, storage is reserved for its actual size. Shrinking sprite never
+                        // needs more, so the slots are then reused without allocation.
+      size_t words = (size_t)( ( ( width + 63 ) >> 6 ) + 1 ) * height;
+      for( auto & slot : mScaledVariants )
+      {
+        slot.mask = std::make_unique<CInvCollisionMask>( 0, 0 );
+        slot.mask->mBits.reserve( words );
+        slot.lastUse = 0;
+      } // for
+    } // if
+
+    ScaledSlot_t * victim = nullptr;
+    for( auto & slot : mScaledVariants )
+    {
+      if( slot.mask->mWidth == width && slot.mask->mHeight == height )
+      {
+        slot.lastUse = useStamp;
+        return slot.mask.get();
+      } // if
+
+      if( slot.lastUse != useStamp && ( nullptr == victim || slot.lastUse < victim->lastUse ) )
+        victim = &slot; // Unused slot (of zero size) has the oldest stamp, it is taken first
+    } // for
+
+    if( nullptr == victim )
+      return nullptr;   // All variants are used with the same stamp, none can be dropped
+
+    victim->mask->Resample( *this, width, height );
+    victim->lastUse = useStamp;
+    return victim->mask.get();
+
+  } // CInvCollisionMask::GetScaled
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvCollisionMask::Resample( const CInvCollisionMask & source, uint32_t width, uint32_t height )
+  {
+    mWidth = width;
+    mHeight = height;
+    mWordsPerRow = ( ( width + 63 ) >> 6 ) + 1;
+    mBits.assign( (size_t)mWordsPerRow * height, 0ull );
+                        // Capacity of the vector is kept, it grows only if the variant is larger
+
+    for( uint32_t y = 0; y < height; ++y )
+    {
+      int sy = (int)( ( (float)y / (float)height ) * source.mHeight );
+      sy = max( 0, min( sy, (int)source.mHeight - 1 ) );
+
+      for( uint32_t x = 0; x < width; ++x )
+      {
+        int sx = (int)( ( (float)x / (float)width ) * source.mWidth );
+        sx = max( 0, min( sx, (int)source.mWidth - 1 ) );
+                        // The formula corresponds to the relative coordinate of pixel within
+                        // the rectangle on screen, converted to texel coordinate.
+
+        if( source.IsSolid( (uint32_t)sx, (uint32_t)sy ) )
+          SetSolid( x, y );
+      } // for x
+    } // for y
+
+  } // CInvCollisionMask::Resample
+
+} // namespace Inv
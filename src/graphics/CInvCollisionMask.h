@@ -0,0 +1,134 @@
+//****************************************************************************************************
+//! \file CInvCollisionMask.h
+//! Module declares class CInvCollisionMask, a packed 1-bit alpha mask of single sprite image used
+//! for pixel-perfect collision detection.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvCollisionMask
+#define H_CInvCollisionMask
+
+#include <array>
+
+#include <graphics/InvD3D9.h>
+
+#include <InvGlobals.h>
+
+namespace Inv
+{
+
+  /*! \brief Class represents a packed 1-bit mask of "solid" (non-transparent) pixels of one sprite
+      image. The mask is built only once, when the image is loaded, so the collision detection does
+      not need to lock Direct3D textures during the game (locking stalls the graphic pipeline).
+      Every row of the mask is stored as a sequence of 64-bit words, bit 0 of the first word is
+      the leftmost pixel of the row. Each row is followed by one zero padding word, so a 64-bit
+      window starting at any pixel of the row can be read without range checks. Scaled variants
+      of the mask (i.e. masks resampled to the size in which the sprite is actually drawn on
+      screen) are created on demand and cached in fixed number of slots, storage of the slots is
+      reused when other sizes are demanded. */
+  class CInvCollisionMask
+  {
+    public:
+
+    CInvCollisionMask( uint32_t width, uint32_t height );
+    /*!< \brief Creates empty (fully transparent) mask of given size.
+
+         \param[in] width   Width of mask in pixels
+         \param[in] height  Height of mask in pixels */
+
+    CInvCollisionMask( const CInvCollisionMask & ) = delete;
+    CInvCollisionMask & operator=( const CInvCollisionMask & ) = delete;
+    ~CInvCollisionMask();
+
+    static std::shared_ptr<CInvCollisionMask> CreateFromTexture( IDirect3DTexture9 * texture );
+    /*!< \brief Creates mask from given texture. The texture is locked (read only) for the time
+         of creation. 32-bit format with alpha channel in the highest byte is expected.
+
+         \param[in] texture  Texture from which the mask is built
+         \return Shared pointer to created mask, or nullptr if the texture cannot be read */
+
+    uint32_t GetWidth() const { return mWidth; }
+    /*!< \brief Returns width of mask in pixels */
+
+    uint32_t GetHeight() const { return mHeight; }
+    /*!< \brief Returns height of mask in pixels */
+
+    uint32_t GetWordsPerRow() const { return mWordsPerRow; }
+    /*!< \brief Returns number of 64-bit words used to store one row of mask (row stride) */
+
+    const uint64_t * GetRow( uint32_t y ) const { return mBits.data() + (size_t)y * mWordsPerRow; }
+    /*!< \brief Returns pointer to first word of given row. No range check is done. */
+
+    bool IsSolid( uint32_t x, uint32_t y ) const
+    { return 0 != ( GetRow( y )[x >> 6] & ( 1ull << ( x & 63 ) ) ); }
+    /*!< \brief Returns true if pixel at given coordinates is solid. No range check is done. */
+
+    bool IsSolidUV( float u, float v ) const;
+    /*!< \brief Returns true if pixel at given relative (texture) coordinates is solid. Coordinates
+         outside of <0,1> are clamped to the edge of the mask. */
+
+    void SetSolid( uint32_t x, uint32_t y )
+    { mBits[(size_t)y * mWordsPerRow + ( x >> 6 )] |= ( 1ull << ( x & 63 ) ); }
+    /*!< \brief Marks pixel at given coordinates as solid. No range check is done. */
+
+    const CInvCollisionMask * GetScaled( uint32_t width, uint32_t height, uint64_t useStamp ) const;
+    /*!< \brief Returns variant of the mask resampled to given size. The sampling is the same as
+         used when texture is mapped on the screen rectangle of given size (nearest texel with
+         clamping). Variants are cached in mScaledSlots slots. If demanded size is not cached,
+         the least recently used slot is resampled in place, its storage is reused, so sprites
+         changing their size every tick (shrink effect) do not allocate memory. Slot used with
+         the same \e useStamp is never resampled, so all variants obtained with one stamp stay
+         valid together. Method is not thread safe, variants used by concurrent narrowphase test
+         are obtained in advance (see CInvCollisionTest::GetScaledMask).
+
+         \param[in] width     Demanded width in pixels
+         \param[in] height    Demanded height in pixels
+         \param[in] useStamp  Stamp of actual use (e.g. number of tick), not zero
+         \return Pointer to resampled mask, valid until its slot is resampled with other stamp.
+                 nullptr if demanded size is zero or all slots are used with the same stamp. */
+
+    static constexpr BYTE mAlphaThreshold = 10;
+    //!< Alpha threshold for pixel-perfect collision detection, pixels with alpha below this
+    //!  value are considered transparent and do not contribute to collision.
+
+  private:
+
+    void Resample( const CInvCollisionMask & source, uint32_t width, uint32_t height );
+    /*!< \brief Makes this mask the variant of \e source mask resampled to given size. Storage of
+         bits is reused, it is allocated only if it is smaller than needed. */
+
+    using ScaledSlot_t = struct
+    {
+      std::unique_ptr<CInvCollisionMask> mask;
+      uint64_t lastUse;
+    };
+    //!< \brief Slot of cache of scaled variants: the variant (of zero size if the slot was not used
+    //!  yet) and stamp of its last use. Variants of all slots are created at first use of the mask.
+
+    static constexpr size_t mScaledSlots = 8;
+    //!< Number of cached scaled variants. Sprite usually needs one size, the rest serves sprites
+    //!  affected by shrink effect, whose size changes every tick.
+
+    uint32_t mWidth;
+    //!< Width of mask in pixels
+
+    uint32_t mHeight;
+    //!< Height of mask in pixels
+
+    uint32_t mWordsPerRow;
+    //!< Number of 64-bit words used for one row of mask (including padding word)
+
+    std::vector<uint64_t> mBits;
+    //!< Packed bits of mask, row by row
+
+    mutable std::array<ScaledSlot_t, mScaledSlots> mScaledVariants;
+    //!< Cache of scaled variants of mask
+
+  }; // class CInvCollisionMask
+
+} // namespace Inv
+
+#endif
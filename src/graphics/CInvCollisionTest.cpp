@@ -8,10 +8,13 @@
 //****************************************************************************************************
 
 #include <filesystem>
+#include <algorithm>
+#include <chrono>
 
-#include <d3dx9.h>
+#include <graphics/InvD3D9.h>
 
 #include <graphics/CInvCollisionTest.h>
+#include <graphics/CInvSpriteStorage.h>
 
 #include <CInvLogger.h>
 
@@ -22,8 +25,14 @@ namespace Inv
 {
   CInvCollisionTest::CInvCollisionTest( const CInvSettings & settings, LPDIRECT3DDEVICE9 pd3dDevice ):
     mSettings( settings ),
-    mPd3dDevice( pd3dDevice )
-  {}
+    mPd3dDevice( pd3dDevice ),
+    mMaskRowsOverlap( nullptr ),
+    mScaledMaskStamp( 1 )
+  {
+    const char * kernelName = nullptr;
+    mMaskRowsOverlap = SelectMaskRowsOverlapKernel( &kernelName );
+    LOG << "Mask overlap kernel selected: " << kernelName;
+  } // CInvCollisionTest::CInvCollisionTest
 
   //----------------------------------------------------------------------------------------------
 
@@ -36,7 +45,7 @@ namespace Inv
     //     if( ! CheckBoundingBoxCollision( sprite1, sprite2 ) )
     //       return false;
 
-    if( !CheckPixelPerfectCollision( sprite1, sprite2 ) )
+    if( !CheckPixelPerfectCollision( sprite1, GetScaledMask( sprite1 ), sprite2, GetScaledMask( sprite2 ) ) )
       return false;
 
     return true;
@@ -45,6 +54,350 @@ namespace Inv
 
   //----------------------------------------------------------------------------------------------
 
+  bool CInvCollisionTest::AreInCollisionSwept(
+    const CInvSprite & sprite1,
+    float sweepX,
+    float sweepY,
+    const CInvSprite & sprite2,
+    float * contactTime ) const
+  {
+    return AreInCollisionSwept(
+      sprite1, GetScaledMask( sprite1 ), sweepX, sweepY, sprite2, GetScaledMask( sprite2 ), contactTime );
+
+  } // CInvCollisionTest::AreInCollisionSwept
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvCollisionTest::AreInCollisionSwept(
+    const CInvSprite & sprite1,
+    const CInvCollisionMask * scaled1,
+    float sweepX,
+    float sweepY,
+    const CInvSprite & sprite2,
+    const CInvCollisionMask * scaled2,
+    float * contactTime ) const
+  {
+    if( nullptr != contactTime )
+      *contactTime = 1.0f;
+
+    if( IsZero( sweepX ) && IsZero( sweepY ) )
+      return CheckPixelPerfectCollision( sprite1, scaled1, sprite2, scaled2 );
+
+    float x1Min, x1Max, y1Min, y1Max;
+    sprite1.GetResultingBoundingBox( x1Min, x1Max, y1Min, y1Max );
+
+    float x2Min, x2Max, y2Min, y2Max;
+    sprite2.GetResultingBoundingBox( x2Min, x2Max, y2Min, y2Max );
+
+    x2Min -= 1.0f;
+    x2Max += 1.0f;
+    y2Min -= 1.0f;
+    y2Max += 1.0f;      // Static box is enlarged by one pixel, to cover rounding of rectangles
+                        // in pixel-perfect test
+
+    float tEnter = 0.0f;
+    float tExit = 1.0f;
+                        // Position of the first box at time t is its actual position shifted by
+                        // (t - 1) * sweep. Interval of t in which the boxes overlap is searched
+                        // on both axes (slab method).
+
+    auto slab = [&]( float aMin, float aMax, float bMin, float bMax, float sweep ) -> bool
+    {
+      if( IsZero( sweep ) )
+        return !( aMax < bMin || bMax < aMin );
+
+      float t1 = 1.0f + ( bMin - aMax ) / sweep;
+      float t2 = 1.0f + ( bMax - aMin ) / sweep;
+      if( t2 < t1 )
+        std::swap( t1, t2 );
+
+      tEnter = max( tEnter, t1 );
+      tExit = min( tExit, t2 );
+      return tEnter <= tExit;
+    };
+
+    if( !slab( x1Min, x1Max, x2Min, x2Max, sweepX ) ||
+        !slab( y1Min, y1Max, y2Min, y2Max, sweepY ) )
+      return false;     // Swept boxes do not overlap at all
+
+    float sweepLength = sqrtf( sweepX * sweepX + sweepY * sweepY );
+    float step = max( 1.0f, 0.5f * min( x1Max - x1Min, y1Max - y1Min ) );
+    uint32_t steps = max( 1u, (uint32_t)ceilf( sweepLength * ( tExit - tEnter ) / step ) );
+                        // Positions along the path are sampled with step shorter than the moving
+                        // sprite, so no part of the path is skipped
+
+    for( uint32_t i = 0; i <= steps; ++i )
+    {
+      float t = tEnter + ( tExit - tEnter ) * (float)i / (float)steps;
+      LONG offsetX = (LONG)roundf( ( t - 1.0f ) * sweepX );
+      LONG offsetY = (LONG)roundf( ( t - 1.0f ) * sweepY );
+
+      if( CheckPixelPerfectCollision( sprite1, scaled1, sprite2, scaled2, offsetX, offsetY ) )
+      {
+        if( nullptr != contactTime )
+          *contactTime = t;
+        return true;
+      } // if
+    } // for
+
+    return false;
+
+  } // CInvCollisionTest::AreInCollisionSwept
+
+  //----------------------------------------------------------------------------------------------
+
+  const CInvCollisionMask * CInvCollisionTest::GetScaledMask( const CInvSprite & sprite ) const
+  {
+    const CInvCollisionMask * mask = sprite.GetResultingCollisionMask();
+    if( nullptr == mask || !HasIdentityMapping( sprite.GetResultingVertices() ) )
+      return nullptr;   // Flipped sprite is tested per pixel, scaled mask would not help
+
+    RECT rect = GetSceneRect( sprite );
+    return mask->GetScaled( rect.right - rect.left, rect.bottom - rect.top, mScaledMaskStamp );
+                        // Swept test shifts the rectangle by whole pixels only, so its size and
+                        // the scaled mask are the same at all positions along the path
+
+  } // CInvCollisionTest::GetScaledMask
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvCollisionTest::BenchmarkMaskOverlap( const CInvSpriteStorage & spriteStorage )
+  {
+    std::vector<std::pair<const char *, FnMaskRowsOverlap_t>> kernels;
+    kernels.push_back( { "scalar", MaskRowsOverlapScalar } );
+
+#ifdef INV_X86
+    bool hasSse2 = false;
+    bool hasAvx2 = false;
+    GetSimdSupport( hasSse2, hasAvx2 );
+    if( hasSse2 )
+      kernels.push_back( { "SSE2", MaskRowsOverlapSse2 } );
+    if( hasAvx2 )
+      kernels.push_back( { "AVX2", MaskRowsOverlapAvx2 } );
+#endif
+
+    const CUSTOMVERTEX identity[4] = {
+      { 0.0f, 0.0f, 0.0f, 1.0f, 0xffffffff, 0.0f, 0.0f },
+      { 0.0f, 0.0f, 0.0f, 1.0f, 0xffffffff, 1.0f, 0.0f },
+      { 0.0f, 0.0f, 0.0f, 1.0f, 0xffffffff, 0.0f, 1.0f },
+      { 0.0f, 0.0f, 0.0f, 1.0f, 0xffffffff, 1.0f, 1.0f } };
+                        // Only texture coordinates are used by the per-pixel test
+
+    const LONG alienWidth = 64;
+    const std::pair<const char *, LONG> missiles[] = { { "ROCKET", 8 }, { "SPIT", 21 } };
+                        // On-screen widths close to the game: spit is one third of the invader,
+                        // rocket one tenth of the player ship
+
+    const size_t testsPerRun = 1000000;
+                        // Every pair is tested so many times, that all runs take comparable time
+
+    using BenchCase_t = struct
+    {
+      const CInvCollisionMask * mask1;
+      const CInvCollisionMask * scaled1;
+      const CInvCollisionMask * mask2;
+      const CInvCollisionMask * scaled2;
+      RECT rect1;
+      RECT rect2;
+      RECT intersection;
+    };
+
+    auto target = spriteStorage.GetSprite( "PINK" );
+
+    for( auto & missile : missiles )
+    {
+      auto projectile = spriteStorage.GetSprite( missile.first );
+      if( nullptr == target || nullptr == projectile || !target->IsValid() || !projectile->IsValid() )
+      {
+        LOG << "Sprites PINK and " << missile.first << " are not loaded, mask overlap is not measured.";
+        continue;
+      } // if
+
+      auto targetFrames = target->GetFrames();
+      auto projectileFrames = projectile->GetFrames();
+
+      std::vector<BenchCase_t> cases;
+
+      for( size_t indexP = 0; indexP < projectileFrames->GetNumberOfImages(); ++indexP )
+      {
+        for( size_t indexT = 0; indexT < targetFrames->GetNumberOfImages(); ++indexT )
+        {
+          const CInvCollisionMask * mask1 = projectileFrames->GetCollisionMask( indexP );
+          const CInvCollisionMask * mask2 = targetFrames->GetCollisionMask( indexT );
+          if( nullptr == mask1 || nullptr == mask2 )
+            continue;
+
+          LONG width1 = missile.second;
+          LONG height1 = max( (LONG)1, (LONG)( width1 * mask1->GetHeight() / mask1->GetWidth() ) );
+          LONG width2 = alienWidth;
+          LONG height2 = max( (LONG)1, (LONG)( width2 * mask2->GetHeight() / mask2->GetWidth() ) );
+
+          auto scaled1 = mask1->GetScaled( (uint32_t)width1, (uint32_t)height1, 1 );
+          auto scaled2 = mask2->GetScaled( (uint32_t)width2, (uint32_t)height2, 1 );
+          if( nullptr == scaled1 || nullptr == scaled2 )
+            continue;   // All variants are obtained with the same stamp, so none is dropped
+
+          for( LONG y = 1 - height1; y < height2; ++y )
+          {
+            for( LONG x = 1 - width1; x < width2; ++x )
+            {           // Projectile at all positions where its rectangle overlaps the target one
+              BenchCase_t benchCase{ mask1, scaled1, mask2, scaled2,
+                { x, y, x + width1, y + height1 }, { 0, 0, width2, height2 }, {} };
+              IntersectRect( &benchCase.intersection, &benchCase.rect1, &benchCase.rect2 );
+              cases.push_back( benchCase );
+            } // for x
+          } // for y
+        } // for indexT
+      } // for indexP
+
+      if( cases.empty() )
+        continue;
+
+      if( testsPerRun < cases.size() )
+      {                 // Sprites with many frames give too many positions, every n-th is kept
+        const size_t keepEvery = ( cases.size() + testsPerRun - 1 ) / testsPerRun;
+        size_t kept = 0;
+        for( size_t index = 0; index < cases.size(); index += keepEvery )
+          cases[kept++] = cases[index];
+        cases.resize( kept );
+      } // if
+
+      const size_t repeats = max( (size_t)1, testsPerRun / cases.size() );
+      std::vector<uint8_t> reference;
+      double perPixelNs = 0.0;
+
+      auto measure = [&]( const char * name, auto test )
+      {
+        std::vector<uint8_t> hits( cases.size(), 0 );
+
+        auto timeStart = std::chrono::steady_clock::now();
+        for( size_t loop = 0; loop < repeats; ++loop )
+          for( size_t index = 0; index < cases.size(); ++index )
+            hits[index] = test( cases[index] ) ? 1 : 0;
+        auto timeEnd = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>( timeEnd - timeStart ).count();
+        double nsPerTest = 1e9 * seconds / (double)( repeats * cases.size() );
+        size_t collisions = (size_t)std::count( hits.begin(), hits.end(), (uint8_t)1 );
+
+        bool matches = true;
+        if( reference.empty() )
+        {
+          reference = hits;
+          perPixelNs = nsPerTest;
+        } // if
+        else
+          matches = ( hits == reference );
+
+        LOG << "Mask overlap " << name << ", PINK x " << missile.first << ", " << cases.size()
+            << " positions: " << nsPerTest << " ns/test, " << perPixelNs / nsPerTest
+            << "x per-pixel, " << collisions << " collisions"
+            << ( matches ? "" : ", RESULTS DIFFER FROM PER-PIXEL TEST!" );
+      };
+
+      measure( "per-pixel", [&]( const BenchCase_t & bc )
+      {
+        return MasksOverlapPerPixel(
+          *bc.mask1, bc.rect1, identity, *bc.mask2, bc.rect2, identity, bc.intersection );
+      } );
+
+      for( auto & kernel : kernels )
+      {
+        measure( kernel.first, [&]( const BenchCase_t & bc )
+        {
+          return MasksOverlap( kernel.second, *bc.scaled1, bc.rect1, *bc.scaled2, bc.rect2, bc.intersection );
+        } );
+      } // for kernel
+    } // for missile
+
+  } // CInvCollisionTest::BenchmarkMaskOverlap
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvCollisionTest::CheckSweptAtTickRates( const CInvSpriteStorage & spriteStorage ) const
+  {
+    CInvSprite target = spriteStorage.GetSpriteInstance( "PINK" );
+    CInvSprite rocket = spriteStorage.GetSpriteInstance( "ROCKET" );
+    if( !target.IsValid() || !rocket.IsValid() )
+    {
+      LOG << "Sprites PINK and ROCKET are not loaded, swept test cannot be checked.";
+      return false;
+    } // if
+
+    auto targetImage = target.GetImageSize( 0 );
+    auto rocketImage = rocket.GetImageSize( 0 );
+
+    const float targetX = 400.0f;
+    const float targetY = 300.0f;
+    const float targetWidth = 64.0f;
+    const float targetHeight = roundf( targetWidth * (float)targetImage.second / (float)targetImage.first );
+    const float rocketWidth = 8.0f;
+    const float rocketHeight = roundf( rocketWidth * (float)rocketImage.second / (float)rocketImage.first );
+                        // Whole pixel sizes, so rectangles of sprites do not change along the path
+
+    const float rocketSpeed = 1200.0f;
+    const float pathLength = 320.0f;
+    const uint32_t tickRates[] = { 240, 120, 60, 30, 15 };
+                        // Rocket moves by 5 to 80 px per tick; at the lowest rates the step is
+                        // longer than the invader, so test at actual positions only may miss it
+
+    const int columns = (int)( targetWidth + rocketWidth );
+    const float firstColumnX = targetX - 0.5f * (float)columns;
+
+    target.Place( targetX, targetY, targetWidth, targetHeight );
+    target.FinishUpdate();
+
+    std::vector<uint8_t> reference;
+    bool consistent = true;
+
+    for( uint32_t rate : tickRates )
+    {
+      const float step = rocketSpeed / (float)rate;
+      const uint32_t ticks = (uint32_t)( pathLength / step );
+
+      std::vector<uint8_t> hitsSwept( columns, 0 );
+      size_t countSwept = 0;
+      size_t countStatic = 0;
+
+      for( int column = 0; column < columns; ++column )
+      {
+        bool hitSwept = false;
+        bool hitStatic = false;
+
+        for( uint32_t tick = 1; tick <= ticks; ++tick )
+        {               // Rocket starts below the invader and ends above it
+          rocket.Place( firstColumnX + (float)column, targetY + 0.5f * pathLength - step * (float)tick,
+            rocketWidth, rocketHeight );
+          rocket.FinishUpdate();
+
+          hitSwept = hitSwept || AreInCollisionSwept( rocket, 0.0f, -step, target );
+          hitStatic = hitStatic || AreInCollision( rocket, target );
+        } // for tick
+
+        hitsSwept[column] = hitSwept ? 1 : 0;
+        countSwept += hitSwept ? 1 : 0;
+        countStatic += hitStatic ? 1 : 0;
+      } // for column
+
+      bool matches = true;
+      if( reference.empty() )
+        reference = hitsSwept;
+      else
+        matches = ( hitsSwept == reference );
+
+      consistent = consistent && matches;
+
+      LOG << "Swept test at " << rate << " ticks/s (" << step << " px/tick): " << countSwept
+          << " of " << columns << " columns hit, " << countStatic << " at actual positions only"
+          << ( matches ? "" : ", HITS DIFFER FROM THE HIGHEST TICK RATE!" );
+    } // for rate
+
+    return consistent;
+
+  } // CInvCollisionTest::CheckSweptAtTickRates
+
+  //----------------------------------------------------------------------------------------------
+
 //
 //   bool CInvCollisionTest::CheckBoundingBoxCollision( const CInvSprite & sprite1, const CInvSprite & sprite2 ) const
 //   {
@@ -87,93 +440,120 @@ namespace Inv
 
   //----------------------------------------------------------------------------------------------
 
-  D3DCOLOR CInvCollisionTest::GetPixelColor( D3DLOCKED_RECT lockedRect, float u, float v, IDirect3DTexture9 * texture )
+  bool CInvCollisionTest::HasIdentityMapping( const CUSTOMVERTEX vertices[] )
   {
+    return
+      IsZero( vertices[0].u ) && IsZero( vertices[0].v ) &&
+      IsZero( vertices[1].u - 1.0f ) && IsZero( vertices[1].v ) &&
+      IsZero( vertices[2].u ) && IsZero( vertices[2].v - 1.0f ) &&
+      IsZero( vertices[3].u - 1.0f ) && IsZero( vertices[3].v - 1.0f );
 
-    D3DSURFACE_DESC desc;
-    texture->GetLevelDesc( 0, &desc );
-    int width = desc.Width;
-    int height = desc.Height;
-                        // Get texture dimensions
-
-    int x = (int)( u * width );
-    int y = (int)( v * height );
-                        // Convert UV coordinates to pixel coordinates
-
-    x = max( 0, min( x, width - 1 ) );
-    y = max( 0, min( y, height - 1 ) );
-                        // Edge treatment (clamp)
+  } // CInvCollisionTest::HasIdentityMapping
 
-    BYTE * pPixel = (BYTE *)lockedRect.pBits + y * lockedRect.Pitch + x * 4;
-                        // Calculate the offset into memory. We assume 32-bit (4 bytes) format
+  //----------------------------------------------------------------------------------------------
 
-    return  *( (D3DCOLOR *)pPixel );
+  RECT CInvCollisionTest::GetSceneRect( const CInvSprite & sprite )
+  {
+    float xMin, xMax, yMin, yMax;
+    sprite.GetResultingBoundingBox( xMin, xMax, yMin, yMax );
+    return RECT{ (LONG)floorf( xMin ), (LONG)floorf( yMin ), (LONG)ceilf( xMax ), (LONG)ceilf( yMax ) };
 
-  } // CInvCollisionTest::GetPixelColor
+  } // CInvCollisionTest::GetSceneRect
 
   //----------------------------------------------------------------------------------------------
 
-  bool CInvCollisionTest::CheckPixelPerfectCollision( const CInvSprite & sprite1, const CInvSprite & sprite2 ) const
+  bool CInvCollisionTest::CheckPixelPerfectCollision(
+    const CInvSprite & sprite1,
+    const CInvCollisionMask * scaled1,
+    const CInvSprite & sprite2,
+    const CInvCollisionMask * scaled2,
+    LONG offsetX1,
+    LONG offsetY1 ) const
   {
-    float xMin, xMax, yMin, yMax;
-
-    sprite1.GetResultingBoundingBox( xMin, xMax, yMin, yMax );
-    RECT rect1{ (LONG)floorf( xMin ), (LONG)floorf( yMin ),  (LONG)ceilf( xMax ), (LONG)ceilf( yMax ) };
+    RECT rect1 = GetSceneRect( sprite1 );
+    OffsetRect( &rect1, offsetX1, offsetY1 );
+                        // Offset is whole number of pixels, so the size of the rectangle (and
+                        // scaled collision mask used) does not change along the swept path
 
-    sprite2.GetResultingBoundingBox( xMin, xMax, yMin, yMax );
-    RECT rect2{ (LONG)floorf( xMin ), (LONG)floorf( yMin ), (LONG)ceilf( xMax ), (LONG)ceilf( yMax ) };
+    RECT rect2 = GetSceneRect( sprite2 );
 
     RECT intersection;
     if( !IntersectRect( &intersection, &rect1, &rect2 ) )
       return false;     // First, a rough overlap of bouding rectangles is calculated. If the bounding
                         // rectangles of the two textures do not overlap at all, a collision cannot occur.
 
-    D3DLOCKED_RECT lockedRect1, lockedRect2;
-    HRESULT hr1 = sprite1.GetResultingTexture()->LockRect( 0, &lockedRect1, NULL, D3DLOCK_READONLY );
-    HRESULT hr2 = sprite2.GetResultingTexture()->LockRect( 0, &lockedRect2, NULL, D3DLOCK_READONLY );
-                        // Locking both textures to access pixel data directly.
+    if( nullptr != scaled1 && nullptr != scaled2 )
+      return MasksOverlap( mMaskRowsOverlap, *scaled1, rect1, *scaled2, rect2, intersection );
+                        // Common case - masks resampled to the on-screen size of sprites are used,
+                        // pixel of the game scene corresponds directly to bit of the mask.
 
-    if( FAILED( hr1 ) || FAILED( hr2 ) )
-    {
-      LOG << "Error locking textures for pixel-perfect collision detection!";
-      return false;
-    } // if
+    const CInvCollisionMask * mask1 = sprite1.GetResultingCollisionMask();
+    const CInvCollisionMask * mask2 = sprite2.GetResultingCollisionMask();
+    if( nullptr == mask1 || nullptr == mask2 )
+      return false;     // Masks are built when images are loaded, if this failed, the error was
+                        // already reported there.
+
+    return MasksOverlapPerPixel( *mask1, rect1, sprite1.GetResultingVertices(),
+      *mask2, rect2, sprite2.GetResultingVertices(), intersection );
+                        // Flipped sprite, or the cache of scaled variants was exhausted (too many
+                        // sizes of one image in one tick); the result is the same
+
+  } // CInvCollisionTest::CheckPixelPerfectCollision
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvCollisionTest::MasksOverlap(
+    FnMaskRowsOverlap_t maskRowsOverlap,
+    const CInvCollisionMask & scaled1,
+    const RECT & rect1,
+    const CInvCollisionMask & scaled2,
+    const RECT & rect2,
+    const RECT & intersection )
+  {
+    uint32_t y1 = (uint32_t)( intersection.top - rect1.top );
+    uint32_t y2 = (uint32_t)( intersection.top - rect2.top );
+
+    return maskRowsOverlap(
+      scaled1.GetRow( y1 ), scaled1.GetWordsPerRow(), (uint32_t)( intersection.left - rect1.left ),
+      scaled2.GetRow( y2 ), scaled2.GetWordsPerRow(), (uint32_t)( intersection.left - rect2.left ),
+      (uint32_t)( intersection.right - intersection.left ),
+      (uint32_t)( intersection.bottom - intersection.top ) );
+                        // Rows of both masks within the intersection are compared by whole
+                        // words, see InvMaskOverlap.h
 
+  } // CInvCollisionTest::MasksOverlap
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvCollisionTest::MasksOverlapPerPixel(
+    const CInvCollisionMask & mask1,
+    const RECT & rect1,
+    const CUSTOMVERTEX vertices1[],
+    const CInvCollisionMask & mask2,
+    const RECT & rect2,
+    const CUSTOMVERTEX vertices2[],
+    const RECT & intersection )
+  {
     for( int y = intersection.top; y < intersection.bottom; ++y )
     {
       for( int x = intersection.left; x < intersection.right; ++x )
       {                 // Iterating through pixels in intersection rectangle.
 
         float u1, v1, u2, v2;
-        CalculateUV( x, y, rect1, sprite1.GetResultingVertices(), &u1, &v1 );
-        CalculateUV( x, y, rect2, sprite2.GetResultingVertices(), &u2, &v2 );
+        CalculateUV( x, y, rect1, vertices1, &u1, &v1 );
+        CalculateUV( x, y, rect2, vertices2, &u2, &v2 );
                         // Calculationg coordinates from absolute to relative for both textures.
 
-        D3DCOLOR color1 = GetPixelColor( lockedRect1, u1, v1, sprite1.GetResultingTexture() );
-        D3DCOLOR color2 = GetPixelColor( lockedRect2, u2, v2, sprite2.GetResultingTexture() );
-                        // Getting pixel colors from both textures at calculated coordinates.
-
-        BYTE alpha1 = ( color1 >> 24 ) & 0xFF;
-        BYTE alpha2 = ( color2 >> 24 ) & 0xFF;
-                        // Extracting alpha components from colors.
-
-        if( alpha1 > mAlphaThreshold && alpha2 > mAlphaThreshold )
-        {               // Non-transparent pixels (with some treshold) in both textures
+        if( mask1.IsSolidUV( u1, v1 ) && mask2.IsSolidUV( u2, v2 ) )
+          return true;  // Non-transparent pixels (with some treshold) in both textures
                         // at calculated positions indicate a collision.
-          sprite1.GetResultingTexture()->UnlockRect( 0 );
-          sprite2.GetResultingTexture()->UnlockRect( 0 );
-          return true;
-        } // if
+
       } // for x
     } // for y
 
-    sprite1.GetResultingTexture()->UnlockRect( 0 );
-    sprite2.GetResultingTexture()->UnlockRect( 0 );
-                        // Unlocking both textures after processing.
-
     return false;       // No collision detected after checking all pixels in intersection area.
 
-  } // CInvCollisionTest::CheckPixelPerfectCollision
+  } // CInvCollisionTest::MasksOverlapPerPixel
 
   //----------------------------------------------------------------------------------------------
 
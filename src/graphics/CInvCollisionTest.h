@@ -10,15 +10,18 @@
 #ifndef H_CInvCollisionTest
 #define H_CInvCollisionTest
 
-#include <d3d9.h>
+#include <graphics/InvD3D9.h>
 
 #include <InvGlobals.h>
 #include <CInvSettings.h>
 #include <graphics/CInvSprite.h>
+#include <graphics/InvMaskOverlap.h>
 
 namespace Inv
 {
 
+  class CInvSpriteStorage;
+
   /*! \brief Class represents a 2D CollisionTest that tests whether two sprites are in collision.*/
   class CInvCollisionTest
   {
@@ -32,24 +35,160 @@ namespace Inv
     ~CInvCollisionTest();
 
     bool AreInCollision( const CInvSprite & sprite1, const CInvSprite & sprite2 ) const;
-    /*!< \brief Tests whether two sprites are in collision.
+    /*!< \brief Tests whether two sprites are in collision. Scaled collision masks are obtained by
+         GetScaledMask(), so the method must not be called from more threads at once.
 
          \param[in] sprite1   First sprite to be tested
          \param[in] sprite2   Second sprite to be tested
          \return \b true if the sprites are in collision, false otherwise. */
 
+    bool AreInCollisionSwept(
+      const CInvSprite & sprite1,
+      float sweepX,
+      float sweepY,
+      const CInvSprite & sprite2,
+      float * contactTime = nullptr ) const;
+    /*!< \brief Tests whether the first sprite collided with the second one anywhere on its way during
+         the last tick. The first sprite is expected to move from its actual position shifted back by
+         (sweepX, sweepY) to its actual position, the second one is considered static. Swept bounding
+         boxes are tested first (slab method), then pixel-perfect test is done at positions along the
+         overlapping part of the path, with step shorter than size of the first sprite. So fast
+         projectiles cannot tunnel through their targets even when the tick rate is low.
+
+         \param[in]  sprite1      Moving sprite (projectile)
+         \param[in]  sweepX       X distance travelled by the first sprite during the last tick [px]
+         \param[in]  sweepY       Y distance travelled by the first sprite during the last tick [px]
+         \param[in]  sprite2      Second sprite to be tested
+         \param[out] contactTime  If not null, relative time of first contact within the tick is
+                                  stored here; 0 is the start of the path, 1 actual position.
+         \return \b true if the sprites collided, false otherwise. */
+
+    bool AreInCollisionSwept(
+      const CInvSprite & sprite1,
+      const CInvCollisionMask * scaled1,
+      float sweepX,
+      float sweepY,
+      const CInvSprite & sprite2,
+      const CInvCollisionMask * scaled2,
+      float * contactTime = nullptr ) const;
+    /*!< \brief Same as previous method, but scaled collision masks of both sprites were obtained by
+         GetScaledMask() in advance. Collision masks are only read then, so the method can be called
+         from more threads at once.
+
+         \param[in]  sprite1      Moving sprite (projectile)
+         \param[in]  scaled1      Scaled mask of the first sprite, result of GetScaledMask()
+         \param[in]  sweepX       X distance travelled by the first sprite during the last tick [px]
+         \param[in]  sweepY       Y distance travelled by the first sprite during the last tick [px]
+         \param[in]  sprite2      Second sprite to be tested
+         \param[in]  scaled2      Scaled mask of the second sprite, result of GetScaledMask()
+         \param[out] contactTime  If not null, relative time of first contact within the tick is
+                                  stored here; 0 is the start of the path, 1 actual position.
+         \return \b true if the sprites collided, false otherwise. */
+
+    const CInvCollisionMask * GetScaledMask( const CInvSprite & sprite ) const;
+    /*!< \brief Returns collision mask of the sprite resampled to the size of its rectangle on the
+         game scene, valid until the next StartScaledMaskUse(). Returns nullptr if the texture is
+         not mapped on the sprite directly (flip, deformation), if the sprite has no mask or if the
+         cache of scaled variants is exhausted; pixel-perfect test works per pixel then. Cache of
+         the mask is modified, so the method must not be called from more threads at once.
+
+         \param[in] sprite  Sprite whose mask is demanded
+         \return Scaled collision mask, or nullptr (see above) */
+
+    void StartScaledMaskUse() { ++mScaledMaskStamp; }
+    /*!< \brief Allows scaled collision masks obtained by previous tests to be resampled to other
+         sizes (see CInvCollisionMask::GetScaled). Masks obtained since this call are kept until
+         the next one, collision detector calls it once per tick. */
+
+    static void BenchmarkMaskOverlap( const CInvSpriteStorage & spriteStorage );
+    /*!< \brief Measures pixel-perfect test of real frames of invader (PINK) against frames of rocket
+         and spit at all positions where their bounding rectangles overlap. Per-pixel test (used
+         for all sprites before mask overlap kernels were introduced, now only for flipped ones)
+         and all kernels supported by the CPU (scalar, SSE2, AVX2) are timed, time per test and
+         number of collisions found are written to the log. Results of the kernels are compared
+         with the per-pixel test.
+
+         \param[in] spriteStorage  Storage with loaded sprites PINK, ROCKET and SPIT */
+
+    bool CheckSweptAtTickRates( const CInvSpriteStorage & spriteStorage ) const;
+    /*!< \brief Self-check of swept test: rocket (ROCKET) flies upwards through fixed invader (PINK)
+         in every column where their rectangles overlap, with the same speed at several tick rates.
+         The number of columns in which the rocket hits the invader must not depend on the tick
+         rate, otherwise fast projectiles tunnel through targets. Hits of the swept test and of the
+         test at actual positions only are written to the log.
+
+         \param[in] spriteStorage  Storage with loaded sprites PINK and ROCKET
+         \return \b true if the swept test hits the same columns at all tick rates */
+
   private:
 
     //bool CheckBoundingBoxCollision( const CInvSprite & sprite1, const CInvSprite & sprite2 ) const;
 
-    bool CheckPixelPerfectCollision( const CInvSprite & sprite1, const CInvSprite & sprite2 ) const;
+    bool CheckPixelPerfectCollision(
+      const CInvSprite & sprite1,
+      const CInvCollisionMask * scaled1,
+      const CInvSprite & sprite2,
+      const CInvCollisionMask * scaled2,
+      LONG offsetX1 = 0,
+      LONG offsetY1 = 0 ) const;
     /*!< \brief Tests whether two sprites are in pixel-perfect collision, i.e. whether any non-transparent
          pixel of the first sprite overlaps with any non-transparent pixel of the second sprite.
+         Only collision masks precomputed when images were loaded are used, textures are not
+         touched (locking textures stalls the graphic pipeline). If both scaled masks are given,
+         they are compared by whole words, otherwise the test is done per pixel.
 
          \param[in] sprite1   First sprite to be tested
+         \param[in] scaled1   Scaled mask of the first sprite (see GetScaledMask()), may be nullptr
          \param[in] sprite2   Second sprite to be tested
+         \param[in] scaled2   Scaled mask of the second sprite (see GetScaledMask()), may be nullptr
+         \param[in] offsetX1  Shift of the first sprite in X axis against its resulting position [px]
+         \param[in] offsetY1  Shift of the first sprite in Y axis against its resulting position [px]
          \return \b true if the sprites are in pixel-perfect collision, false otherwise. */
 
+    static RECT GetSceneRect( const CInvSprite & sprite );
+    /*!< \brief Returns bounding box of the sprite rounded outwards to whole pixels, i.e. the area of
+         the game scene examined by pixel-perfect test.
+
+         \param[in] sprite  Sprite whose rectangle is demanded */
+
+    static bool MasksOverlap(
+      FnMaskRowsOverlap_t maskRowsOverlap,
+      const CInvCollisionMask & scaled1,
+      const RECT & rect1,
+      const CInvCollisionMask & scaled2,
+      const RECT & rect2,
+      const RECT & intersection );
+    /*!< \brief Tests overlap of collision masks resampled to the on-screen size of sprites (identity
+         mapping of both sprites) within the intersection of their rectangles, by given kernel.
+
+         \param[in] maskRowsOverlap  Kernel comparing rows of masks (see InvMaskOverlap.h)
+         \param[in] scaled1          Mask of the first sprite, size of rect1
+         \param[in] rect1            Rectangle of the first sprite on the game scene
+         \param[in] scaled2          Mask of the second sprite, size of rect2
+         \param[in] rect2            Rectangle of the second sprite on the game scene
+         \param[in] intersection     Intersection of both rectangles, not empty
+         \return \b true if solid pixels of both masks overlap. */
+
+    static bool MasksOverlapPerPixel(
+      const CInvCollisionMask & mask1,
+      const RECT & rect1,
+      const CUSTOMVERTEX vertices1[],
+      const CInvCollisionMask & mask2,
+      const RECT & rect2,
+      const CUSTOMVERTEX vertices2[],
+      const RECT & intersection );
+    /*!< \brief Tests overlap of collision masks pixel by pixel within the intersection of rectangles,
+         texture coordinates of every pixel are calculated from vertices (any mapping).
+
+         \param[in] mask1         Mask of the first sprite (original image size)
+         \param[in] rect1         Rectangle of the first sprite on the game scene
+         \param[in] vertices1     Vertices of the first sprite
+         \param[in] mask2         Mask of the second sprite (original image size)
+         \param[in] rect2         Rectangle of the second sprite on the game scene
+         \param[in] vertices2     Vertices of the second sprite
+         \param[in] intersection  Intersection of both rectangles, not empty
+         \return \b true if solid pixels of both masks overlap. */
+
     static void CalculateUV( int x, int y, RECT boundRect, const CUSTOMVERTEX vertices[], float * u, float * v );
     /*!< \brief Calculates texture coordinates (u,v) for given pixel (x,y) on the game scene.
 
@@ -65,18 +204,12 @@ namespace Inv
          \param[out] u          Calculated U (relative texture) coordinate
          \param[out] v          Calculated V (relative texture) coordinate */
 
-    static D3DCOLOR GetPixelColor( D3DLOCKED_RECT lockedRect, float u, float v, IDirect3DTexture9 * texture );
-    /*!< \brief Gets color of pixel at given (u,v) coordinates from locked texture.
+    static bool HasIdentityMapping( const CUSTOMVERTEX vertices[] );
+    /*!< \brief Returns true if the whole texture is mapped on the rectangle without any flip or
+         deformation (vertices are in order top left, top right, bottom left, bottom right). In such
+         case, scaled collision masks can be used directly with integer pixel offsets.
 
-         \param[in] lockedRect Locked rectangle of the texture, providing access to pixel data
-         \param[in] u          U (relative texture) coordinate of pixel
-         \param[in] v          V (relative texture) coordinate of pixel
-         \param[in] texture    Pointer to texture from which the pixel is read
-         \return Color of the pixel at given (u,v) coordinates */
-
-    static constexpr BYTE mAlphaThreshold = 10;
-    //!< Alpha threshold for pixel-perfect collision detection, pixels with alpha below this
-    //!  value are considered transparent and do not contribute to collision.
+         \param[in] vertices    Array of 4 CUSTOMVERTEX structures, defining the area of the sprite */
 
     const CInvSettings & mSettings;
     //<! Reference to settings object, to access global settings
@@ -84,6 +217,13 @@ namespace Inv
     LPDIRECT3DDEVICE9 mPd3dDevice;
     //!< Direct3D device, used to create textures (CollisionTest images)
 
+    FnMaskRowsOverlap_t mMaskRowsOverlap;
+    //!< Kernel comparing rows of two collision masks, selected according to CPU capabilities
+    //!  when the object is created (see InvMaskOverlap.h)
+
+    uint64_t mScaledMaskStamp;
+    //!< Stamp of actual use of scaled collision masks, see StartScaledMaskUse()
+
   }; // class CInvCollisionTest
 
 } // namespace Inv
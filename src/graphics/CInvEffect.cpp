@@ -8,7 +8,7 @@
 // 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
 //****************************************************************************************************
 
-#include <d3dx9.h>
+#include <graphics/InvD3D9.h>
 #include <graphics/CInvEffect.h>
 
 static const std::string lModLogId( "Effect" );
@@ -11,7 +11,7 @@
 #ifndef H_CInvEffectSpriteBlink
 #define H_CInvEffectSpriteBlink
 
-#include <d3d9.h>
+#include <graphics/InvD3D9.h>
 
 #include <InvGlobals.h>
 #include <CInvSettings.h>
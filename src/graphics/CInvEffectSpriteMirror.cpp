@@ -8,7 +8,7 @@
 // 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
 //****************************************************************************************************
 
-#include <d3dx9.h>
+#include <graphics/InvD3D9.h>
 
 #include <graphics/CInvEffectSpriteMirror.h>
 
@@ -47,8 +47,7 @@ namespace Inv
 
     auto * sprite = static_cast<Inv::CInvSprite *>( obj );
 
-    std::swap( sprite->mTea2[0].x, sprite->mTea2[1].x );
-    std::swap( sprite->mTea2[2].x, sprite->mTea2[3].x );
+    sprite->Mirror();
 
     return true;
 
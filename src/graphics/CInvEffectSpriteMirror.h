@@ -11,12 +11,12 @@
 #ifndef H_CInvEffectSpriteMirror
 #define H_CInvEffectSpriteMirror
 
-#include <d3d9.h>
+#include <graphics/InvD3D9.h>
 
 #include <InvGlobals.h>
 #include <CInvSettings.h>
 
-#include <graphics/CInvSprite.h>
+#include <graphics/CInvEffect.h>
 
 namespace Inv
 {
@@ -8,7 +8,7 @@
 // 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
 //****************************************************************************************************
 
-#include <d3dx9.h>
+#include <graphics/InvD3D9.h>
 
 #include <graphics/CInvEffectSpriteShrink.h>
 
@@ -54,21 +54,7 @@ namespace Inv
 
     float actRatio = 1.0f - ( 1.0f - (float)mTicksLeft / (float)mPace ) * ( 1.0f - mFinalRatio );
 
-    float xCentre = sprite->mTea2[0].x + sprite->mHalfSizeX;
-    float yCentre = sprite->mTea2[0].y + sprite->mHalfSizeY;
-
-    sprite->mHalfSizeX *= actRatio;
-    sprite->mHalfSizeY *= actRatio;
-
-    sprite->mTea2[0].x = xCentre - sprite->mHalfSizeX;
-    sprite->mTea2[1].x = xCentre + sprite->mHalfSizeX;
-    sprite->mTea2[2].x = xCentre - sprite->mHalfSizeX;
-    sprite->mTea2[3].x = xCentre + sprite->mHalfSizeX;
-
-    sprite->mTea2[0].y =  yCentre - sprite->mHalfSizeY;
-    sprite->mTea2[1].y =  yCentre - sprite->mHalfSizeY;
-    sprite->mTea2[2].y =  yCentre + sprite->mHalfSizeY;
-    sprite->mTea2[3].y =  yCentre + sprite->mHalfSizeY;
+    sprite->Scale( actRatio );
 
     if( ! IsContinuous() )
     {
@@ -11,7 +11,7 @@
 #ifndef H_CInvScissorGuard
 #define H_CInvScissorGuard
 
-#include <d3d9.h>
+#include <graphics/InvD3D9.h>
 
 namespace Inv
 {
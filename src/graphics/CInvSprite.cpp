@@ -7,51 +7,41 @@
 // 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
 //****************************************************************************************************
 
-#include <filesystem>
-
-#include <d3dx9.h>
-
 #include <graphics/CInvSprite.h>
+#include <graphics/CInvEffect.h>
 
 #include <CInvLogger.h>
-#include <InvStringTools.h>
 
 
 static const std::string lModLogId( "SPRITE" );
 
 namespace Inv
 {
-  CInvSprite::CInvSprite( const CInvSettings & settings, LPDIRECT3DDEVICE9 pd3dDevice ):
+  CInvSprite::CInvSprite():
     mTea2{},
+    mImageIndex( 0 ),
     mHalfSizeX( 0.0f ),
     mHalfSizeY( 0.0f ),
     mEffects(),
-    mImageIndex( 0 ),
-    mSettings( settings ),
-    mPd3dDevice( pd3dDevice ),
-    mTextures(),
-    mTextureSizes(),
-    mLvl( 0.0f )
 #ifdef _DEBUG
-    , mDebugId( 0 )
+    mDebugId( 0 ),
 #endif
-  {
-  }
+    mLvl( 0.0f ),
+    mFrames()
+  {}
 
   //----------------------------------------------------------------------------------------------
 
-  CInvSprite::CInvSprite( const CInvSprite & other ):
-    mTea2{},
-    mHalfSizeX( other.mHalfSizeX ),
-    mHalfSizeY( other.mHalfSizeY ),
-    mEffects( other.mEffects ),
-    mImageIndex( other.mImageIndex ),
-    mSettings( other.mSettings ),
-    mPd3dDevice( other.mPd3dDevice ),
-    mTextures( other.mTextures ),
-    mTextureSizes( other.mTextureSizes )
+  CInvSprite::CInvSprite( const CInvSettings & settings, LPDIRECT3DDEVICE9 pd3dDevice ):
+    CInvSprite( std::make_shared<CInvSpriteFrames>( settings, pd3dDevice ) )
+  {}
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvSprite::CInvSprite( std::shared_ptr<CInvSpriteFrames> frames ):
+    CInvSprite()
   {
-    memcpy( mTea2, other.mTea2, sizeof( mTea2 ) );
+    mFrames = std::move( frames );
   } // CInvSprite::CInvSprite
 
   //----------------------------------------------------------------------------------------------
@@ -63,39 +53,13 @@ namespace Inv
 
   void CInvSprite::AddSpriteImage( const std::string & imageName )
   {
-    if( nullptr == mPd3dDevice )
+    if( nullptr == mFrames )
     {
-      LOG << "Direct3D device is null, cannot load image '" << imageName << "'.";
+      LOG << "Sprite has no set of images, cannot load image '" << imageName << "'.";
       return;
     } // if
 
-    std::filesystem::path imagePath( mSettings.GetImagePath() + "/" + imageName );
-
-    if( !std::filesystem::exists( imagePath ) )
-    {
-      LOG << "Image file '" << imagePath << "' does not exist.";
-      return;
-    } // if
-
-    IDirect3DTexture9 * tex = NULL;
-    D3DXCreateTextureFromFile( mPd3dDevice, imagePath.wstring().c_str(), &tex);
-
-    if( nullptr == tex )
-    {
-      LOG << "Cannot load image file '" << imagePath << "'.";
-      return;
-    } // if
-
-    std::pair<size_t, size_t> texSize( 0, 0 );
-    D3DXIMAGE_INFO info{};
-    if( SUCCEEDED( D3DXGetImageInfoFromFile( imagePath.wstring().c_str(), &info ) ) )
-    {
-      texSize.first = info.Width;    // original width of the image on disk
-      texSize.second = info.Height;  // original height of the image on disk
-    } // if
-
-    mTextures.push_back( tex );
-    mTextureSizes.push_back( texSize );
+    mFrames->AddImage( imageName );
 
   } // CInvSprite::AddSpriteImage
 
@@ -103,37 +67,37 @@ namespace Inv
 
   void CInvSprite::AddMultipleSpriteImages( const std::string & imageNameTemplate )
   {
-    if( nullptr == mPd3dDevice )
+    if( nullptr == mFrames )
     {
-      LOG << "Direct3D device is null, cannot load images.";
+      LOG << "Sprite has no set of images, cannot load images.";
       return;
     } // if
 
-    std::filesystem::path imagePath;
-    std::string imageTemplateFilled;
-
-    uint32_t index = 0;
-    while( index < 1000 )
-    {
-      imageTemplateFilled = FormatStr( imageNameTemplate, index + 1 );
-      imagePath = mSettings.GetImagePath() + "/" + imageTemplateFilled;
-
-      if( !std::filesystem::exists( imagePath ) )
-        break;
+    mFrames->AddMultipleImages( imageNameTemplate );
 
-      AddSpriteImage( imageTemplateFilled );
-
-      ++index;
+  } // CInvSprite::AddMultipleSpriteImages
 
-    } // while
+  //----------------------------------------------------------------------------------------------
 
-    LOG << index << " images was loaded according to template '" << imageNameTemplate << "'.";
+  void CInvSprite::Draw(
+    float xCentre,
+    float yCentre,
+    float xSize,
+    float ySize,
+    LARGE_INTEGER referenceTick,
+    LARGE_INTEGER actualTick,
+    LARGE_INTEGER diffTick,
+    uint32_t specificImageIndex,
+    DWORD color )
+  {
+    Update( xCentre, yCentre, xSize, ySize, referenceTick, actualTick, diffTick, specificImageIndex, color );
+    Render();
 
-  } // CInvSprite::AddMultipleSpriteImages
+  } // CInvSprite::Draw
 
   //----------------------------------------------------------------------------------------------
 
-  void CInvSprite::Draw(
+  void CInvSprite::Update(
     float xCentre,
     float yCentre,
     float xSize,
@@ -144,11 +108,35 @@ namespace Inv
     uint32_t specificImageIndex,
     DWORD color )
   {
-    if( nullptr == mPd3dDevice || mTextures.empty() )
+    if( !Place( xCentre, yCentre, xSize, ySize, specificImageIndex, color ) )
       return;
 
+    for( auto & effectCategory : mEffects )
+    {
+      for( auto & ef : effectCategory.second )
+        ef->ApplyEffect( this, referenceTick, actualTick, diffTick );
+    } // for
+
+    FinishUpdate();
+
+  } // CInvSprite::Update
+
+  //----------------------------------------------------------------------------------------------
+
+  bool CInvSprite::Place(
+    float xCentre,
+    float yCentre,
+    float xSize,
+    float ySize,
+    uint32_t specificImageIndex,
+    DWORD color )
+  {
+    size_t imageCount = GetNumberOfImages();
+    if( 0 == imageCount )
+      return false;
+
     mImageIndex = specificImageIndex;
-    if( (uint32_t)mTextures.size() <= mImageIndex )
+    if( imageCount <= mImageIndex )
       mImageIndex = 0;
 
     mHalfSizeX = xSize * 0.5f;
@@ -159,23 +147,21 @@ namespace Inv
     mTea2[2] = { xCentre - mHalfSizeX, yCentre + mHalfSizeY, mLvl, 1.0f, color, 0.0f, 1.0f, };
     mTea2[3] = { xCentre + mHalfSizeX, yCentre + mHalfSizeY, mLvl, 1.0f, color, 1.0f, 1.0f, };
 
-    if( !mEffects.empty() )
-    {
-      for( auto & effectCategory : mEffects )
-      {
-        for( auto & ef : effectCategory.second )
-          ef->ApplyEffect( this, referenceTick, actualTick, diffTick );
-      } // for
+    return true;
 
-      if( SIZE_MAX == mImageIndex )
-        return;         // Sprite drawing was cancelled by effect
+  } // CInvSprite::Place
 
-      if( mTextures.size() <= mImageIndex )
-        mImageIndex = 0;
-    } // if
+  //----------------------------------------------------------------------------------------------
 
-    auto tex = mTextures[mImageIndex];
-    if( nullptr == tex )
+  void CInvSprite::FinishUpdate()
+  {
+    if( SIZE_MAX == mImageIndex )
+      return;           // Sprite drawing was cancelled by effect
+
+    if( GetNumberOfImages() <= mImageIndex )
+      mImageIndex = 0;
+
+    if( nullptr == mFrames->GetTexture( mImageIndex ) )
       return;
 
     for( auto & teaItem: mTea2 )
@@ -184,11 +170,54 @@ namespace Inv
       teaItem.y -= 0.5f;
     } // for
 
-    IDirect3DTexture9 * t = (IDirect3DTexture9 *)tex;
-    mPd3dDevice->SetTexture( 0, t );
-    mPd3dDevice->DrawPrimitiveUP( D3DPT_TRIANGLESTRIP, 2, mTea2, sizeof( CUSTOMVERTEX ) );
+  } // CInvSprite::FinishUpdate
 
-  } // CInvSprite::Draw
+  //----------------------------------------------------------------------------------------------
+
+  void CInvSprite::Scale( float ratio )
+  {
+    float xCentre = mTea2[0].x + mHalfSizeX;
+    float yCentre = mTea2[0].y + mHalfSizeY;
+
+    mHalfSizeX *= ratio;
+    mHalfSizeY *= ratio;
+
+    mTea2[0].x = xCentre - mHalfSizeX;
+    mTea2[1].x = xCentre + mHalfSizeX;
+    mTea2[2].x = xCentre - mHalfSizeX;
+    mTea2[3].x = xCentre + mHalfSizeX;
+
+    mTea2[0].y = yCentre - mHalfSizeY;
+    mTea2[1].y = yCentre - mHalfSizeY;
+    mTea2[2].y = yCentre + mHalfSizeY;
+    mTea2[3].y = yCentre + mHalfSizeY;
+
+  } // CInvSprite::Scale
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvSprite::Mirror()
+  {
+    std::swap( mTea2[0].x, mTea2[1].x );
+    std::swap( mTea2[2].x, mTea2[3].x );
+  } // CInvSprite::Mirror
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvSprite::Render() const
+  {
+    if( nullptr == mFrames || nullptr == mFrames->GetDevice() )
+      return;
+
+    auto tex = mFrames->GetTexture( mImageIndex );
+    if( nullptr == tex )
+      return;           // Drawing was cancelled by effect (or the sprite was not updated yet)
+
+    LPDIRECT3DDEVICE9 pd3dDevice = mFrames->GetDevice();
+    pd3dDevice->SetTexture( 0, tex );
+    pd3dDevice->DrawPrimitiveUP( D3DPT_TRIANGLESTRIP, 2, mTea2, sizeof( CUSTOMVERTEX ) );
+
+  } // CInvSprite::Render
 
   //----------------------------------------------------------------------------------------------
 
@@ -220,14 +249,38 @@ namespace Inv
 
   std::pair<size_t, size_t> CInvSprite::GetImageSize( size_t imageIndex ) const
   {
-    if( imageIndex >= mTextureSizes.size() )
+    if( nullptr == mFrames )
       return { 0, 0 };
 
-    return mTextureSizes[imageIndex];
+    return mFrames->GetImageSize( imageIndex );
   } // GetImageSize
 
   //----------------------------------------------------------------------------------------------
 
+  IDirect3DTexture9 * CInvSprite::GetResultingTexture() const
+  {
+    if( nullptr == mFrames )
+      return nullptr;
+
+    auto tex = mFrames->GetTexture( mImageIndex );
+    return nullptr != tex ? tex : mFrames->GetTexture( 0 );
+
+  } // CInvSprite::GetResultingTexture
+
+  //----------------------------------------------------------------------------------------------
+
+  const CInvCollisionMask * CInvSprite::GetResultingCollisionMask() const
+  {
+    if( nullptr == mFrames || 0 == mFrames->GetNumberOfImages() )
+      return nullptr;
+
+    return mFrames->GetNumberOfImages() <= mImageIndex ?
+      mFrames->GetCollisionMask( 0 ) : mFrames->GetCollisionMask( mImageIndex );
+
+  } // CInvSprite::GetResultingCollisionMask
+
+  //----------------------------------------------------------------------------------------------
+
   void CInvSprite::GetResultingPosition(
     float & xTopLeft, float & yTopLeft,
     float & xBottomRight, float & yBottomRight,
@@ -10,19 +10,26 @@
 #ifndef H_CInvSprite
 #define H_CInvSprite
 
-#include <d3d9.h>
+#include <graphics/InvD3D9.h>
 
 #include <InvGlobals.h>
 #include <CInvSettings.h>
-#include <graphics/CInvEffectSpriteAnimation.h>
+#include <graphics/CInvSpriteFrames.h>
 
 namespace Inv
 {
 
+  class CInvEffect;
+
   /*! \brief Class represents a 2D sprite that can be drawn on screen. The sprite can hold multiple
       images, which can be switched to create simple animations. The sprite can have multiple effects
       applied to it, which can modify its properties such as position, size, rotation, etc. The class
-      is designed to work with Direct3D 9 and uses Direct3D textures for the images. */
+      is designed to work with Direct3D 9 and uses Direct3D textures for the images.
+
+      Images themselves are held by CInvSpriteFrames, which is shared by all copies of the sprite.
+      Sprite object holds only state of one instance (actual image, vertices, level and effects),
+      so it is small enough to be stored by value directly in the entity component (see cpGraphics)
+      and copying it allocates nothing but the effect map. */
   class CInvSprite
   {
     //------ List of allowed effect classes that can access sprite internals -------------------------
@@ -36,17 +43,30 @@ namespace Inv
 
     public:
 
+    CInvSprite();
+    /*!< \brief Creates empty sprite without any images, IsValid() returns false for it */
+
     CInvSprite( const CInvSettings & settings, LPDIRECT3DDEVICE9 pd3dDevice );
-    CInvSprite( const CInvSprite & );
+    /*!< \brief Creates sprite with its own (empty) set of images, images are added by
+         AddSpriteImage() or AddMultipleSpriteImages() */
 
-    CInvSprite & operator=( const CInvSprite & ) = delete;
+    CInvSprite( std::shared_ptr<CInvSpriteFrames> frames );
+    /*!< \brief Creates new instance of sprite sharing already loaded set of images */
+
+    CInvSprite( const CInvSprite & ) = default;
+    CInvSprite( CInvSprite && ) noexcept = default;
+    CInvSprite & operator=( const CInvSprite & ) = default;
+    CInvSprite & operator=( CInvSprite && ) noexcept = default;
     ~CInvSprite();
 
     void AddSpriteImage( const std::string & imageName );
     /*!< \brief Adds single image to sprite
 
          \param[in] imageName Name of image file to be loaded as texture, relative
-                    path to mSettings.GetImagePath() is expected. */
+                    path to mSettings.GetImagePath() is expected.
+
+         Images may be added only to sprite which owns its set of images, i.e. before the set is
+         shared with other instances (see CInvSpriteStorage). */
 
     void AddMultipleSpriteImages( const std::string & imageNameTemplate );
     /*!< \brief Adds multiple images to sprite, according to given template. The template should
@@ -59,9 +79,15 @@ namespace Inv
                                       will load files "sprite_001.png", "sprite_002.png", ... until
                                       a file is not found. */
 
-    size_t GetNumberOfImages() const { return mTextures.size(); }
+    size_t GetNumberOfImages() const { return nullptr == mFrames ? 0 : mFrames->GetNumberOfImages(); }
     /*!< \brief Returns number of images currently loaded in the sprite. */
 
+    bool IsValid() const { return nullptr != mFrames; }
+    /*!< \brief Returns true if the sprite has set of images assigned (it may still be empty). */
+
+    std::shared_ptr<CInvSpriteFrames> GetFrames() const { return mFrames; }
+    /*!< \brief Returns set of images of the sprite, shared by all its copies. */
+
     void Draw(
       float xCentre,
       float yCentre,
@@ -73,6 +99,24 @@ namespace Inv
       uint32_t specificImageIndex = 0ul,
       DWORD color = 0xffffffff );
     /*!< \brief Draws the sprite at given position and size, applying all effects before drawing.
+         It is the same as calling Update() and Render() one after another. Parameters are the
+         same as in Update(). */
+
+    void Update(
+      float xCentre,
+      float yCentre,
+      float xSize,
+      float ySize,
+      LARGE_INTEGER referenceTick,
+      LARGE_INTEGER actualTick,
+      LARGE_INTEGER diffTick,
+      uint32_t specificImageIndex = 0ul,
+      DWORD color = 0xffffffff );
+    /*!< \brief Places the sprite at given position and size and applies all effects on it (effects
+         advance animations and may fire their event callbacks). The resulting image and vertices
+         are stored in the sprite and can be read by GetResulting...() methods or drawn by Render().
+         Nothing is drawn and Direct3D device is not used, so the method may be called by game
+         simulation even if the frame is not rendered at all.
 
          \param[in] xCentre       X coordinate of sprite center
          \param[in] yCentre       Y coordinate of sprite center
@@ -85,6 +129,29 @@ namespace Inv
                                   results are required to differ somewhat from each other.
          \param[in] color         Color to modulate the sprite with, default is white (no change) */
 
+    bool Place(
+      float xCentre,
+      float yCentre,
+      float xSize,
+      float ySize,
+      uint32_t specificImageIndex = 0ul,
+      DWORD color = 0xffffffff );
+    /*!< \brief First part of Update(): places the sprite at given position and size, no effect is
+         applied. Effects held by the entity components (see procActorAnimator) are applied after
+         this call by methods SetResultingImage(), CancelDrawing(), Scale() and Mirror(), then
+         FinishUpdate() must be called. Parameters are the same as in Update().
+
+         \return False if the sprite has no images, nothing is placed then. */
+
+    void FinishUpdate();
+    /*!< \brief Last part of Update(), called after all effects were applied. Resulting image index
+         is checked and vertices are aligned to pixel centres. */
+
+    void Render() const;
+    /*!< \brief Draws the sprite as it was computed by last call of Update(). No effect is applied,
+         so the method has no side effects on the game state. Nothing is drawn if the drawing was
+         cancelled by some effect (blinking, for example). */
+
     void AddEffect( std::shared_ptr<CInvEffect> effect );
     /*!< \brief Adds effect to sprite, if not already present
 
@@ -110,12 +177,15 @@ namespace Inv
     /*!< \brief Returns level of sprite, used for "sorting" sprites before drawing. Higher
           level means the sprite is drawn on top of lower level sprites. */
 
-    IDirect3DTexture9 * GetResultingTexture() const
-    { return mTextures.size() <= mImageIndex ? mTextures[0] : mTextures[mImageIndex]; }
+    IDirect3DTexture9 * GetResultingTexture() const;
     /*!< \brief Returns resulting texture of the sprite after all effects have been applied. */
 
     auto GetResultingVertices() const { return mTea2; }
 
+    const CInvCollisionMask * GetResultingCollisionMask() const;
+    /*!< \brief Returns collision mask of the resulting image of the sprite after all effects have
+         been applied. May return nullptr if the mask could not be created when the image was loaded. */
+
 
     void GetResultingPosition(
       float & xTopLeft, float & yTopLeft,
@@ -140,6 +210,21 @@ namespace Inv
     float GetResultingSizeY() const { return 2.0f * mHalfSizeY; }
     /*!< \brief Returns resulting size of sprite in Y direction, after all effects have been applied¨*/
 
+    size_t GetResultingImage() const { return mImageIndex; }
+    /*!< \brief Returns index of image to be drawn, SIZE_MAX if the drawing was cancelled */
+
+    void SetResultingImage( size_t imageIndex ) { mImageIndex = imageIndex; }
+    /*!< \brief Sets index of image to be drawn, used by animation effects */
+
+    void CancelDrawing() { mImageIndex = SIZE_MAX; }
+    /*!< \brief Sprite is not drawn in actual tick, used by blinking effect */
+
+    void Scale( float ratio );
+    /*!< \brief Scales the placed sprite around its centre, used by shrinking effect */
+
+    void Mirror();
+    /*!< \brief Mirrors the placed sprite along vertical axis */
+
 #ifdef _DEBUG
     void SetDebugId( uint32_t id ) { mDebugId = id; }
 #endif
@@ -171,17 +256,8 @@ namespace Inv
     float mLvl;
     //<! \brief Level of depth in which the sprite is drawn.
 
-    const CInvSettings & mSettings;
-    //<! Reference to settings object, to access global settings
-
-    LPDIRECT3DDEVICE9 mPd3dDevice;
-    //!< Direct3D device, used to create textures (sprite images)
-
-    std::vector<IDirect3DTexture9 *> mTextures;
-    //!< List of textures (images) that make up the sprite
-
-    std::vector<std::pair<size_t, size_t>> mTextureSizes;
-    //!< List of sizes of individual images, in pixels
+    std::shared_ptr<CInvSpriteFrames> mFrames;
+    //!< Images (textures, their sizes and collision masks) shared among all copies of the sprite
 
   };
 
@@ -0,0 +1,125 @@
+//****************************************************************************************************
+//! \file CInvSpriteFrames.cpp
+//! Module defines class CInvSpriteFrames, immutable set of images shared by all copies of a sprite.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <filesystem>
+
+#include <graphics/InvD3D9.h>
+
+#include <graphics/CInvSpriteFrames.h>
+
+#include <CInvLogger.h>
+#include <InvStringTools.h>
+
+
+static const std::string lModLogId( "SPRITE" );
+
+namespace Inv
+{
+  CInvSpriteFrames::CInvSpriteFrames( const CInvSettings & settings, LPDIRECT3DDEVICE9 pd3dDevice ):
+    mSettings( settings ),
+    mPd3dDevice( pd3dDevice ),
+    mTextures(),
+    mTextureSizes(),
+    mCollisionMasks()
+  {}
+
+  //----------------------------------------------------------------------------------------------
+
+  CInvSpriteFrames::~CInvSpriteFrames() = default;
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvSpriteFrames::AddImage( const std::string & imageName )
+  {
+    if( nullptr == mPd3dDevice )
+    {
+      LOG << "Direct3D device is null, cannot load image '" << imageName << "'.";
+      return;
+    } // if
+
+    std::filesystem::path imagePath( mSettings.GetImagePath() + "/" + imageName );
+
+    if( !std::filesystem::exists( imagePath ) )
+    {
+      LOG << "Image file '" << imagePath << "' does not exist.";
+      return;
+    } // if
+
+    IDirect3DTexture9 * tex = NULL;
+    D3DXCreateTextureFromFile( mPd3dDevice, imagePath.wstring().c_str(), &tex);
+
+    if( nullptr == tex )
+    {
+      LOG << "Cannot load image file '" << imagePath << "'.";
+      return;
+    } // if
+
+    std::pair<size_t, size_t> texSize( 0, 0 );
+    D3DXIMAGE_INFO info{};
+    if( SUCCEEDED( D3DXGetImageInfoFromFile( imagePath.wstring().c_str(), &info ) ) )
+    {
+      texSize.first = info.Width;    // original width of the image on disk
+      texSize.second = info.Height;  // original height of the image on disk
+    } // if
+
+    auto mask = CInvCollisionMask::CreateFromTexture( tex );
+    if( nullptr == mask )
+      LOG << "Cannot create collision mask for image file '" << imagePath << "'.";
+                        // Mask is built once here, so the collision detection does not need
+                        // to lock the texture during the game.
+
+    mTextures.push_back( tex );
+    mTextureSizes.push_back( texSize );
+    mCollisionMasks.push_back( mask );
+
+  } // CInvSpriteFrames::AddImage
+
+  //----------------------------------------------------------------------------------------------
+
+  void CInvSpriteFrames::AddMultipleImages( const std::string & imageNameTemplate )
+  {
+    if( nullptr == mPd3dDevice )
+    {
+      LOG << "Direct3D device is null, cannot load images.";
+      return;
+    } // if
+
+    std::filesystem::path imagePath;
+    std::string imageTemplateFilled;
+
+    uint32_t index = 0;
+    while( index < 1000 )
+    {
+      imageTemplateFilled = FormatStr( imageNameTemplate, index + 1 );
+      imagePath = mSettings.GetImagePath() + "/" + imageTemplateFilled;
+
+      if( !std::filesystem::exists( imagePath ) )
+        break;
+
+      AddImage( imageTemplateFilled );
+
+      ++index;
+
+    } // while
+
+    LOG << index << " images was loaded according to template '" << imageNameTemplate << "'.";
+
+  } // CInvSpriteFrames::AddMultipleImages
+
+  //----------------------------------------------------------------------------------------------
+
+  std::pair<size_t, size_t> CInvSpriteFrames::GetImageSize( size_t imageIndex ) const
+  {
+    if( imageIndex >= mTextureSizes.size() )
+      return { 0, 0 };
+
+    return mTextureSizes[imageIndex];
+  } // CInvSpriteFrames::GetImageSize
+
+} // namespace Inv
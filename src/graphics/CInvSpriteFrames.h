@@ -0,0 +1,81 @@
+//****************************************************************************************************
+//! \file CInvSpriteFrames.h
+//! Module declares class CInvSpriteFrames, immutable set of images shared by all copies of a sprite.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_CInvSpriteFrames
+#define H_CInvSpriteFrames
+
+#include <graphics/InvD3D9.h>
+
+#include <InvGlobals.h>
+#include <CInvSettings.h>
+#include <graphics/CInvCollisionMask.h>
+
+namespace Inv
+{
+
+  /*! \brief Class represents set of images (frames) of a sprite: textures, their sizes and collision
+      masks. Images are loaded once when the sprite is defined (see CInvSpriteStorage), then the set
+      is not changed and all copies of the sprite share it. Copy of a sprite therefore holds only its
+      own state (actual image, vertices, effects), it does not allocate per-image vectors. */
+  class CInvSpriteFrames
+  {
+  public:
+
+    CInvSpriteFrames( const CInvSettings & settings, LPDIRECT3DDEVICE9 pd3dDevice );
+
+    CInvSpriteFrames( const CInvSpriteFrames & ) = delete;
+    CInvSpriteFrames & operator=( const CInvSpriteFrames & ) = delete;
+    ~CInvSpriteFrames();
+
+    void AddImage( const std::string & imageName );
+    /*!< \brief Adds single image, see CInvSprite::AddSpriteImage() */
+
+    void AddMultipleImages( const std::string & imageNameTemplate );
+    /*!< \brief Adds images according to template, see CInvSprite::AddMultipleSpriteImages() */
+
+    size_t GetNumberOfImages() const { return mTextures.size(); }
+    /*!< \brief Returns number of loaded images */
+
+    std::pair<size_t, size_t> GetImageSize( size_t imageIndex ) const;
+    /*!< \brief Returns size of image at given index in pixels, (0,0) if index is out of range */
+
+    IDirect3DTexture9 * GetTexture( size_t imageIndex ) const
+    { return mTextures.size() <= imageIndex ? nullptr : mTextures[imageIndex]; }
+    /*!< \brief Returns texture of image at given index, nullptr if index is out of range */
+
+    const CInvCollisionMask * GetCollisionMask( size_t imageIndex ) const
+    { return mCollisionMasks.size() <= imageIndex ? nullptr : mCollisionMasks[imageIndex].get(); }
+    /*!< \brief Returns collision mask of image at given index, nullptr if index is out of range or
+         the mask could not be created when the image was loaded */
+
+    LPDIRECT3DDEVICE9 GetDevice() const { return mPd3dDevice; }
+    /*!< \brief Returns Direct3D device the textures belong to */
+
+  private:
+
+    const CInvSettings & mSettings;
+    //<! Reference to settings object, to access global settings
+
+    LPDIRECT3DDEVICE9 mPd3dDevice;
+    //!< Direct3D device, used to create textures (sprite images)
+
+    std::vector<IDirect3DTexture9 *> mTextures;
+    //!< List of textures (images) that make up the sprite
+
+    std::vector<std::pair<size_t, size_t>> mTextureSizes;
+    //!< List of sizes of individual images, in pixels
+
+    std::vector<std::shared_ptr<CInvCollisionMask>> mCollisionMasks;
+    //!< List of collision masks of individual images, built when image is loaded
+
+  }; // class CInvSpriteFrames
+
+} // namespace Inv
+
+#endif
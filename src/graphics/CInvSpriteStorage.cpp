@@ -66,5 +66,17 @@ namespace Inv
 
   //----------------------------------------------------------------------------------------------
 
+  CInvSprite CInvSpriteStorage::GetSpriteInstance( const std::string & spriteId ) const
+  {
+    auto findIt = mSpriteMap.find( spriteId );
+    if( findIt == mSpriteMap.end() )
+      return CInvSprite();
+
+    return *findIt->second;
+
+  } // CInvSpriteStorage::GetSpriteInstance
+
+  //----------------------------------------------------------------------------------------------
+
 
 } // namespace Inv
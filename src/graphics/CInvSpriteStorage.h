@@ -10,7 +10,7 @@
 #ifndef H_CInvSpriteStorage
 #define H_CInvSpriteStorage
 
-#include <d3d9.h>
+#include <graphics/InvD3D9.h>
 
 #include <InvGlobals.h>
 #include <CInvSettings.h>
@@ -58,6 +58,14 @@ namespace Inv
          \returns Copy of sprite with given ID, or nullptr if no such sprite exists.
                   Only CInvSprite is copied, textures in device have same references. */
 
+    CInvSprite GetSpriteInstance( const std::string & spriteId ) const;
+    /*!< \brief Returns new instance of sprite with given ID by value, so it can be stored directly
+         in entity component. Instance shares images with the stored sprite, nothing but the map
+         of effects is copied. If no such sprite exists, invalid sprite is returned (see
+         CInvSprite::IsValid()).
+
+         \param[in] spriteId ID of the sprite to be retrieved. */
+
   private:
 
     const CInvSettings & mSettings;
@@ -12,6 +12,7 @@
 #include <CInvLogger.h>
 #include <InvStringTools.h>
 #include <graphics/CInvText.h>
+#include <graphics/CInvEffect.h>
 
 static const std::string lModLogId( "Text" );
 
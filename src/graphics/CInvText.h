@@ -10,7 +10,7 @@
 #ifndef H_CInvText
 #define H_CInvText
 
-#include <d3d9.h>
+#include <graphics/InvD3D9.h>
 
 #include <InvGlobals.h>
 #include <CInvSettings.h>
@@ -0,0 +1,21 @@
+//****************************************************************************************************
+//! \file InvD3D9.h
+//! Module selects graphics backend - Direct3D 9 with D3DX, or its null replacement used by the
+//! headless build (INV_NULL_GRAPHICS defined).
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_InvD3D9
+#define H_InvD3D9
+
+#ifdef INV_NULL_GRAPHICS
+#include <graphics/InvNullD3D9.h>
+#else
+#include <d3d9.h>
+#include <d3dx9.h>
+#endif
+
+#endif
@@ -0,0 +1,235 @@
+//****************************************************************************************************
+//! \file InvMaskOverlap.cpp
+//! Module contains kernels testing overlap of two packed 1-bit collision masks (see CInvCollisionMask)
+//! and selection of the best kernel for the CPU the game runs on.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <graphics/InvMaskOverlap.h>
+
+#ifdef INV_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace Inv
+{
+
+  static inline uint64_t lTailMask( uint32_t bitsLeft )
+  { return ( 64 <= bitsLeft ) ? ~0ull : ( ( 1ull << bitsLeft ) - 1ull ); }
+  //!< Returns mask of valid bits for chunk in which only \e bitsLeft pixels remain
+
+  //----------------------------------------------------------------------------------------------
+
+  bool MaskRowsOverlapScalar(
+    const uint64_t * rows1, uint32_t stride1, uint32_t bitOffset1,
+    const uint64_t * rows2, uint32_t stride2, uint32_t bitOffset2,
+    uint32_t width, uint32_t height )
+  {
+    const uint32_t word1 = bitOffset1 >> 6;
+    const uint32_t shift1 = bitOffset1 & 63;
+    const uint32_t word2 = bitOffset2 >> 6;
+    const uint32_t shift2 = bitOffset2 & 63;
+                        // Offsets of windows are the same for all rows and the shift is the
+                        // same for all words of the row, only word index changes.
+
+    for( uint32_t y = 0; y < height; ++y, rows1 += stride1, rows2 += stride2 )
+    {
+      uint32_t chunk = 0;
+      for( uint32_t done = 0; done < width; done += 64, ++chunk )
+      {
+        const uint64_t * p1 = rows1 + word1 + chunk;
+        const uint64_t * p2 = rows2 + word2 + chunk;
+
+        uint64_t w1 = shift1 ? ( p1[0] >> shift1 ) | ( p1[1] << ( 64 - shift1 ) ) : p1[0];
+        uint64_t w2 = shift2 ? ( p2[0] >> shift2 ) | ( p2[1] << ( 64 - shift2 ) ) : p2[0];
+                        // 64 pixels of both windows, aligned to the same position
+
+        if( 0 != ( w1 & w2 & lTailMask( width - done ) ) )
+          return true;
+      } // for done
+    } // for y
+
+    return false;
+
+  } // MaskRowsOverlapScalar
+
+#ifdef INV_X86
+
+  //----------------------------------------------------------------------------------------------
+
+  bool MaskRowsOverlapSse2(
+    const uint64_t * rows1, uint32_t stride1, uint32_t bitOffset1,
+    const uint64_t * rows2, uint32_t stride2, uint32_t bitOffset2,
+    uint32_t width, uint32_t height )
+  {
+    const uint32_t word1 = bitOffset1 >> 6;
+    const uint32_t word2 = bitOffset2 >> 6;
+
+    const __m128i shR1 = _mm_cvtsi32_si128( (int)( bitOffset1 & 63 ) );
+    const __m128i shL1 = _mm_cvtsi32_si128( (int)( 64 - ( bitOffset1 & 63 ) ) );
+    const __m128i shR2 = _mm_cvtsi32_si128( (int)( bitOffset2 & 63 ) );
+    const __m128i shL2 = _mm_cvtsi32_si128( (int)( 64 - ( bitOffset2 & 63 ) ) );
+                        // Shift by 64 gives zero in SSE2, so zero shift needs no special branch
+    const __m128i zero = _mm_setzero_si128();
+
+    uint32_t y = 0;
+    for( ; y + 2 <= height; y += 2 )
+    {                   // Two rows are processed at once, each in one 64-bit lane
+      const uint64_t * r1a = rows1 + (size_t)y * stride1 + word1;
+      const uint64_t * r1b = r1a + stride1;
+      const uint64_t * r2a = rows2 + (size_t)y * stride2 + word2;
+      const uint64_t * r2b = r2a + stride2;
+
+      uint32_t chunk = 0;
+      for( uint32_t done = 0; done < width; done += 64, ++chunk )
+      {
+        __m128i lo1 = _mm_set_epi64x( (long long)r1b[chunk], (long long)r1a[chunk] );
+        __m128i hi1 = _mm_set_epi64x( (long long)r1b[chunk + 1], (long long)r1a[chunk + 1] );
+        __m128i lo2 = _mm_set_epi64x( (long long)r2b[chunk], (long long)r2a[chunk] );
+        __m128i hi2 = _mm_set_epi64x( (long long)r2b[chunk + 1], (long long)r2a[chunk + 1] );
+
+        __m128i w1 = _mm_or_si128( _mm_srl_epi64( lo1, shR1 ), _mm_sll_epi64( hi1, shL1 ) );
+        __m128i w2 = _mm_or_si128( _mm_srl_epi64( lo2, shR2 ), _mm_sll_epi64( hi2, shL2 ) );
+        __m128i m = _mm_and_si128( _mm_and_si128( w1, w2 ),
+          _mm_set1_epi64x( (long long)lTailMask( width - done ) ) );
+
+        if( 0xFFFF != _mm_movemask_epi8( _mm_cmpeq_epi32( m, zero ) ) )
+          return true;
+      } // for done
+    } // for y
+
+    if( y < height )    // Odd row left
+      return MaskRowsOverlapScalar(
+        rows1 + (size_t)y * stride1, stride1, bitOffset1,
+        rows2 + (size_t)y * stride2, stride2, bitOffset2,
+        width, height - y );
+
+    return false;
+
+  } // MaskRowsOverlapSse2
+
+  //----------------------------------------------------------------------------------------------
+
+  INV_TARGET_AVX2 bool MaskRowsOverlapAvx2(
+    const uint64_t * rows1, uint32_t stride1, uint32_t bitOffset1,
+    const uint64_t * rows2, uint32_t stride2, uint32_t bitOffset2,
+    uint32_t width, uint32_t height )
+  {
+    const uint32_t word1 = bitOffset1 >> 6;
+    const uint32_t word2 = bitOffset2 >> 6;
+
+    const __m128i shR1 = _mm_cvtsi32_si128( (int)( bitOffset1 & 63 ) );
+    const __m128i shL1 = _mm_cvtsi32_si128( (int)( 64 - ( bitOffset1 & 63 ) ) );
+    const __m128i shR2 = _mm_cvtsi32_si128( (int)( bitOffset2 & 63 ) );
+    const __m128i shL2 = _mm_cvtsi32_si128( (int)( 64 - ( bitOffset2 & 63 ) ) );
+
+    uint32_t y = 0;
+    for( ; y + 4 <= height; y += 4 )
+    {                   // Four rows are processed at once, each in one 64-bit lane
+      const uint64_t * r1 = rows1 + (size_t)y * stride1 + word1;
+      const uint64_t * r2 = rows2 + (size_t)y * stride2 + word2;
+
+      uint32_t chunk = 0;
+      for( uint32_t done = 0; done < width; done += 64, ++chunk )
+      {
+        const uint64_t * c1 = r1 + chunk;
+        const uint64_t * c2 = r2 + chunk;
+
+        __m256i lo1 = _mm256_set_epi64x(
+          (long long)c1[3 * stride1], (long long)c1[2 * stride1], (long long)c1[stride1], (long long)c1[0] );
+        __m256i hi1 = _mm256_set_epi64x(
+          (long long)c1[3 * stride1 + 1], (long long)c1[2 * stride1 + 1], (long long)c1[stride1 + 1], (long long)c1[1] );
+        __m256i lo2 = _mm256_set_epi64x(
+          (long long)c2[3 * stride2], (long long)c2[2 * stride2], (long long)c2[stride2], (long long)c2[0] );
+        __m256i hi2 = _mm256_set_epi64x(
+          (long long)c2[3 * stride2 + 1], (long long)c2[2 * stride2 + 1], (long long)c2[stride2 + 1], (long long)c2[1] );
+
+        __m256i w1 = _mm256_or_si256( _mm256_srl_epi64( lo1, shR1 ), _mm256_sll_epi64( hi1, shL1 ) );
+        __m256i w2 = _mm256_or_si256( _mm256_srl_epi64( lo2, shR2 ), _mm256_sll_epi64( hi2, shL2 ) );
+        __m256i m = _mm256_and_si256( _mm256_and_si256( w1, w2 ),
+          _mm256_set1_epi64x( (long long)lTailMask( width - done ) ) );
+
+        if( !_mm256_testz_si256( m, m ) )
+          return true;
+      } // for done
+    } // for y
+
+    if( y < height )    // Up to three rows left
+      return MaskRowsOverlapSse2(
+        rows1 + (size_t)y * stride1, stride1, bitOffset1,
+        rows2 + (size_t)y * stride2, stride2, bitOffset2,
+        width, height - y );
+
+    return false;
+
+  } // MaskRowsOverlapAvx2
+
+#endif
+
+  //----------------------------------------------------------------------------------------------
+
+  void GetSimdSupport( bool & hasSse2, bool & hasAvx2 )
+  {
+    hasSse2 = false;
+    hasAvx2 = false;
+
+#ifdef INV_X86
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid( info, 0 );
+    int maxLeaf = info[0];
+
+    __cpuid( info, 1 );
+    hasSse2 = 0 != ( info[3] & ( 1 << 26 ) );
+    bool hasOsXSave = 0 != ( info[2] & ( 1 << 27 ) );
+    bool hasAvx = 0 != ( info[2] & ( 1 << 28 ) );
+
+    if( hasOsXSave && hasAvx && 7 <= maxLeaf && 0x6 == ( _xgetbv( 0 ) & 0x6 ) )
+    {                   // OS must save YMM registers on context switch, otherwise AVX
+                        // instructions cannot be used even if the CPU supports them
+      __cpuidex( info, 7, 0 );
+      hasAvx2 = 0 != ( info[1] & ( 1 << 5 ) );
+    } // if
+#else
+    hasSse2 = __builtin_cpu_supports( "sse2" );
+    hasAvx2 = __builtin_cpu_supports( "avx2" );
+#endif
+#endif
+
+  } // GetSimdSupport
+
+  //----------------------------------------------------------------------------------------------
+
+  FnMaskRowsOverlap_t SelectMaskRowsOverlapKernel( const char ** kernelName )
+  {
+    const char * name = "scalar";
+    FnMaskRowsOverlap_t kernel = MaskRowsOverlapScalar;
+
+#ifdef INV_X86
+    bool hasSse2 = false;
+    bool hasAvx2 = false;
+    GetSimdSupport( hasSse2, hasAvx2 );
+
+    if( hasSse2 )
+    {                   // AVX2 kernel is not selected even if it is supported. Game sprites are
+                        // at most 64 pixels wide, so row is one word and gathering of four rows
+                        // costs more than the wider AND saves (see --BenchMaskOverlap).
+      name = "SSE2";
+      kernel = MaskRowsOverlapSse2;
+    } // if
+#endif
+
+    if( nullptr != kernelName )
+      *kernelName = name;
+
+    return kernel;
+
+  } // SelectMaskRowsOverlapKernel
+
+} // namespace Inv
@@ -0,0 +1,65 @@
+//****************************************************************************************************
+//! \file InvMaskOverlap.h
+//! Module contains kernels testing overlap of two packed 1-bit collision masks (see CInvCollisionMask)
+//! and selection of the best kernel for the CPU the game runs on.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_InvMaskOverlap
+#define H_InvMaskOverlap
+
+#include <InvGlobals.h>
+
+namespace Inv
+{
+
+  using FnMaskRowsOverlap_t = bool( * )(
+    const uint64_t * rows1, uint32_t stride1, uint32_t bitOffset1,
+    const uint64_t * rows2, uint32_t stride2, uint32_t bitOffset2,
+    uint32_t width, uint32_t height );
+  //!< \brief Type of kernel testing whether two rectangular windows of packed masks have any common
+  //!  solid pixel. The window of the first mask starts at pixel \e bitOffset1 of row \e rows1, rows
+  //!  follow with \e stride1 words; the same holds for the second mask. Both windows have size
+  //!  \e width x \e height pixels. Rows must be padded by one word (as CInvCollisionMask does), so
+  //!  the 64-bit window starting at any pixel of the row can be read. Rows are compared by shifting
+  //!  them to common alignment and AND-ing whole words, so no per-pixel work is done.
+
+  bool MaskRowsOverlapScalar(
+    const uint64_t * rows1, uint32_t stride1, uint32_t bitOffset1,
+    const uint64_t * rows2, uint32_t stride2, uint32_t bitOffset2,
+    uint32_t width, uint32_t height );
+  //!< \brief Portable implementation of FnMaskRowsOverlap_t, one 64-bit word at a time.
+
+#ifdef INV_X86
+
+  bool MaskRowsOverlapSse2(
+    const uint64_t * rows1, uint32_t stride1, uint32_t bitOffset1,
+    const uint64_t * rows2, uint32_t stride2, uint32_t bitOffset2,
+    uint32_t width, uint32_t height );
+  //!< \brief SSE2 implementation of FnMaskRowsOverlap_t, two rows are processed at once.
+
+  bool MaskRowsOverlapAvx2(
+    const uint64_t * rows1, uint32_t stride1, uint32_t bitOffset1,
+    const uint64_t * rows2, uint32_t stride2, uint32_t bitOffset2,
+    uint32_t width, uint32_t height );
+  //!< \brief AVX2 implementation of FnMaskRowsOverlap_t, four rows are processed at once. Must
+  //!  not be called if the CPU (or OS) does not support AVX2. Rows of four different strides are
+  //!  gathered word by word, which makes the kernel slower than SSE2 one on narrow masks, so it
+  //!  is never selected by SelectMaskRowsOverlapKernel() and is kept for benchmark only.
+#endif
+
+  void GetSimdSupport( bool & hasSse2, bool & hasAvx2 );
+  //!< \brief Detects SIMD instruction sets usable on the CPU (and OS) the game runs on. Both flags
+  //!  are false on other than x86 platforms.
+
+  FnMaskRowsOverlap_t SelectMaskRowsOverlapKernel( const char ** kernelName = nullptr );
+  //!< \brief Returns kernel used by the game: SSE2 one if the CPU supports it (CPUID based
+  //!  runtime dispatch), scalar one otherwise. If \e kernelName is given, it is set to static
+  //!  name of the kernel.
+
+} // namespace Inv
+
+#endif
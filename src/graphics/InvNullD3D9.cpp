@@ -0,0 +1,179 @@
+//****************************************************************************************************
+//! \file InvNullD3D9.cpp
+//! Module defines null replacement of the Direct3D 9 and D3DX subset used by the game.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#include <filesystem>
+#include <fstream>
+
+#include <png.h>
+
+#include <graphics/InvNullD3D9.h>
+
+static uint32_t lReadBE16( const uint8_t * p ) { return ( (uint32_t)p[0] << 8 ) | p[1]; }
+  //!< Reads big endian 16-bit number (JPEG header)
+
+static uint32_t lReadBE32( const uint8_t * p ) { return ( lReadBE16( p ) << 16 ) | lReadBE16( p + 2 ); }
+  //!< Reads big endian 32-bit number (PNG header)
+
+//----------------------------------------------------------------------------------------------------
+
+ULONG IUnknown::Release()
+{
+  ULONG refCount = --mRefCount;
+  if( 0 == refCount )
+    delete this;
+  return refCount;
+} // IUnknown::Release
+
+//----------------------------------------------------------------------------------------------------
+
+HRESULT IDirect3DTexture9::GetLevelDesc( UINT level, D3DSURFACE_DESC * desc )
+{
+  if( 0 != level || nullptr == desc )
+    return E_FAIL;
+
+  *desc = D3DSURFACE_DESC{ D3DFMT_A8R8G8B8, mWidth, mHeight };
+  return S_OK;
+} // IDirect3DTexture9::GetLevelDesc
+
+//----------------------------------------------------------------------------------------------------
+
+HRESULT IDirect3DTexture9::LockRect( UINT level, D3DLOCKED_RECT * lockedRect, const RECT *, DWORD )
+{
+  if( 0 != level || nullptr == lockedRect || mPixels.empty() )
+    return E_FAIL;
+
+  lockedRect->Pitch = (int)( mWidth * sizeof( D3DCOLOR ) );
+  lockedRect->pBits = mPixels.data();
+  return S_OK;
+} // IDirect3DTexture9::LockRect
+
+//----------------------------------------------------------------------------------------------------
+
+HRESULT IDirect3DTexture9::UnlockRect( UINT level )
+{
+  return ( 0 == level ) ? S_OK : E_FAIL;
+} // IDirect3DTexture9::UnlockRect
+
+//----------------------------------------------------------------------------------------------------
+
+HRESULT IDirect3DDevice9::GetRenderState( D3DRENDERSTATETYPE state, DWORD * value )
+{
+  if( mRenderStates.size() <= (size_t)state )
+    return E_FAIL;
+
+  *value = mRenderStates[state];
+  return S_OK;
+} // IDirect3DDevice9::GetRenderState
+
+//----------------------------------------------------------------------------------------------------
+
+HRESULT IDirect3DDevice9::SetRenderState( D3DRENDERSTATETYPE state, DWORD value )
+{
+  if( mRenderStates.size() <= (size_t)state )
+    return E_FAIL;
+
+  mRenderStates[state] = value;
+  return S_OK;
+} // IDirect3DDevice9::SetRenderState
+
+//----------------------------------------------------------------------------------------------------
+
+HRESULT IDirect3DDevice9::CreateStateBlock( D3DSTATEBLOCKTYPE, IDirect3DStateBlock9 ** stateBlock )
+{
+  *stateBlock = new IDirect3DStateBlock9();
+  return S_OK;
+} // IDirect3DDevice9::CreateStateBlock
+
+//----------------------------------------------------------------------------------------------------
+
+HRESULT D3DXGetImageInfoFromFile( const wchar_t * srcFile, D3DXIMAGE_INFO * srcInfo )
+{
+  std::ifstream inFile( std::filesystem::path( srcFile ), std::ifstream::binary );
+  if( !inFile.is_open() || nullptr == srcInfo )
+    return E_FAIL;
+
+  uint8_t header[24];
+  if( !inFile.read( (char *)header, sizeof( header ) ) )
+    return E_FAIL;
+
+  if( 0 == memcmp( header, "\x89PNG", 4 ) )
+  {                     // IHDR chunk is always the first one, width and height start its data
+    srcInfo->Width = lReadBE32( header + 16 );
+    srcInfo->Height = lReadBE32( header + 20 );
+    return S_OK;
+  } // if
+
+  if( 0xFF != header[0] || 0xD8 != header[1] )
+    return E_FAIL;      // Neither PNG nor JPEG
+
+  inFile.seekg( 2 );
+  uint8_t segment[9];
+  while( inFile.read( (char *)segment, 4 ) )
+  {                     // JPEG segments are walked until start of frame, which holds dimensions
+    if( 0xFF != segment[0] )
+      return E_FAIL;
+
+    uint8_t marker = segment[1];
+    uint32_t length = lReadBE16( segment + 2 );
+    bool startOfFrame = 0xC0 <= marker && marker <= 0xCF && 0xC4 != marker && 0xC8 != marker && 0xCC != marker;
+    if( startOfFrame )
+    {
+      if( !inFile.read( (char *)segment + 4, 5 ) )
+        return E_FAIL;
+      srcInfo->Height = lReadBE16( segment + 5 );
+      srcInfo->Width = lReadBE16( segment + 7 );
+      return S_OK;
+    } // if
+
+    inFile.seekg( length - 2, std::ios_base::cur );
+  } // while
+
+  return E_FAIL;
+
+} // D3DXGetImageInfoFromFile
+
+//----------------------------------------------------------------------------------------------------
+
+HRESULT D3DXCreateTextureFromFile( LPDIRECT3DDEVICE9 device, const wchar_t * srcFile, LPDIRECT3DTEXTURE9 * texture )
+{
+  *texture = nullptr;
+
+  D3DXIMAGE_INFO info{};
+  if( nullptr == device || FAILED( D3DXGetImageInfoFromFile( srcFile, &info ) ) )
+    return E_FAIL;
+
+  std::filesystem::path path( srcFile );
+  auto tex = new IDirect3DTexture9( info.Width, info.Height );
+
+  std::string ext = path.extension().string();
+  if( ".png" == ext || ".PNG" == ext )
+  {
+    png_image image{};
+    image.version = PNG_IMAGE_VERSION;
+    bool loaded = 0 != png_image_begin_read_from_file( &image, path.string().c_str() );
+    if( loaded )
+    {
+      image.format = PNG_FORMAT_BGRA;
+                        // Bytes B, G, R, A form D3DCOLOR (A8R8G8B8) on little endian machine
+      loaded = image.width == info.Width && image.height == info.Height &&
+               0 != png_image_finish_read( &image, nullptr, tex->mPixels.data(), 0, nullptr );
+    } // if
+
+    if( !loaded )
+    {
+      png_image_free( &image );
+      tex->Release();
+      return E_FAIL;
+    } // if
+  } // if
+
+  *texture = tex;
+  return S_OK;
+
+} // D3DXCreateTextureFromFile
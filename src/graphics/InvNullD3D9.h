@@ -0,0 +1,187 @@
+//****************************************************************************************************
+//! \file InvNullD3D9.h
+//! Module declares null replacement of the Direct3D 9 and D3DX subset used by the game. Device
+//! draws nothing, textures keep pixels of loaded image, so that collision masks are built from the
+//! same data as in the full game.
+//****************************************************************************************************
+//
+//****************************************************************************************************
+// 3. 10. 2025, V. Pospíšil, gdermog@seznam.cz
+//****************************************************************************************************
+
+#ifndef H_InvNullD3D9
+#define H_InvNullD3D9
+
+#include <array>
+#include <vector>
+
+#include <InvPlatform.h>
+
+//------ Types and constants -------------------------------------------------------------------------
+
+typedef DWORD D3DCOLOR;
+
+#define D3DCOLOR_ARGB( a, r, g, b ) \
+  ( (D3DCOLOR)( ( ( (a) & 0xff ) << 24 ) | ( ( (r) & 0xff ) << 16 ) | ( ( (g) & 0xff ) << 8 ) | ( (b) & 0xff ) ) )
+#define D3DCOLOR_XRGB( r, g, b ) D3DCOLOR_ARGB( 0xff, r, g, b )
+
+#define D3DFVF_XYZRHW         0x004
+#define D3DFVF_DIFFUSE        0x040
+#define D3DFVF_TEX1           0x100
+
+#define D3DLOCK_READONLY      0x10
+
+enum D3DFORMAT { D3DFMT_UNKNOWN = 0, D3DFMT_A8R8G8B8 = 21 };
+
+enum D3DPRIMITIVETYPE
+{
+  D3DPT_LINELIST = 2,
+  D3DPT_LINESTRIP = 3,
+  D3DPT_TRIANGLESTRIP = 5
+};
+
+enum D3DRENDERSTATETYPE
+{
+  D3DRS_ZENABLE = 7,
+  D3DRS_ALPHABLENDENABLE = 27,
+  D3DRS_LIGHTING = 137,
+  D3DRS_SCISSORTESTENABLE = 174
+};
+
+enum D3DZBUFFERTYPE { D3DZB_FALSE = 0, D3DZB_TRUE = 1 };
+
+enum D3DSAMPLERSTATETYPE
+{
+  D3DSAMP_ADDRESSU = 1,
+  D3DSAMP_ADDRESSV = 2,
+  D3DSAMP_MAGFILTER = 5,
+  D3DSAMP_MINFILTER = 6
+};
+
+enum D3DTEXTUREADDRESS { D3DTADDRESS_MIRROR = 2, D3DTADDRESS_CLAMP = 3 };
+
+enum D3DTEXTUREFILTERTYPE { D3DTEXF_POINT = 1, D3DTEXF_LINEAR = 2 };
+
+enum D3DSTATEBLOCKTYPE { D3DSBT_ALL = 1 };
+
+struct D3DSURFACE_DESC
+{
+  D3DFORMAT Format;
+  UINT Width;
+  UINT Height;
+};
+
+struct D3DLOCKED_RECT
+{
+  int Pitch;
+  void * pBits;
+};
+
+struct D3DXIMAGE_INFO
+{
+  UINT Width;
+  UINT Height;
+};
+
+//------ Interfaces ----------------------------------------------------------------------------------
+
+/*! \brief Reference counted base of null interfaces, object deletes itself when the last reference
+    is released (as COM objects do). */
+struct IUnknown
+{
+  IUnknown() = default;
+  IUnknown( const IUnknown & ) = delete;
+  IUnknown & operator=( const IUnknown & ) = delete;
+  virtual ~IUnknown() = default;
+
+  ULONG AddRef() { return ++mRefCount; }
+  ULONG Release();
+
+private:
+
+  ULONG mRefCount = 1;
+  //!< Number of references held, object is created with one
+};
+
+struct IDirect3DBaseTexture9: public IUnknown {};
+
+/*! \brief Texture keeps pixels of loaded image in A8R8G8B8 format. Only level 0 exists. */
+struct IDirect3DTexture9: public IDirect3DBaseTexture9
+{
+  IDirect3DTexture9( UINT width, UINT height ):
+    mWidth( width ), mHeight( height ), mPixels( (size_t)width * height, 0u ) {}
+
+  HRESULT GetLevelDesc( UINT level, D3DSURFACE_DESC * desc );
+  HRESULT LockRect( UINT level, D3DLOCKED_RECT * lockedRect, const RECT * rect, DWORD flags );
+  HRESULT UnlockRect( UINT level );
+
+  UINT mWidth;
+  //!< Width of the texture in pixels
+
+  UINT mHeight;
+  //!< Height of the texture in pixels
+
+  std::vector<D3DCOLOR> mPixels;
+  //!< Pixels row by row, rows are not padded
+};
+
+struct IDirect3DVertexShader9: public IUnknown {};
+struct IDirect3DPixelShader9: public IUnknown {};
+struct IDirect3DVertexBuffer9: public IUnknown {};
+struct IDirect3D9: public IUnknown {};
+
+struct IDirect3DStateBlock9: public IUnknown
+{
+  HRESULT Capture() { return S_OK; }
+  HRESULT Apply() { return S_OK; }
+};
+
+/*! \brief Device draws nothing. Render states, FVF and scissor rectangle are remembered, so that
+    code saving and restoring them behaves as with real device. */
+struct IDirect3DDevice9: public IUnknown
+{
+  HRESULT SetTexture( DWORD, IDirect3DBaseTexture9 * ) { return S_OK; }
+  HRESULT SetSamplerState( DWORD, D3DSAMPLERSTATETYPE, DWORD ) { return S_OK; }
+  HRESULT DrawPrimitiveUP( D3DPRIMITIVETYPE, UINT, const void *, UINT ) { return S_OK; }
+
+  HRESULT GetVertexShader( IDirect3DVertexShader9 ** shader ) { *shader = nullptr; return S_OK; }
+  HRESULT SetVertexShader( IDirect3DVertexShader9 * ) { return S_OK; }
+  HRESULT GetPixelShader( IDirect3DPixelShader9 ** shader ) { *shader = nullptr; return S_OK; }
+  HRESULT SetPixelShader( IDirect3DPixelShader9 * ) { return S_OK; }
+
+  HRESULT GetFVF( DWORD * fvf ) { *fvf = mFVF; return S_OK; }
+  HRESULT SetFVF( DWORD fvf ) { mFVF = fvf; return S_OK; }
+
+  HRESULT GetRenderState( D3DRENDERSTATETYPE state, DWORD * value );
+  HRESULT SetRenderState( D3DRENDERSTATETYPE state, DWORD value );
+
+  HRESULT GetScissorRect( RECT * rect ) { *rect = mScissorRect; return S_OK; }
+  HRESULT SetScissorRect( const RECT * rect ) { mScissorRect = *rect; return S_OK; }
+
+  HRESULT CreateStateBlock( D3DSTATEBLOCKTYPE, IDirect3DStateBlock9 ** stateBlock );
+
+  DWORD mFVF = 0;
+  //!< Actual flexible vertex format
+
+  std::array<DWORD, 256> mRenderStates{};
+  //!< Actual render states, indexed by D3DRENDERSTATETYPE
+
+  RECT mScissorRect{ 0, 0, 0, 0 };
+  //!< Actual scissor rectangle
+};
+
+typedef IDirect3D9 * LPDIRECT3D9;
+typedef IDirect3DDevice9 * LPDIRECT3DDEVICE9;
+typedef IDirect3DVertexBuffer9 * LPDIRECT3DVERTEXBUFFER9;
+typedef IDirect3DTexture9 * LPDIRECT3DTEXTURE9;
+
+//------ D3DX functions ------------------------------------------------------------------------------
+
+HRESULT D3DXGetImageInfoFromFile( const wchar_t * srcFile, D3DXIMAGE_INFO * srcInfo );
+/*!< \brief Reads dimensions of PNG or JPEG image from its header. */
+
+HRESULT D3DXCreateTextureFromFile( LPDIRECT3DDEVICE9 device, const wchar_t * srcFile, LPDIRECT3DTEXTURE9 * texture );
+/*!< \brief Creates texture from image file. PNG images are decoded (their alpha channel is needed
+     for collision masks), texture of other images has correct size, but is transparent black. */
+
+#endif